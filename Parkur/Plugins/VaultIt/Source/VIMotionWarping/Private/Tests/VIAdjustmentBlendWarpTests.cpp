@@ -0,0 +1,495 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Math/RandomStream.h"
+#include "VIBenchmarkReport.h"
+#include "VIRootMotionModifier_AdjustmentBlendWarp.h"
+#include "VIWarpMath.h"
+
+#if WITH_EDITOR
+#include "Animation/AnimMontage.h"
+#include "Animation/Skeleton.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Engine/SkeletalMesh.h"
+#include "Serialization/ObjectReader.h"
+#include "Serialization/ObjectWriter.h"
+#include "UObject/ObjectSaveContext.h"
+#include "VIAnimNotifyState_MotionWarping.h"
+#endif
+
+namespace VIAdjustmentBlendWarpTests
+{
+	/** Largest difference between two motion delta track containers, channels are translation in cm and rotation in degrees */
+	static void MeasureError(const FVIMotionDeltaTrackContainer& A, const FVIMotionDeltaTrackContainer& B, float& OutMaxTranslationError, float& OutMaxRotationError)
+	{
+		OutMaxTranslationError = 0.f;
+		OutMaxRotationError = 0.f;
+		for (int32 BoneIdx = 0; BoneIdx < A.NumBones; BoneIdx++)
+		{
+			for (int32 Channel = 0; Channel < FVIMotionDeltaTrackContainer::NumChannels; Channel++)
+			{
+				float& MaxError = Channel < 3 ? OutMaxTranslationError : OutMaxRotationError;
+				for (int32 FrameIdx = 0; FrameIdx < A.NumFrames; FrameIdx++)
+				{
+					MaxError = FMath::Max(MaxError, FMath::Abs(A.GetBase(BoneIdx, Channel)[FrameIdx] - B.GetBase(BoneIdx, Channel)[FrameIdx]));
+					MaxError = FMath::Max(MaxError, FMath::Abs(A.GetWeights(BoneIdx, Channel)[FrameIdx] - B.GetWeights(BoneIdx, Channel)[FrameIdx]));
+				}
+			}
+		}
+	}
+}
+
+// Warped track compression
+///////////////////////////////////////////////////////////////
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVIWarpedTrackCompressionTest, "VIMotionWarping.AdjustmentBlendWarp.WarpedTrackCompression", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/** Compresses synthetic warped tracks and checks the decoded keys stay within the error bounds of the uncompressed tracks */
+bool FVIWarpedTrackCompressionTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumTracks = 8;
+	constexpr float TranslationTolerance = 0.02f;
+	constexpr float RotationTolerance = 0.02f;
+
+	for (const int32 NumFrames : { 1, 2, 60, 240 })
+	{
+		// Vault-like arcs of a few metres with rotations sweeping through every axis
+		FRandomStream Random(NumFrames);
+		FAnimSequenceTrackContainer RawTracks;
+		RawTracks.Initialize(NumTracks);
+		for (int32 TrackIndex = 0; TrackIndex < NumTracks; TrackIndex++)
+		{
+			FRawAnimSequenceTrack& Track = RawTracks.AnimationTracks[TrackIndex];
+			const FVector3f Start = FVector3f(Random.GetUnitVector() * 50.f);
+			const FVector3f Travel = FVector3f(Random.FRandRange(100.f, 400.f), Random.FRandRange(-50.f, 50.f), 0.f);
+			const float Height = Random.FRandRange(50.f, 200.f);
+			const FQuat4f StartRotation = FQuat4f(FQuat(Random.GetUnitVector(), Random.FRandRange(-PI, PI)));
+			const FQuat4f EndRotation = FQuat4f(FQuat(Random.GetUnitVector(), Random.FRandRange(-PI, PI)));
+
+			for (int32 Frame = 0; Frame < NumFrames; Frame++)
+			{
+				const float Alpha = NumFrames > 1 ? Frame / (float)(NumFrames - 1) : 0.f;
+				Track.PosKeys.Add(Start + Travel * Alpha + FVector3f(0.f, 0.f, FMath::Sin(Alpha * PI) * Height));
+				Track.RotKeys.Add(FQuat4f::Slerp(StartRotation, EndRotation, Alpha));
+
+				// Odd tracks scale so both the constant and animated scale paths are covered
+				Track.ScaleKeys.Add(TrackIndex % 2 ? FVector3f(1.f + Alpha) : FVector3f(1.f));
+			}
+			RawTracks.TrackNames[TrackIndex] = *FString::Printf(TEXT("Bone%d"), TrackIndex);
+		}
+
+		FVICompressedWarpedTrackContainer CompressedTracks;
+		CompressedTracks.Compress(RawTracks);
+
+		float MaxTranslationError = 0.f;
+		float MaxRotationError = 0.f;
+		CompressedTracks.MeasureError(RawTracks, MaxTranslationError, MaxRotationError);
+
+		const int32 RawSize = (int32)FVICompressedWarpedTrackContainer::GetAllocatedSize(RawTracks);
+		const int32 CompressedSize = (int32)CompressedTracks.GetAllocatedSize();
+		AddInfo(FString::Printf(TEXT("%d tracks %d frames. Max error: %fcm %fdeg. Size: %d -> %d bytes"), NumTracks, NumFrames, MaxTranslationError, MaxRotationError, RawSize, CompressedSize));
+
+		TestTrue(FString::Printf(TEXT("%d frames translation error %fcm"), NumFrames, MaxTranslationError), MaxTranslationError <= TranslationTolerance);
+		TestTrue(FString::Printf(TEXT("%d frames rotation error %fdeg"), NumFrames, MaxRotationError), MaxRotationError <= RotationTolerance);
+		if (NumFrames > 1)
+		{
+			TestTrue(FString::Printf(TEXT("%d frames compressed smaller"), NumFrames), CompressedSize < RawSize);
+		}
+
+		// Decompressing has to give back the keys MeasureError compared against, with constant scale collapsed to one key
+		FAnimSequenceTrackContainer DecompressedTracks;
+		CompressedTracks.Decompress(DecompressedTracks);
+		if (!TestEqual(FString::Printf(TEXT("%d frames decompressed tracks"), NumFrames), DecompressedTracks.AnimationTracks.Num(), NumTracks))
+		{
+			continue;
+		}
+
+		TestTrue(FString::Printf(TEXT("%d frames track names"), NumFrames), DecompressedTracks.TrackNames == RawTracks.TrackNames);
+		for (int32 TrackIndex = 0; TrackIndex < NumTracks; TrackIndex++)
+		{
+			const FRawAnimSequenceTrack& Raw = RawTracks.AnimationTracks[TrackIndex];
+			const FRawAnimSequenceTrack& Decompressed = DecompressedTracks.AnimationTracks[TrackIndex];
+			TestEqual(FString::Printf(TEXT("%d frames track %d keys"), NumFrames, TrackIndex), Decompressed.PosKeys.Num(), NumFrames);
+			TestEqual(FString::Printf(TEXT("%d frames track %d scale keys"), NumFrames, TrackIndex), Decompressed.ScaleKeys.Num(), TrackIndex % 2 && NumFrames > 1 ? NumFrames : 1);
+			for (int32 Frame = 0; Frame < Decompressed.PosKeys.Num() && Frame < NumFrames; Frame++)
+			{
+				const float TranslationError = FVector3f::Dist(Decompressed.PosKeys[Frame], Raw.PosKeys[Frame]);
+				const float RotationError = (float)FMath::RadiansToDegrees(FQuat(Decompressed.RotKeys[Frame]).AngularDistance(FQuat(Raw.RotKeys[Frame]).GetNormalized()));
+				if (TranslationError > TranslationTolerance || RotationError > RotationTolerance)
+				{
+					AddError(FString::Printf(TEXT("%d frames track %d frame %d decompressed error %fcm %fdeg"), NumFrames, TrackIndex, Frame, TranslationError, RotationError));
+					break;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+// Adjustment blend kernel
+///////////////////////////////////////////////////////////////
+
+namespace VIAdjustmentBlendWarpTests
+{
+	/** Array-of-structures motion delta track the adjustment blend warp used before the structure-of-arrays container */
+	struct FAoSMotionDeltaTrack
+	{
+		TArray<FTransform> BoneTransformTrack;
+		TArray<FVector> DeltaTranslationTrack;
+		TArray<FRotator> DeltaRotationTrack;
+		FVector TotalTranslation = FVector::ZeroVector;
+		FRotator TotalRotation = FRotator::ZeroRotator;
+	};
+
+	static FVector CalculateAdditive(const FVector& Total, const FVector& Delta, const FVector& Additive, const FVector& PreviousAdditive, float Alpha)
+	{
+		FVector CurrentAdditive = FVector::ZeroVector;
+		for (int32 Idx = 0; Idx < 3; Idx++)
+		{
+			if (!FMath::IsNearlyZero(Total[Idx], (FVector::FReal)1.f))
+			{
+				const FVector::FReal Percent = Delta[Idx] / Total[Idx];
+				const FVector::FReal AdditiveDelta = FMath::Abs(Additive[Idx]) * Percent;
+				CurrentAdditive[Idx] = (Additive[Idx] > 0.f) ? PreviousAdditive[Idx] + AdditiveDelta : PreviousAdditive[Idx] - AdditiveDelta;
+			}
+			else
+			{
+				CurrentAdditive[Idx] = Additive[Idx] * Alpha;
+			}
+		}
+		return CurrentAdditive;
+	}
+
+	/** Warped channels of one bone through the array-of-structures path, Out is [Channel][Frame] like the structure-of-arrays path */
+	static void ApplyAdditiveAoS(const FAoSMotionDeltaTrack& Track, const FVector& TotalAdditiveTranslation, const FVector& TotalAdditiveRotation, float* Out)
+	{
+		const int32 TotalFrames = Track.BoneTransformTrack.Num();
+
+		FVector PrevAdditiveTranslation = FVector::ZeroVector;
+		FVector PrevAdditiveRotation = FVector::ZeroVector;
+		for (int32 FrameIdx = 0; FrameIdx < TotalFrames; FrameIdx++)
+		{
+			const FTransform& BoneTransform = Track.BoneTransformTrack[FrameIdx];
+			const FVector Translation = BoneTransform.GetTranslation();
+			const FVector Rotation = BoneTransform.GetRotation().Rotator().Euler();
+
+			FVector CurrentAdditiveTranslation = FVector::ZeroVector;
+			FVector CurrentAdditiveRotation = FVector::ZeroVector;
+			if (FrameIdx > 0)
+			{
+				const float Alpha = (FrameIdx / (float)(TotalFrames - 1));
+				CurrentAdditiveTranslation = CalculateAdditive(Track.TotalTranslation, Track.DeltaTranslationTrack[FrameIdx], TotalAdditiveTranslation, PrevAdditiveTranslation, Alpha);
+				CurrentAdditiveRotation = CalculateAdditive(Track.TotalRotation.Euler(), Track.DeltaRotationTrack[FrameIdx].Euler(), TotalAdditiveRotation, PrevAdditiveRotation, Alpha);
+				PrevAdditiveTranslation = CurrentAdditiveTranslation;
+				PrevAdditiveRotation = CurrentAdditiveRotation;
+			}
+
+			for (int32 Channel = 0; Channel < 3; Channel++)
+			{
+				Out[Channel * TotalFrames + FrameIdx] = (float)(Translation[Channel] + CurrentAdditiveTranslation[Channel]);
+				Out[(Channel + 3) * TotalFrames + FrameIdx] = (float)(Rotation[Channel] + CurrentAdditiveRotation[Channel]);
+			}
+		}
+	}
+
+	/** Warped channels of one bone through the structure-of-arrays path, as AdjustmentBlendWarp() does */
+	static void ApplyAdditiveSoA(const FVIMotionDeltaTrackContainer& Tracks, int32 BoneIdx, const FVector& TotalAdditiveTranslation, const FVector& TotalAdditiveRotation, float* Out)
+	{
+		const int32 TotalFrames = Tracks.NumFrames;
+		for (int32 Channel = 0; Channel < 3; Channel++)
+		{
+			FVIMotionDeltaTrackContainer::ApplyAdditive(Tracks.GetBase(BoneIdx, Channel), Tracks.GetWeights(BoneIdx, Channel), TotalAdditiveTranslation[Channel], Out + Channel * TotalFrames, TotalFrames);
+			FVIMotionDeltaTrackContainer::ApplyAdditive(Tracks.GetBase(BoneIdx, Channel + 3), Tracks.GetWeights(BoneIdx, Channel + 3), TotalAdditiveRotation[Channel], Out + (Channel + 3) * TotalFrames, TotalFrames);
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVIAdjustmentBlendKernelTest, "VIMotionWarping.AdjustmentBlendWarp.Kernel", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+/**
+ * Times the structure-of-arrays adjustment blend against the array-of-structures path it replaced on the same synthetic bone motion,
+ * and checks both produce the same warped channels
+ */
+bool FVIAdjustmentBlendKernelTest::RunTest(const FString& Parameters)
+{
+	using namespace VIAdjustmentBlendWarpTests;
+
+	static constexpr int32 NumBones = 8;
+	static constexpr int32 NumIterations = 2000;
+	constexpr float TranslationTolerance = 0.01f;
+	constexpr float RotationTolerance = 0.01f;
+
+	FVIBenchmarkReport Report(*this, TEXT("VIMotionWarping_AdjustmentBlendKernel.csv"), TEXT("Bones,Frames,Iterations,AoSMs,SoAMs,Speedup"));
+
+	// Odd frame counts exercise the scalar tail of the vectorized kernel
+	for (const int32 NumFrames : { 7, 30, 60, 121 })
+	{
+		FRandomStream Random(NumFrames);
+
+		// The same motion in both layouts, rotations kept clear of gimbal lock so the euler round trip of the old path is exact enough to compare
+		FVIMotionDeltaTrackContainer Tracks;
+		Tracks.Init(NumBones, NumFrames);
+		TArray<FAoSMotionDeltaTrack> AoSTracks;
+		AoSTracks.SetNum(NumBones);
+		TArray<FVector> TotalAdditiveTranslations;
+		TArray<FVector> TotalAdditiveRotations;
+		for (int32 BoneIdx = 0; BoneIdx < NumBones; BoneIdx++)
+		{
+			FAoSMotionDeltaTrack& AoSTrack = AoSTracks[BoneIdx];
+			FVector Translation = Random.GetUnitVector() * 50.f;
+			FRotator Rotation(Random.FRandRange(-30.f, 30.f), Random.FRandRange(-90.f, 90.f), Random.FRandRange(-90.f, 90.f));
+			for (int32 FrameIdx = 0; FrameIdx < NumFrames; FrameIdx++)
+			{
+				if (FrameIdx > 0)
+				{
+					// Every other bone holds still on an axis so the linear fallback is covered too
+					Translation += FVector(Random.FRandRange(-5.f, 5.f), BoneIdx % 2 ? 0.f : Random.FRandRange(-5.f, 5.f), Random.FRandRange(-5.f, 5.f));
+					Rotation += FRotator(Random.FRandRange(-0.5f, 0.5f), BoneIdx % 2 ? 0.f : Random.FRandRange(-2.f, 2.f), Random.FRandRange(-2.f, 2.f));
+				}
+
+				const FTransform BoneTransform(Rotation, Translation);
+				const FVector RoundTripRotation = BoneTransform.GetRotation().Rotator().Euler();
+				for (int32 Channel = 0; Channel < 3; Channel++)
+				{
+					Tracks.GetBase(BoneIdx, Channel)[FrameIdx] = (float)Translation[Channel];
+					Tracks.GetBase(BoneIdx, Channel + 3)[FrameIdx] = (float)RoundTripRotation[Channel];
+				}
+
+				if (FrameIdx == 0)
+				{
+					AoSTrack.DeltaTranslationTrack.Add(FVector::ZeroVector);
+					AoSTrack.DeltaRotationTrack.Add(FRotator::ZeroRotator);
+				}
+				else
+				{
+					const FTransform& LastBoneTransform = AoSTrack.BoneTransformTrack.Last();
+					const FVector LastTranslation = LastBoneTransform.GetTranslation();
+					const FVector DeltaTranslation(FMath::Abs(Translation.X - LastTranslation.X), FMath::Abs(Translation.Y - LastTranslation.Y), FMath::Abs(Translation.Z - LastTranslation.Z));
+					AoSTrack.DeltaTranslationTrack.Add(DeltaTranslation);
+					AoSTrack.TotalTranslation += DeltaTranslation;
+
+					const FRotator CurrentRotation = BoneTransform.GetRotation().Rotator();
+					const FRotator LastRotation = LastBoneTransform.GetRotation().Rotator();
+					const FRotator DeltaRotation(FMath::Abs(CurrentRotation.Pitch - LastRotation.Pitch), FMath::Abs(CurrentRotation.Yaw - LastRotation.Yaw), FMath::Abs(CurrentRotation.Roll - LastRotation.Roll));
+					AoSTrack.DeltaRotationTrack.Add(DeltaRotation);
+					AoSTrack.TotalRotation += DeltaRotation;
+				}
+				AoSTrack.BoneTransformTrack.Add(BoneTransform);
+			}
+
+			for (int32 Channel = 0; Channel < FVIMotionDeltaTrackContainer::NumChannels; Channel++)
+			{
+				FVIWarpMath::ComputeAdjustmentBlendWeights(Tracks.GetBase(BoneIdx, Channel), Tracks.GetWeights(BoneIdx, Channel), NumFrames);
+			}
+
+			TotalAdditiveTranslations.Add(FVector(Random.FRandRange(-50.f, 50.f), Random.FRandRange(-50.f, 50.f), Random.FRandRange(-50.f, 50.f)));
+			TotalAdditiveRotations.Add(FVector(Random.FRandRange(-10.f, 10.f), Random.FRandRange(-10.f, 10.f), Random.FRandRange(-10.f, 10.f)));
+		}
+
+		TArray<float> AoSOut;
+		TArray<float> SoAOut;
+		AoSOut.SetNumZeroed(FVIMotionDeltaTrackContainer::NumChannels * NumFrames);
+		SoAOut.SetNumZeroed(FVIMotionDeltaTrackContainer::NumChannels * NumFrames);
+
+		float MaxTranslationError = 0.f;
+		float MaxRotationError = 0.f;
+		for (int32 BoneIdx = 0; BoneIdx < NumBones; BoneIdx++)
+		{
+			ApplyAdditiveAoS(AoSTracks[BoneIdx], TotalAdditiveTranslations[BoneIdx], TotalAdditiveRotations[BoneIdx], AoSOut.GetData());
+			ApplyAdditiveSoA(Tracks, BoneIdx, TotalAdditiveTranslations[BoneIdx], TotalAdditiveRotations[BoneIdx], SoAOut.GetData());
+			for (int32 Idx = 0; Idx < AoSOut.Num(); Idx++)
+			{
+				float& MaxError = Idx < 3 * NumFrames ? MaxTranslationError : MaxRotationError;
+				MaxError = FMath::Max(MaxError, FMath::Abs(AoSOut[Idx] - SoAOut[Idx]));
+			}
+		}
+
+		TestTrue(FString::Printf(TEXT("%d frames translation matches the AoS path, error %fcm"), NumFrames, MaxTranslationError), MaxTranslationError <= TranslationTolerance);
+		TestTrue(FString::Printf(TEXT("%d frames rotation matches the AoS path, error %fdeg"), NumFrames, MaxRotationError), MaxRotationError <= RotationTolerance);
+
+		auto Run = [](auto Warp)
+		{
+			return FVIBenchmarkReport::Time(NumIterations, [&Warp](int32 Iteration)
+			{
+				for (int32 BoneIdx = 0; BoneIdx < NumBones; BoneIdx++)
+				{
+					Warp(BoneIdx);
+				}
+			});
+		};
+
+		const double AoSTime = Run([&](int32 BoneIdx) { ApplyAdditiveAoS(AoSTracks[BoneIdx], TotalAdditiveTranslations[BoneIdx], TotalAdditiveRotations[BoneIdx], AoSOut.GetData()); });
+		const double SoATime = Run([&](int32 BoneIdx) { ApplyAdditiveSoA(Tracks, BoneIdx, TotalAdditiveTranslations[BoneIdx], TotalAdditiveRotations[BoneIdx], SoAOut.GetData()); });
+		const double Speedup = SoATime > 0.0 ? AoSTime / SoATime : 0.0;
+
+		Report.Add(FString::Printf(TEXT("%d bones %d frames %d iterations. AoS: %.3fms SoA: %.3fms (%.2fx)"), NumBones, NumFrames, NumIterations, AoSTime * 1000.0, SoATime * 1000.0, Speedup),
+			FString::Printf(TEXT("%d,%d,%d,%.3f,%.3f,%.2f"), NumBones, NumFrames, NumIterations, AoSTime * 1000.0, SoATime * 1000.0, Speedup));
+	}
+
+	Report.Save();
+
+	return true;
+}
+
+#if WITH_EDITOR
+
+// Baked motion delta tracks
+///////////////////////////////////////////////////////////////
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVIBakedMotionDeltaTracksTest, "VIMotionWarping.AdjustmentBlendWarp.BakedMotionDeltaTracks", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+/**
+ * Bakes the motion delta tracks of every warping window in the montages shipped with VaultIt through PreSave(), on a transient copy of each montage
+ * The bake has to survive serialization, be used by the runtime in place of sampling, and be rejected for any other animation or an edited window
+ * Windows using other configs are baked with a transient adjustment blend warp config
+ */
+bool FVIBakedMotionDeltaTracksTest::RunTest(const FString& Parameters)
+{
+	constexpr float Tolerance = 0.1f;
+	static const TArray<FName> IKBones = { TEXT("hand_l"), TEXT("hand_r"), TEXT("foot_l"), TEXT("foot_r") };
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	AssetRegistry.ScanPathsSynchronous({ TEXT("/VaultIt") });
+
+	TArray<FAssetData> Assets;
+	AssetRegistry.GetAssetsByPath(TEXT("/VaultIt"), Assets, true);
+
+	int32 NumWindows = 0;
+	for (const FAssetData& Asset : Assets)
+	{
+		if (!Asset.IsInstanceOf(UAnimMontage::StaticClass()))
+		{
+			continue;
+		}
+
+		const UAnimMontage* ShippedMontage = Cast<UAnimMontage>(Asset.GetAsset());
+		USkeleton* Skeleton = ShippedMontage ? ShippedMontage->GetSkeleton() : nullptr;
+		USkeletalMesh* Mesh = Skeleton ? Skeleton->GetPreviewMesh(true) : nullptr;
+		if (!Mesh)
+		{
+			AddWarning(FString::Printf(TEXT("%s has no skeleton preview mesh to sample with"), *Asset.GetObjectPathString()));
+			continue;
+		}
+
+		// Transient copies so baking never dirties the shipped montage, the second only has to be a different animation
+		UAnimMontage* Montage = DuplicateObject<UAnimMontage>(ShippedMontage, GetTransientPackage());
+		const UAnimMontage* OtherMontage = DuplicateObject<UAnimMontage>(ShippedMontage, GetTransientPackage());
+
+		for (const FAnimNotifyEvent& NotifyEvent : Montage->Notifies)
+		{
+			UVIAnimNotifyState_MotionWarping* Notify = Cast<UVIAnimNotifyState_MotionWarping>(NotifyEvent.NotifyStateClass);
+			if (!Notify)
+			{
+				continue;
+			}
+
+			const FString WindowName = FString::Printf(TEXT("%s [%.3f, %.3f]"), *Asset.GetObjectPathString(), NotifyEvent.GetTriggerTime(), NotifyEvent.GetEndTriggerTime());
+
+			UVIRootMotionModifierConfig_AdjustmentBlendWarp* Config = Cast<UVIRootMotionModifierConfig_AdjustmentBlendWarp>(Notify->VIRootMotionModifierConfig);
+			if (!Config)
+			{
+				Config = NewObject<UVIRootMotionModifierConfig_AdjustmentBlendWarp>(Notify);
+				Config->bWarpIKBones = true;
+				Config->IKBones = IKBones;
+			}
+
+			// Bake the way saving the montage does
+			FObjectSaveContextData SaveContextData;
+			Config->PreSave(FObjectPreSaveContext(SaveContextData));
+
+			const float StartTime = FMath::Clamp(NotifyEvent.GetTriggerTime(), 0.f, Montage->GetPlayLength());
+			const float EndTime = FMath::Clamp(NotifyEvent.GetEndTriggerTime(), 0.f, Montage->GetPlayLength());
+			if (!TestTrue(FString::Printf(TEXT("%s baked for its window"), *WindowName), Config->BakedMotionDeltaTracks.Matches(Montage, StartTime, EndTime)))
+			{
+				continue;
+			}
+
+			NumWindows++;
+
+			// What is loaded has to be what was baked
+			TArray<uint8> Bytes;
+			FObjectWriter Writer(Config, Bytes);
+			UVIRootMotionModifierConfig_AdjustmentBlendWarp* LoadedConfig = NewObject<UVIRootMotionModifierConfig_AdjustmentBlendWarp>(Notify);
+			FObjectReader Reader(LoadedConfig, Bytes);
+
+			const FVIBakedMotionDeltaTracks& Baked = Config->BakedMotionDeltaTracks;
+			const FVIBakedMotionDeltaTracks& Loaded = LoadedConfig->BakedMotionDeltaTracks;
+			TestTrue(FString::Printf(TEXT("%s loaded animation"), *WindowName), Loaded.Animation == Baked.Animation);
+			TestTrue(FString::Printf(TEXT("%s loaded window"), *WindowName), Loaded.StartTime == Baked.StartTime && Loaded.EndTime == Baked.EndTime);
+			TestTrue(FString::Printf(TEXT("%s loaded bones"), *WindowName), Loaded.BoneNames == Baked.BoneNames);
+			TestTrue(FString::Printf(TEXT("%s loaded tracks"), *WindowName), Loaded.Tracks.NumBones == Baked.Tracks.NumBones && Loaded.Tracks.NumFrames == Baked.Tracks.NumFrames
+				&& Loaded.Tracks.Base == Baked.Tracks.Base && Loaded.Tracks.Weights == Baked.Tracks.Weights);
+
+			// Anything else must not use the bake: another animation, or the window edited since the bake
+			const float EditedOffset = FVIRootMotionModifier_AdjustmentBlendWarp::MotionDeltaSampleRate * 2.f;
+			TestFalse(FString::Printf(TEXT("%s rejects another animation"), *WindowName), Loaded.Matches(OtherMontage, StartTime, EndTime));
+			TestFalse(FString::Printf(TEXT("%s rejects an edited start"), *WindowName), Loaded.Matches(Montage, StartTime + EditedOffset, EndTime));
+			TestFalse(FString::Printf(TEXT("%s rejects an edited end"), *WindowName), Loaded.Matches(Montage, StartTime, EndTime - EditedOffset));
+
+			// Same bones from the mesh, in the mesh's order, as the modifier would at runtime
+			const FReferenceSkeleton& RefSkeleton = Mesh->GetRefSkeleton();
+			FVIAdjustmentBlendWarpParams Params;
+			Params.RequiredBoneIndexArray = { 0 };
+			for (const FName& BoneName : Loaded.BoneNames)
+			{
+				const int32 BoneIndex = RefSkeleton.FindBoneIndex(BoneName);
+				if (BoneIndex != INDEX_NONE)
+				{
+					Params.RequiredBoneIndexArray.AddUnique(BoneIndex);
+				}
+			}
+			RefSkeleton.EnsureParentsExistAndSort(Params.RequiredBoneIndexArray);
+
+			Params.Animation = Montage;
+			Params.BoneContainerAsset = Mesh;
+			Params.StartTime = StartTime;
+			Params.EndTime = EndTime;
+
+			const FBoneContainer BoneContainer(Params.RequiredBoneIndexArray, FCurveEvaluationOption(false), *Mesh);
+			FVIMotionDeltaTrackContainer Live;
+			FVIRootMotionModifier_AdjustmentBlendWarp::ExtractMotionDeltaFromRange(BoneContainer, Montage, StartTime, EndTime, FVIRootMotionModifier_AdjustmentBlendWarp::MotionDeltaSampleRate, Live);
+
+			// The runtime uses the loaded bake in place of sampling, and the bake agrees with sampling
+			Params.BakedConfig = LoadedConfig;
+			FVIAdjustmentBlendWarpInput FromBaked;
+			if (!TestTrue(FString::Printf(TEXT("%s gathered from the bake"), *WindowName), FVIRootMotionModifier_AdjustmentBlendWarp::GatherWarpInput(Params, FromBaked)))
+			{
+				continue;
+			}
+
+			FVIMotionDeltaTrackContainer ExpectedFromBaked;
+			TestTrue(FString::Printf(TEXT("%s baked every bone"), *WindowName), Loaded.CopyTo(BoneContainer, ExpectedFromBaked));
+			TestTrue(FString::Printf(TEXT("%s used the bake"), *WindowName), FromBaked.MotionDeltaTracks.Base == ExpectedFromBaked.Base && FromBaked.MotionDeltaTracks.Weights == ExpectedFromBaked.Weights);
+
+			if (TestEqual(FString::Printf(TEXT("%s frames"), *WindowName), FromBaked.MotionDeltaTracks.NumFrames, Live.NumFrames)
+				&& TestEqual(FString::Printf(TEXT("%s bones"), *WindowName), FromBaked.MotionDeltaTracks.NumBones, Live.NumBones))
+			{
+				float MaxTranslationError = 0.f;
+				float MaxRotationError = 0.f;
+				VIAdjustmentBlendWarpTests::MeasureError(FromBaked.MotionDeltaTracks, Live, MaxTranslationError, MaxRotationError);
+				TestTrue(FString::Printf(TEXT("%s translation error %f"), *WindowName, MaxTranslationError), MaxTranslationError <= Tolerance);
+				TestTrue(FString::Printf(TEXT("%s rotation error %f"), *WindowName, MaxRotationError), MaxRotationError <= Tolerance);
+			}
+
+			// A bake missing bones the mesh needs, eg. a skeleton edited since the bake, falls back to sampling
+			LoadedConfig->BakedMotionDeltaTracks.BoneNames.Last() = NAME_None;
+			FVIAdjustmentBlendWarpInput FromStale;
+			if (TestTrue(FString::Printf(TEXT("%s gathered from a stale bake"), *WindowName), FVIRootMotionModifier_AdjustmentBlendWarp::GatherWarpInput(Params, FromStale)))
+			{
+				TestTrue(FString::Printf(TEXT("%s stale bake sampled instead"), *WindowName), FromStale.MotionDeltaTracks.Base == Live.Base && FromStale.MotionDeltaTracks.Weights == Live.Weights);
+			}
+		}
+	}
+
+	AddInfo(FString::Printf(TEXT("Checked %d warping windows"), NumWindows));
+	return TestTrue(TEXT("Found shipped warping windows"), NumWindows > 0);
+}
+
+#endif  // WITH_EDITOR
+
+#endif  // WITH_DEV_AUTOMATION_TESTS
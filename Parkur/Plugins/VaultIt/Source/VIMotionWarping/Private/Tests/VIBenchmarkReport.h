@@ -0,0 +1,59 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+/**
+ * Timings of a benchmark test, reported to the test and written as CSV to the automation directory by Save()
+ * Timings are never asserted as they depend on the machine
+ */
+class FVIBenchmarkReport
+{
+public:
+	FVIBenchmarkReport(FAutomationTestBase& InTest, const TCHAR* InFileName, const TCHAR* InHeader)
+		: Test(InTest)
+		, FileName(InFileName)
+		, Report(FString(InHeader) + LINE_TERMINATOR)
+	{}
+
+	/** @return Seconds taken by calling Function(Iteration) NumIterations times */
+	template<typename FunctionType>
+	static double Time(int32 NumIterations, FunctionType&& Function)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < NumIterations; Iteration++)
+		{
+			Function(Iteration);
+		}
+		return FPlatformTime::Seconds() - StartTime;
+	}
+
+	/** Reports Info to the test and adds Row to the CSV */
+	void Add(const FString& Info, const FString& Row)
+	{
+		Test.AddInfo(Info);
+		Report += Row + LINE_TERMINATOR;
+	}
+
+	void Save() const
+	{
+		const FString ReportPath = FPaths::Combine(FPaths::AutomationDir(), FileName);
+		FFileHelper::SaveStringToFile(Report, *ReportPath);
+		Test.AddInfo(FString::Printf(TEXT("Results written to %s"), *ReportPath));
+	}
+
+private:
+	FAutomationTestBase& Test;
+	FString FileName;
+	FString Report;
+};
+
+#endif // WITH_DEV_AUTOMATION_TESTS
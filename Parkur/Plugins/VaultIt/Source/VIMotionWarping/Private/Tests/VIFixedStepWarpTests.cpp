@@ -0,0 +1,362 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Animation/AnimMontage.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "VIAnimNotifyState_MotionWarping.h"
+#include "VIMotionWarpingAnimCache.h"
+#include "VIMotionWarpingComponent.h"
+#include "VIRootMotionModifier.h"
+#include "VIRootMotionModifier_SkewWarp.h"
+#include "VIWarpMath.h"
+
+namespace VIFixedStepWarpTests
+{
+	static const TCHAR* MontagePath = TEXT("/VaultIt/Anims/AnimsVaultTP/VaultIt_Height_100_Montage.VaultIt_Height_100_Montage");
+
+	static constexpr float StepRate = 60.f;
+
+	/** Sets a.VIMotionWarping.FixedStepRate for the scope */
+	struct FScopedFixedStepRate
+	{
+		IConsoleVariable* CVar;
+		float PreviousValue;
+
+		explicit FScopedFixedStepRate(float Rate)
+			: CVar(IConsoleManager::Get().FindConsoleVariable(TEXT("a.VIMotionWarping.FixedStepRate")))
+			, PreviousValue(CVar ? CVar->GetFloat() : 0.f)
+		{
+			if (CVar)
+			{
+				CVar->Set(Rate, ECVF_SetByCode);
+			}
+		}
+
+		~FScopedFixedStepRate()
+		{
+			if (CVar)
+			{
+				CVar->Set(PreviousValue, ECVF_SetByCode);
+			}
+		}
+	};
+
+	/** Character the window is replayed on, mesh offsets like the VaultIt characters */
+	struct FTestCharacter
+	{
+		UWorld* World = nullptr;
+		ACharacter* Character = nullptr;
+		UVIMotionWarpingComponent* VIMotionWarpingComp = nullptr;
+
+		FTestCharacter()
+		{
+			World = UWorld::CreateWorld(EWorldType::Game, false);
+			Character = World->SpawnActor<ACharacter>();
+			Character->GetMesh()->SetRelativeLocationAndRotation(FVector(0.f, 0.f, -90.f), FRotator(0.f, -90.f, 0.f));
+			Character->CacheInitialMeshOffset(Character->GetMesh()->GetRelativeLocation(), Character->GetMesh()->GetRelativeRotation());
+
+			VIMotionWarpingComp = NewObject<UVIMotionWarpingComponent>(Character);
+			VIMotionWarpingComp->RegisterComponent();
+			if (!VIMotionWarpingComp->HasBeenInitialized())
+			{
+				VIMotionWarpingComp->InitializeComponent();
+			}
+		}
+
+		~FTestCharacter()
+		{
+			World->DestroyWorld(false);
+		}
+	};
+
+	/** How a window is warped, the modifier is made fresh for every replay */
+	struct FTestWindow
+	{
+		const UAnimSequenceBase* Animation = nullptr;
+		float StartTime = 0.f;
+		float EndTime = 0.f;
+		FTransform StartTransform;
+		FVIMotionWarpingSyncPoint SyncPoint;
+	};
+
+	/** Vault warping window of a shipped montage, with the sync point pushed further, higher and to the side of where the unwarped window ends */
+	static bool MakeVaultWindow(FAutomationTestBase& Test, FTestCharacter& TestCharacter, FTestWindow& OutWindow)
+	{
+		const UAnimMontage* Montage = LoadObject<UAnimMontage>(nullptr, MontagePath);
+		if (!Test.TestNotNull(TEXT("Vault montage"), Montage))
+		{
+			return false;
+		}
+
+		const FAnimNotifyEvent* NotifyEvent = Montage->Notifies.FindByPredicate([](const FAnimNotifyEvent& Event) { return Cast<UVIAnimNotifyState_MotionWarping>(Event.NotifyStateClass) != nullptr; });
+		if (!Test.TestNotNull(TEXT("Vault montage warping window"), NotifyEvent))
+		{
+			return false;
+		}
+
+		OutWindow.Animation = Montage;
+		OutWindow.StartTime = FMath::Clamp(NotifyEvent->GetTriggerTime(), 0.f, Montage->GetPlayLength());
+		OutWindow.EndTime = FMath::Clamp(NotifyEvent->GetEndTriggerTime(), 0.f, Montage->GetPlayLength());
+		OutWindow.StartTransform = FTransform(FRotator(0.f, 30.f, 0.f), FVector(0.f, 0.f, 90.f));
+
+		TestCharacter.Character->SetActorTransform(OutWindow.StartTransform);
+		const FVIWarpCharacterState StartState(*TestCharacter.Character);
+
+		const FTransform VIRootMotionTotal = FVIMotionWarpingAnimCache::Get().ExtractRootMotion(Montage, OutWindow.StartTime, OutWindow.EndTime);
+		const FTransform WorldVIRootMotionTotal = FVIWarpMath::ConvertLocalRootMotionToWorld(VIRootMotionTotal, StartState.ActorTransform, StartState.MeshRelativeTransform);
+		const FVector EndLocation = StartState.ActorTransform.GetLocation() + WorldVIRootMotionTotal.GetTranslation() - FVector::UpVector * StartState.CapsuleHalfHeight;
+		const FQuat EndRotation = WorldVIRootMotionTotal.GetRotation() * StartState.ActorTransform.GetRotation();
+		OutWindow.SyncPoint = FVIMotionWarpingSyncPoint(EndLocation + EndRotation.RotateVector(FVector(60.f, 20.f, 30.f)), FQuat(FVector::UpVector, FMath::DegreesToRadians(20.f)) * EndRotation);
+
+		return true;
+	}
+
+	/** Frame times of a replay, constant or jittering around the frame rate */
+	static TArray<float> MakeFrameTimes(const FTestWindow& Window, float FrameRate, bool bJitter)
+	{
+		FRandomStream Random(FMath::RoundToInt(FrameRate));
+
+		TArray<float> FrameTimes;
+		for (float Position = Window.StartTime; Position < Window.EndTime;)
+		{
+			const float DeltaSeconds = bJitter ? Random.FRandRange(0.5f, 1.5f) / FrameRate : 1.f / FrameRate;
+			FrameTimes.Add(DeltaSeconds);
+			Position += DeltaSeconds;
+		}
+
+		return FrameTimes;
+	}
+
+	/**
+	 * Plays the window through ProcessVIRootMotion with the given frame times, moving the character like character movement applies root motion
+	 * @param CorrectionFrame	Frame after which the character is moved by Correction, like a server correction or a blocked move would. INDEX_NONE for none
+	 * @return Actor transform at the end of the window
+	 */
+	template<typename ModifierType>
+	static FTransform ReplayWindow(FTestCharacter& TestCharacter, const FTestWindow& Window, bool bInLocalSpace, const TArray<float>& FrameTimes,
+		int32 CorrectionFrame = INDEX_NONE, const FVector& Correction = FVector::ZeroVector)
+	{
+		ACharacter* Character = TestCharacter.Character;
+		Character->SetActorTransform(Window.StartTransform);
+
+		ModifierType Modifier;
+		Modifier.Animation = Window.Animation;
+		Modifier.StartTime = Window.StartTime;
+		Modifier.EndTime = Window.EndTime;
+		Modifier.bInLocalSpace = bInLocalSpace;
+		Modifier.bIgnoreZAxis = false;
+		Modifier.CachedSyncPoint = Window.SyncPoint;
+		Modifier.State = EVIRootMotionModifierState::Active;
+
+		float Position = Window.StartTime;
+		for (int32 Frame = 0; Frame < FrameTimes.Num(); Frame++)
+		{
+			const float DeltaSeconds = FrameTimes[Frame];
+
+			Modifier.PreviousPosition = Position;
+			Modifier.CurrentPosition = Position + DeltaSeconds;
+
+			const FVIWarpCharacterState State(*Character);
+			const FTransform LocalVIRootMotion = FVIMotionWarpingAnimCache::Get().ExtractRootMotion(Window.Animation, Position, FMath::Min(Modifier.CurrentPosition, Window.EndTime));
+			const FTransform InVIRootMotion = bInLocalSpace ? LocalVIRootMotion : FVIWarpMath::ConvertLocalRootMotionToWorld(LocalVIRootMotion, State.ActorTransform, State.MeshRelativeTransform);
+
+			const FTransform WarpedVIRootMotion = Modifier.ProcessVIRootMotion(*TestCharacter.VIMotionWarpingComp, InVIRootMotion, DeltaSeconds);
+			const FTransform WorldVIRootMotion = bInLocalSpace ? FVIWarpMath::ConvertLocalRootMotionToWorld(WarpedVIRootMotion, State.ActorTransform, State.MeshRelativeTransform) : WarpedVIRootMotion;
+
+			Character->SetActorLocationAndRotation(State.ActorTransform.GetLocation() + WorldVIRootMotion.GetTranslation(), (WorldVIRootMotion.GetRotation() * State.ActorTransform.GetRotation()).GetNormalized());
+			if (Frame == CorrectionFrame)
+			{
+				Character->AddActorWorldOffset(Correction);
+			}
+
+			Position = Modifier.CurrentPosition;
+		}
+
+		return Character->GetActorTransform();
+	}
+
+	static void MeasureDifference(const FTransform& A, const FTransform& B, float& OutLocationDifference, float& OutRotationDifference)
+	{
+		OutLocationDifference = FMath::Max(OutLocationDifference, (float)FVector::Dist(A.GetLocation(), B.GetLocation()));
+		OutRotationDifference = FMath::Max(OutRotationDifference, (float)FMath::RadiansToDegrees(A.GetRotation().AngularDistance(B.GetRotation())));
+	}
+}
+
+// Fixed step warp
+///////////////////////////////////////////////////////////////
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVIFixedStepWarpTest, "VIMotionWarping.Warp.FixedStep", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+ * Replays the vault warping window of a shipped montage through ProcessVIRootMotion at constant and jittering frame rates,
+ * with the window warped every frame and on a fixed step
+ * Fixed step has to end the window in the same place whatever the frame times, and where warping every frame at the step rate does
+ */
+bool FVIFixedStepWarpTest::RunTest(const FString& Parameters)
+{
+	using namespace VIFixedStepWarpTests;
+
+	constexpr float SpreadTolerance = 0.01f;
+	constexpr float MatchTolerance = 0.1f;
+
+	FTestCharacter TestCharacter;
+
+	FTestWindow Window;
+	if (!MakeVaultWindow(*this, TestCharacter, Window))
+	{
+		return false;
+	}
+
+	// Constant and jittering frame times, the first at the step rate
+	TArray<TArray<float>> Replays;
+	for (const float FrameRate : { StepRate, 24.f, 30.f, 45.f, 90.f, 144.f, 240.f })
+	{
+		Replays.Add(MakeFrameTimes(Window, FrameRate, false));
+	}
+	for (const float FrameRate : { 30.f, 60.f, 120.f })
+	{
+		Replays.Add(MakeFrameTimes(Window, FrameRate, true));
+	}
+
+	auto TestModifier = [&](const TCHAR* Name, auto&& Replay)
+	{
+		TArray<FTransform> FixedStepEnds;
+		TArray<FTransform> PerFrameEnds;
+		{
+			FScopedFixedStepRate ScopedFixedStepRate(StepRate);
+			for (const TArray<float>& FrameTimes : Replays)
+			{
+				FixedStepEnds.Add(Replay(FrameTimes));
+			}
+		}
+		{
+			FScopedFixedStepRate ScopedFixedStepRate(0.f);
+			for (const TArray<float>& FrameTimes : Replays)
+			{
+				PerFrameEnds.Add(Replay(FrameTimes));
+			}
+		}
+
+		float FixedLocationSpread = 0.f, FixedRotationSpread = 0.f;
+		float PerFrameLocationSpread = 0.f, PerFrameRotationSpread = 0.f;
+		float LocationDifference = 0.f, RotationDifference = 0.f;
+		for (int32 Idx = 0; Idx < Replays.Num(); Idx++)
+		{
+			MeasureDifference(FixedStepEnds[Idx], FixedStepEnds[0], FixedLocationSpread, FixedRotationSpread);
+			MeasureDifference(PerFrameEnds[Idx], PerFrameEnds[0], PerFrameLocationSpread, PerFrameRotationSpread);
+			MeasureDifference(FixedStepEnds[Idx], PerFrameEnds[0], LocationDifference, RotationDifference);
+		}
+
+		AddInfo(FString::Printf(TEXT("%s. End transform spread across frame times: fixed step %fcm %fdeg, per frame %fcm %fdeg. Fixed step from per frame at %.0f fps: %fcm %fdeg"),
+			Name, FixedLocationSpread, FixedRotationSpread, PerFrameLocationSpread, PerFrameRotationSpread, StepRate, LocationDifference, RotationDifference));
+
+		TestTrue(FString::Printf(TEXT("%s fixed step location spread %fcm"), Name, FixedLocationSpread), FixedLocationSpread <= SpreadTolerance);
+		TestTrue(FString::Printf(TEXT("%s fixed step rotation spread %fdeg"), Name, FixedRotationSpread), FixedRotationSpread <= SpreadTolerance);
+		TestTrue(FString::Printf(TEXT("%s fixed step location against per frame %fcm"), Name, LocationDifference), LocationDifference <= MatchTolerance);
+		TestTrue(FString::Printf(TEXT("%s fixed step rotation against per frame %fdeg"), Name, RotationDifference), RotationDifference <= MatchTolerance);
+	};
+
+	TestModifier(TEXT("Simple warp (world space)"), [&](const TArray<float>& FrameTimes) { return ReplayWindow<FVIRootMotionModifier_Warp>(TestCharacter, Window, false, FrameTimes); });
+	TestModifier(TEXT("Simple warp (local space)"), [&](const TArray<float>& FrameTimes) { return ReplayWindow<FVIRootMotionModifier_Warp>(TestCharacter, Window, true, FrameTimes); });
+	TestModifier(TEXT("Skew warp"), [&](const TArray<float>& FrameTimes) { return ReplayWindow<FVIRootMotionModifier_SkewWarp>(TestCharacter, Window, false, FrameTimes); });
+
+	return true;
+}
+
+// Fixed step warp correction
+///////////////////////////////////////////////////////////////
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVIFixedStepWarpCorrectionTest, "VIMotionWarping.Warp.FixedStepCorrection", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+ * Replays the vault warping window on a fixed step with the character moved off the track partway, as a server correction, a blocked move or a base change would
+ * The track has to be rebuilt from where the character is, so the window still ends on the sync point where the uncorrected replay does,
+ * and where a replay warped every frame from the corrected start does
+ */
+bool FVIFixedStepWarpCorrectionTest::RunTest(const FString& Parameters)
+{
+	using namespace VIFixedStepWarpTests;
+
+	constexpr float MatchTolerance = 0.1f;
+
+	FTestCharacter TestCharacter;
+
+	FTestWindow Window;
+	if (!MakeVaultWindow(*this, TestCharacter, Window))
+	{
+		return false;
+	}
+
+	// Pushed aside, held back like a blocked move, and lifted like a moving base
+	const FVector Corrections[] = { FVector(0.f, 15.f, 0.f), FVector(-10.f, 0.f, 0.f), FVector(0.f, 0.f, 8.f) };
+
+	FScopedFixedStepRate ScopedFixedStepRate(StepRate);
+
+	auto TestModifier = [&](const TCHAR* Name, auto&& Replay)
+	{
+		for (const float FrameRate : { 30.f, StepRate, 144.f })
+		{
+			const TArray<float> FrameTimes = MakeFrameTimes(Window, FrameRate, true);
+			const FTransform UncorrectedEnd = Replay(FrameTimes, INDEX_NONE, FVector::ZeroVector);
+
+			for (const FVector& Correction : Corrections)
+			{
+				for (const int32 CorrectionFrame : { 0, FrameTimes.Num() / 3, FrameTimes.Num() / 2 })
+				{
+					const FTransform CorrectedEnd = Replay(FrameTimes, CorrectionFrame, Correction);
+
+					float LocationDifference = 0.f, RotationDifference = 0.f;
+					MeasureDifference(CorrectedEnd, UncorrectedEnd, LocationDifference, RotationDifference);
+
+					const FString Case = FString::Printf(TEXT("%s at %.0f fps corrected by %s after frame %d"), Name, FrameRate, *Correction.ToCompactString(), CorrectionFrame);
+					TestTrue(FString::Printf(TEXT("%s location against uncorrected %fcm"), *Case, LocationDifference), LocationDifference <= MatchTolerance);
+					TestTrue(FString::Printf(TEXT("%s rotation against uncorrected %fdeg"), *Case, RotationDifference), RotationDifference <= MatchTolerance);
+				}
+			}
+		}
+	};
+
+	TestModifier(TEXT("Simple warp (world space)"), [&](const TArray<float>& FrameTimes, int32 CorrectionFrame, const FVector& Correction)
+	{
+		return ReplayWindow<FVIRootMotionModifier_Warp>(TestCharacter, Window, false, FrameTimes, CorrectionFrame, Correction);
+	});
+	TestModifier(TEXT("Simple warp (local space)"), [&](const TArray<float>& FrameTimes, int32 CorrectionFrame, const FVector& Correction)
+	{
+		return ReplayWindow<FVIRootMotionModifier_Warp>(TestCharacter, Window, true, FrameTimes, CorrectionFrame, Correction);
+	});
+	TestModifier(TEXT("Skew warp"), [&](const TArray<float>& FrameTimes, int32 CorrectionFrame, const FVector& Correction)
+	{
+		return ReplayWindow<FVIRootMotionModifier_SkewWarp>(TestCharacter, Window, false, FrameTimes, CorrectionFrame, Correction);
+	});
+
+	// Starting the window away from where it was predicted to start, the track has to match warping every frame from there
+	{
+		FTestWindow CorrectedWindow = Window;
+		CorrectedWindow.StartTransform.AddToTranslation(FVector(5.f, -12.f, 0.f));
+
+		const TArray<float> StepRateFrameTimes = MakeFrameTimes(CorrectedWindow, StepRate, false);
+		const FTransform FixedStepEnd = ReplayWindow<FVIRootMotionModifier_Warp>(TestCharacter, CorrectedWindow, false, StepRateFrameTimes);
+		FTransform PerFrameEnd;
+		{
+			FScopedFixedStepRate PerFrameRate(0.f);
+			PerFrameEnd = ReplayWindow<FVIRootMotionModifier_Warp>(TestCharacter, CorrectedWindow, false, StepRateFrameTimes);
+		}
+
+		float LocationDifference = 0.f, RotationDifference = 0.f;
+		MeasureDifference(FixedStepEnd, PerFrameEnd, LocationDifference, RotationDifference);
+		TestTrue(FString::Printf(TEXT("Corrected start fixed step location against per frame %fcm"), LocationDifference), LocationDifference <= MatchTolerance);
+		TestTrue(FString::Printf(TEXT("Corrected start fixed step rotation against per frame %fdeg"), RotationDifference), RotationDifference <= MatchTolerance);
+	}
+
+	return true;
+}
+
+#endif  // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,208 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Math/RandomStream.h"
+#include "VIBenchmarkReport.h"
+#include "VIWarpMath.h"
+
+namespace VIWarpMath
+{
+	/** Window used by the tests, a vault-like arc warped to a further and higher ledge */
+	static const FVector TestRootMotion(300.f, 0.f, 100.f);
+	static const FVector TestTargetLocation(420.f, 60.f, 140.f);
+	static const FQuat TestTargetRotation(FRotator(0.f, 90.f, 0.f));
+	static constexpr int32 TestSteps = 30;
+	static constexpr float TestDeltaSeconds = 1.f / 30.f;
+
+	/** @return Distance from the target after following the simple warp through the window */
+	static float SimulateWarpTranslation()
+	{
+		const FVector Up = FVector::UpVector;
+		const FVector RootMotionDelta = TestRootMotion / TestSteps;
+
+		FVector Location = FVector::ZeroVector;
+		for (int32 Step = 0; Step < TestSteps; Step++)
+		{
+			const FVector RootMotionTotal = TestRootMotion * ((TestSteps - Step) / (float)TestSteps);
+			const FVector LocationFwd = FVector::VectorPlaneProject(Location, Up);
+			const FVector TargetFwd = FVector::VectorPlaneProject(TestTargetLocation, Up);
+			const float VerticalTarget = FVIWarpMath::ComputeDirectionForVector(TestTargetLocation, Up) - FVIWarpMath::ComputeDirectionForVector(Location, Up);
+
+			Location += FVIWarpMath::WarpTranslation(RootMotionDelta, RootMotionTotal, FVector::Dist(LocationFwd, TargetFwd), (TargetFwd - LocationFwd).GetSafeNormal(), VerticalTarget, Up, false);
+		}
+
+		return FVector::Dist(Location, TestTargetLocation);
+	}
+
+	/** @return Distance from the target after following the skew warp through the window */
+	static float SimulateSkewWarpTranslation()
+	{
+		const FVector RootMotionDelta = TestRootMotion / TestSteps;
+
+		FVector Location = FVector::ZeroVector;
+		for (int32 Step = 0; Step < TestSteps; Step++)
+		{
+			const FVector FutureLocation = Location + TestRootMotion * ((TestSteps - Step) / (float)TestSteps);
+			Location += FVIWarpMath::SkewWarpTranslation(RootMotionDelta, Location, FQuat::Identity, FutureLocation, TestTargetLocation);
+		}
+
+		return FVector::Dist(Location, TestTargetLocation);
+	}
+
+	/** @return Angle in degrees from the target rotation after following the rotation warp through the window */
+	static float SimulateWarpRotation()
+	{
+		FQuat Rotation = FQuat::Identity;
+		for (int32 Step = 0; Step < TestSteps; Step++)
+		{
+			const float TimeRemaining = (TestSteps - Step) * TestDeltaSeconds;
+			Rotation = FVIWarpMath::WarpRotation(FQuat::Identity, FQuat::Identity, Rotation, TestTargetRotation, TimeRemaining, TestDeltaSeconds) * Rotation;
+		}
+
+		return FMath::RadiansToDegrees(Rotation.AngularDistance(TestTargetRotation));
+	}
+
+	/** @return Largest difference, in cm or degrees, of root motion converted to world space and back */
+	static float RoundTripRootMotionConversion()
+	{
+		const FTransform ActorTransform(FRotator(10.f, 35.f, -5.f), FVector(120.f, -40.f, 90.f));
+		const FTransform MeshRelativeTransform(FRotator(0.f, -90.f, 0.f), FVector(0.f, 0.f, -90.f));
+		const FTransform LocalRootMotion(FRotator(0.f, 12.f, 0.f), FVector(14.f, 3.f, 6.f));
+
+		const FTransform WorldRootMotion = FVIWarpMath::ConvertLocalRootMotionToWorld(LocalRootMotion, ActorTransform, MeshRelativeTransform);
+		const FTransform RoundTrip = FVIWarpMath::ConvertWorldRootMotionToLocal(WorldRootMotion, ActorTransform, MeshRelativeTransform);
+
+		return FMath::Max(FVector::Dist(RoundTrip.GetTranslation(), LocalRootMotion.GetTranslation()), FMath::RadiansToDegrees(RoundTrip.GetRotation().AngularDistance(LocalRootMotion.GetRotation())));
+	}
+
+	/** @return True if the weights start at 0, end at 1 and never decrease */
+	static bool ValidateAdjustmentBlendWeights(const TArray<float>& Values)
+	{
+		TArray<float> Weights;
+		Weights.SetNumUninitialized(Values.Num());
+		FVIWarpMath::ComputeAdjustmentBlendWeights(Values.GetData(), Weights.GetData(), Values.Num());
+
+		bool bValid = FMath::IsNearlyZero(Weights[0]) && FMath::IsNearlyEqual(Weights.Last(), 1.f, KINDA_SMALL_NUMBER);
+		for (int32 Idx = 1; Idx < Weights.Num(); Idx++)
+		{
+			bValid &= Weights[Idx] >= Weights[Idx - 1];
+		}
+
+		return bValid;
+	}
+}
+
+// Validation
+///////////////////////////////////////////////////////////////
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVIWarpMathTest, "VIMotionWarping.WarpMath.Validate", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/** Runs the warp math through synthetic warping windows and checks each warp reaches its target */
+bool FVIWarpMathTest::RunTest(const FString& Parameters)
+{
+	constexpr float LocationTolerance = 0.1f;
+	constexpr float RotationTolerance = 0.1f;
+
+	const float WarpTranslationError = VIWarpMath::SimulateWarpTranslation();
+	TestTrue(FString::Printf(TEXT("WarpTranslation reaches the target, error %f"), WarpTranslationError), WarpTranslationError <= LocationTolerance);
+
+	const float SkewWarpTranslationError = VIWarpMath::SimulateSkewWarpTranslation();
+	TestTrue(FString::Printf(TEXT("SkewWarpTranslation reaches the target, error %f"), SkewWarpTranslationError), SkewWarpTranslationError <= LocationTolerance);
+
+	const float WarpRotationError = VIWarpMath::SimulateWarpRotation();
+	TestTrue(FString::Printf(TEXT("WarpRotation reaches the target, error %f"), WarpRotationError), WarpRotationError <= RotationTolerance);
+
+	const float RootMotionConversionError = VIWarpMath::RoundTripRootMotionConversion();
+	TestTrue(FString::Printf(TEXT("Root motion conversion round trips, error %f"), RootMotionConversionError), RootMotionConversionError <= LocationTolerance);
+
+	// Moving curve, and one that barely moves and falls back to linear weights
+	TArray<float> Moving;
+	TArray<float> Still;
+	for (int32 Idx = 0; Idx < 60; Idx++)
+	{
+		Moving.Add(FMath::Sin(Idx * 0.2f) * 50.f);
+		Still.Add(Idx * 0.001f);
+	}
+	TestTrue(TEXT("Adjustment blend weights of a moving curve"), VIWarpMath::ValidateAdjustmentBlendWeights(Moving));
+	TestTrue(TEXT("Adjustment blend weights of a still curve"), VIWarpMath::ValidateAdjustmentBlendWeights(Still));
+
+	return true;
+}
+
+// Benchmark
+///////////////////////////////////////////////////////////////
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVIWarpMathBenchmarkTest, "VIMotionWarping.WarpMath.Benchmark", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+/** Times each warp math function per call */
+bool FVIWarpMathBenchmarkTest::RunTest(const FString& Parameters)
+{
+	static constexpr int32 NumIterations = 100000;
+
+	// Inputs vary per call so nothing is hoisted out of the loop
+	FRandomStream Random(0);
+	TArray<FVector> Offsets;
+	Offsets.SetNumUninitialized(256);
+	for (FVector& Offset : Offsets)
+	{
+		Offset = Random.GetUnitVector() * 20.f;
+	}
+
+	TArray<float> Values;
+	TArray<float> Weights;
+	Values.SetNumUninitialized(60);
+	Weights.SetNumUninitialized(60);
+	for (float& Value : Values)
+	{
+		Value = Random.FRandRange(-100.f, 100.f);
+	}
+
+	FVIBenchmarkReport Report(*this, TEXT("VIMotionWarping_WarpMath.csv"), TEXT("Function,Calls,NsPerCall"));
+
+	double Sink = 0.0;
+	auto Run = [&Report](const TCHAR* Name, auto Function)
+	{
+		const double NsPerCall = FVIBenchmarkReport::Time(NumIterations, Function) * 1e9 / NumIterations;
+		Report.Add(FString::Printf(TEXT("%s %.1fns per call (%d calls)"), Name, NsPerCall, NumIterations), FString::Printf(TEXT("%s,%d,%.1f"), Name, NumIterations, NsPerCall));
+	};
+
+	const FVector RootMotionDelta = VIWarpMath::TestRootMotion / VIWarpMath::TestSteps;
+
+	Run(TEXT("WarpTranslation"), [&](int32 Iteration)
+	{
+		const FVector Target = VIWarpMath::TestTargetLocation + Offsets[Iteration & 255];
+		Sink += FVIWarpMath::WarpTranslation(RootMotionDelta, VIWarpMath::TestRootMotion, Target.Size2D(), Target.GetSafeNormal2D(), Target.Z, FVector::UpVector, false).X;
+	});
+
+	Run(TEXT("SkewWarpTranslation"), [&](int32 Iteration)
+	{
+		const FVector Target = VIWarpMath::TestTargetLocation + Offsets[Iteration & 255];
+		Sink += FVIWarpMath::SkewWarpTranslation(RootMotionDelta, FVector::ZeroVector, FQuat::Identity, VIWarpMath::TestRootMotion, Target).X;
+	});
+
+	Run(TEXT("WarpRotation"), [&](int32 Iteration)
+	{
+		const FQuat Target = FQuat(FRotator(0.f, Offsets[Iteration & 255].X * 4.f, 0.f));
+		Sink += FVIWarpMath::WarpRotation(FQuat::Identity, FQuat::Identity, FQuat::Identity, Target, 0.5f, VIWarpMath::TestDeltaSeconds).Z;
+	});
+
+	Run(TEXT("ComputeAdjustmentBlendWeights (60 samples)"), [&](int32 Iteration)
+	{
+		Values[Iteration % Values.Num()] += 1.f;
+		FVIWarpMath::ComputeAdjustmentBlendWeights(Values.GetData(), Weights.GetData(), Values.Num());
+		Sink += Weights[30];
+	});
+
+	// Also keeps the results alive
+	TestTrue(FString::Printf(TEXT("Benchmark results are finite, checksum %f"), Sink), FMath::IsFinite(Sink));
+
+	Report.Save();
+
+	return true;
+}
+
+#endif  // WITH_DEV_AUTOMATION_TESTS
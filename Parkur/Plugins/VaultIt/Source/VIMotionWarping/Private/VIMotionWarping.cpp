@@ -1,17 +1,21 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "VIMotionWarping.h"
+#include "VIMotionWarpingAnimCache.h"
+#include "VIMotionWarpingPrepass.h"
 
 #define LOCTEXT_NAMESPACE "VIMotionWarpingModule"
 
 void FVIMotionWarpingModule::StartupModule()
 {
-
+	FVIMotionWarpingAnimCache::Get().RegisterDelegates();
+	FVIMotionWarpingPrepass::Get().RegisterDelegates();
 }
 
 void FVIMotionWarpingModule::ShutdownModule()
 {
-
+	FVIMotionWarpingPrepass::Get().UnregisterDelegates();
+	FVIMotionWarpingAnimCache::Get().UnregisterDelegates();
 }
 
 #undef LOCTEXT_NAMESPACE
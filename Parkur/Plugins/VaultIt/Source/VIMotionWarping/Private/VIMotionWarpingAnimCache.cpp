@@ -0,0 +1,249 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "VIMotionWarpingAnimCache.h"
+
+#include "Animation/AnimMontage.h"
+#include "Animation/AnimSequenceBase.h"
+#include "UObject/UObjectGlobals.h"
+#include "VIAnimNotifyState_MotionWarping.h"
+#include "VIMotionWarpingComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("VIMotionWarping BuildWindowIndex"), STAT_VIMotionWarping_BuildWindowIndex, STATGROUP_Anim);
+DECLARE_CYCLE_STAT(TEXT("VIMotionWarping BuildRootMotionPrefix"), STAT_VIMotionWarping_BuildRootMotionPrefix, STATGROUP_Anim);
+
+static TAutoConsoleVariable<int32> CVarVIMotionWarpingRootMotionCache(
+	TEXT("a.VIMotionWarping.RootMotionCache"),
+	1,
+	TEXT("If 1, warp modifiers read root motion from a cumulative table sampled at 60hz instead of extracting it from the animation every tick"),
+	ECVF_Default);
+
+// FVIMotionWarpingWindowIndex
+///////////////////////////////////////////////////////////////////////
+
+void FVIMotionWarpingWindowIndex::Build(const UAnimMontage* Montage, bool bSearchForWindowsInAnimsWithinMontages)
+{
+	SCOPE_CYCLE_COUNTER(STAT_VIMotionWarping_BuildWindowIndex);
+
+	Windows.Reset();
+	MaxActiveLength = 0.f;
+
+	if (!Montage)
+	{
+		return;
+	}
+
+	// Notifies directly in the montage
+	for (const FAnimNotifyEvent& NotifyEvent : Montage->Notifies)
+	{
+		if (const UVIAnimNotifyState_MotionWarping* Notify = Cast<UVIAnimNotifyState_MotionWarping>(NotifyEvent.NotifyStateClass))
+		{
+			FVIMotionWarpingWindow& Window = Windows.AddDefaulted_GetRef();
+			Window.Notify = Notify;
+			Window.StartTime = FMath::Clamp(NotifyEvent.GetTriggerTime(), 0.f, Montage->GetPlayLength());
+			Window.EndTime = FMath::Clamp(NotifyEvent.GetEndTriggerTime(), 0.f, Montage->GetPlayLength());
+			Window.ActiveStartTime = Window.StartTime;
+			Window.ActiveEndTime = Window.EndTime;
+		}
+	}
+
+	if (bSearchForWindowsInAnimsWithinMontages)
+	{
+		// Notifies in every animation within the montage, only active while that segment plays
+		for (const FSlotAnimationTrack& SlotAnimTrack : Montage->SlotAnimTracks)
+		{
+			for (const FAnimSegment& AnimSegment : SlotAnimTrack.AnimTrack.AnimSegments)
+			{
+				const UAnimSequenceBase* const AnimReference = AnimSegment.GetAnimReference();
+				if (!AnimReference)
+				{
+					continue;
+				}
+
+				const float SegmentStartTime = AnimSegment.StartPos;
+				const float SegmentEndTime = AnimSegment.StartPos + AnimSegment.GetLength();
+
+				for (const FAnimNotifyEvent& NotifyEvent : AnimReference->Notifies)
+				{
+					if (const UVIAnimNotifyState_MotionWarping* Notify = Cast<UVIAnimNotifyState_MotionWarping>(NotifyEvent.NotifyStateClass))
+					{
+						const float NotifyStartTime = FMath::Clamp(NotifyEvent.GetTriggerTime(), 0.f, AnimReference->GetPlayLength());
+						const float NotifyEndTime = FMath::Clamp(NotifyEvent.GetEndTriggerTime(), 0.f, AnimReference->GetPlayLength());
+
+						// Convert notify times from AnimSequence times to montage times
+						FVIMotionWarpingWindow& Window = Windows.AddDefaulted_GetRef();
+						Window.Notify = Notify;
+						Window.StartTime = (NotifyStartTime - AnimSegment.AnimStartTime) + AnimSegment.StartPos;
+						Window.EndTime = (NotifyEndTime - AnimSegment.AnimStartTime) + AnimSegment.StartPos;
+						Window.ActiveStartTime = FMath::Max(Window.StartTime, SegmentStartTime);
+						Window.ActiveEndTime = FMath::Min(Window.EndTime, SegmentEndTime);
+					}
+				}
+			}
+		}
+	}
+
+	Windows.RemoveAll([](const FVIMotionWarpingWindow& Window) { return Window.ActiveEndTime <= Window.ActiveStartTime; });
+	Windows.StableSort([](const FVIMotionWarpingWindow& A, const FVIMotionWarpingWindow& B) { return A.ActiveStartTime < B.ActiveStartTime; });
+
+	for (const FVIMotionWarpingWindow& Window : Windows)
+	{
+		MaxActiveLength = FMath::Max(MaxActiveLength, Window.ActiveEndTime - Window.ActiveStartTime);
+	}
+}
+
+// FVIRootMotionPrefixTrack
+///////////////////////////////////////////////////////////////////////
+
+void FVIRootMotionPrefixTrack::Build(const UAnimSequenceBase* Animation)
+{
+	SCOPE_CYCLE_COUNTER(STAT_VIMotionWarping_BuildRootMotionPrefix);
+
+	Samples.Reset();
+	PlayLength = Animation ? Animation->GetPlayLength() : 0.f;
+
+	const int32 NumSamples = FMath::CeilToInt(PlayLength * SampleRate) + 1;
+	Samples.Reserve(NumSamples);
+	Samples.Add(FTransform::Identity);
+
+	// Accumulate in steps, each extraction is only as expensive as its own range
+	float PreviousTime = 0.f;
+	for (int32 Idx = 1; Idx < NumSamples; Idx++)
+	{
+		const float Time = FMath::Min(Idx / SampleRate, PlayLength);
+		Samples.Add(UVIMotionWarpingUtilities::ExtractVIRootMotionFromAnimation(Animation, PreviousTime, Time) * Samples.Last());
+		PreviousTime = Time;
+	}
+}
+
+FTransform FVIRootMotionPrefixTrack::Evaluate(float Position) const
+{
+	if (Samples.Num() < 2)
+	{
+		return FTransform::Identity;
+	}
+
+	const float Time = FMath::Clamp(Position, 0.f, PlayLength);
+	const int32 Idx = FMath::Min(FMath::FloorToInt(Time * SampleRate), Samples.Num() - 2);
+
+	// Last interval is shorter unless PlayLength is a multiple of the sample rate
+	const float IntervalStart = Idx / SampleRate;
+	const float IntervalEnd = FMath::Min((Idx + 1) / SampleRate, PlayLength);
+	const float Alpha = IntervalEnd > IntervalStart ? FMath::Clamp((Time - IntervalStart) / (IntervalEnd - IntervalStart), 0.f, 1.f) : 1.f;
+
+	FTransform Result;
+	Result.Blend(Samples[Idx], Samples[Idx + 1], Alpha);
+	return Result;
+}
+
+// FVIMotionWarpingAnimCache
+///////////////////////////////////////////////////////////////////////
+
+FVIMotionWarpingAnimCache& FVIMotionWarpingAnimCache::Get()
+{
+	static FVIMotionWarpingAnimCache Instance;
+	return Instance;
+}
+
+const FVIMotionWarpingWindowIndex& FVIMotionWarpingAnimCache::FindOrBuild(const UAnimMontage* Montage, bool bSearchForWindowsInAnimsWithinMontages)
+{
+	check(IsInGameThread());
+
+	FCacheEntry& Entry = Entries.FindOrAdd(FObjectKey(Montage));
+	TOptional<FVIMotionWarpingWindowIndex>& WindowIndex = bSearchForWindowsInAnimsWithinMontages ? Entry.AllWindows : Entry.MontageWindows;
+	if (!WindowIndex.IsSet())
+	{
+		WindowIndex.Emplace();
+		WindowIndex->Build(Montage, bSearchForWindowsInAnimsWithinMontages);
+	}
+
+	return WindowIndex.GetValue();
+}
+
+const FVIRootMotionPrefixTrack& FVIMotionWarpingAnimCache::FindOrBuildRootMotion(const UAnimSequenceBase* Animation)
+{
+	check(IsInGameThread());
+
+	FCacheEntry& Entry = Entries.FindOrAdd(FObjectKey(Animation));
+	if (!Entry.RootMotion.IsSet())
+	{
+		Entry.RootMotion.Emplace();
+		Entry.RootMotion->Build(Animation);
+	}
+
+	return Entry.RootMotion.GetValue();
+}
+
+FTransform FVIMotionWarpingAnimCache::ExtractRootMotion(const UAnimSequenceBase* Animation, float StartTime, float EndTime)
+{
+	if (!Animation)
+	{
+		return FTransform::Identity;
+	}
+
+	if (!IsRootMotionCacheEnabled())
+	{
+		return UVIMotionWarpingUtilities::ExtractVIRootMotionFromAnimation(Animation, StartTime, EndTime);
+	}
+
+	return FindOrBuildRootMotion(Animation).Extract(StartTime, EndTime);
+}
+
+bool FVIMotionWarpingAnimCache::IsRootMotionCacheEnabled() const
+{
+	return CVarVIMotionWarpingRootMotionCache.GetValueOnGameThread() != 0;
+}
+
+void FVIMotionWarpingAnimCache::Reset()
+{
+	Entries.Reset();
+}
+
+void FVIMotionWarpingAnimCache::RegisterDelegates()
+{
+	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddRaw(this, &FVIMotionWarpingAnimCache::OnPostGarbageCollect);
+
+#if WITH_EDITOR
+	ObjectModifiedHandle = FCoreUObjectDelegates::OnObjectModified.AddRaw(this, &FVIMotionWarpingAnimCache::OnObjectModified);
+	ObjectPropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddRaw(this, &FVIMotionWarpingAnimCache::OnObjectPropertyChanged);
+#endif
+}
+
+void FVIMotionWarpingAnimCache::UnregisterDelegates()
+{
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+
+#if WITH_EDITOR
+	FCoreUObjectDelegates::OnObjectModified.Remove(ObjectModifiedHandle);
+	FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(ObjectPropertyChangedHandle);
+#endif
+
+	Reset();
+}
+
+void FVIMotionWarpingAnimCache::OnPostGarbageCollect()
+{
+	// Montages that were unloaded
+	for (auto It = Entries.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().ResolveObjectPtr())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+#if WITH_EDITOR
+void FVIMotionWarpingAnimCache::OnObjectModified(UObject* Object)
+{
+	// Any animation may be within a montage, notify changes also modify the notify itself
+	if (Object && (Object->IsA<UAnimSequenceBase>() || Object->IsA<UVIAnimNotifyState_MotionWarping>()))
+	{
+		Reset();
+	}
+}
+
+void FVIMotionWarpingAnimCache::OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	OnObjectModified(Object);
+}
+#endif
@@ -11,6 +11,9 @@
 #include "GameFramework/Character.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "VIAnimNotifyState_MotionWarping.h"
+#include "VIMotionWarpingAnimCache.h"
+#include "VIMotionWarpingPrepass.h"
+#include "VIRootMotionModifier_AdjustmentBlendWarp.h"
 
 DEFINE_LOG_CATEGORY(LogVIMotionWarping);
 
@@ -151,17 +154,22 @@ void UVIMotionWarpingComponent::InitializeComponent()
 
 bool UVIMotionWarpingComponent::ContainsModifier(const UAnimSequenceBase* Animation, float StartTime, float EndTime) const
 {
-	return VIRootMotionModifiers.ContainsByPredicate([=](const TSharedPtr<FVIRootMotionModifier>& Modifier)
-		{
-			return (Modifier.IsValid() && Modifier->Animation == Animation && Modifier->StartTime == StartTime && Modifier->EndTime == EndTime);
-		});
+	return VIRootMotionModifierKeys.Contains(FVIRootMotionModifierKey(Animation, StartTime, EndTime));
 }
 
 void UVIMotionWarpingComponent::AddVIRootMotionModifier(TSharedPtr<FVIRootMotionModifier> Modifier)
 {
 	if (ensureAlways(Modifier.IsValid()))
 	{
+		if (VIRootMotionModifiers.Num() == 0)
+		{
+			FVIMotionWarpingPrepass::Get().AddComponent(this);
+		}
+
 		VIRootMotionModifiers.Add(Modifier);
+		VIRootMotionModifierKeys.Add(FVIRootMotionModifierKey(Modifier->Animation.Get(), Modifier->StartTime, Modifier->EndTime));
+
+		CacheIKWarpModifier();
 
 		UE_LOG(LogVIMotionWarping, Verbose, TEXT("VIMotionWarping: VIRootMotionModifier added. NetMode: %d WorldTime: %f Char: %s Animation: %s [%f %f] [%f %f] Loc: %s Rot: %s"),
 			GetWorld()->GetNetMode(), GetWorld()->GetTimeSeconds(), *GetNameSafe(GetCharacterOwner()), *GetNameSafe(Modifier->Animation.Get()), Modifier->StartTime, Modifier->EndTime, Modifier->PreviousPosition, Modifier->CurrentPosition,
@@ -178,6 +186,46 @@ void UVIMotionWarpingComponent::DisableAllVIRootMotionModifiers()
 			Modifier->State = EVIRootMotionModifierState::Disabled;
 		}
 	}
+
+	IKWarpModifier = nullptr;
+}
+
+const FVIRootMotionModifier_AdjustmentBlendWarp* UVIMotionWarpingComponent::GetIKWarpModifier() const
+{
+	if (IKWarpModifier && IKWarpModifier->State == EVIRootMotionModifierState::Active)
+	{
+		// We must check if the Animation for the modifier is still relevant because in VIRootMotionFromMontageOnlyMode the montage could be aborted 
+		// but the modifier will remain in the list until the next update
+		const FAnimMontageInstance* VIRootMotionMontageInstance = GetCharacterOwner() ? GetCharacterOwner()->GetRootMotionAnimMontageInstance() : nullptr;
+		const UAnimMontage* Montage = VIRootMotionMontageInstance ? VIRootMotionMontageInstance->Montage : nullptr;
+		if (Montage && IKWarpModifier->Animation == Montage)
+		{
+			return IKWarpModifier;
+		}
+	}
+
+	return nullptr;
+}
+
+void UVIMotionWarpingComponent::CacheIKWarpModifier()
+{
+	IKWarpModifier = nullptr;
+
+	const FAnimMontageInstance* VIRootMotionMontageInstance = GetCharacterOwner() ? GetCharacterOwner()->GetRootMotionAnimMontageInstance() : nullptr;
+	const UAnimMontage* Montage = VIRootMotionMontageInstance ? VIRootMotionMontageInstance->Montage : nullptr;
+	if (!Montage)
+	{
+		return;
+	}
+
+	for (const TSharedPtr<FVIRootMotionModifier>& Modifier : VIRootMotionModifiers)
+	{
+		if (Modifier->State == EVIRootMotionModifierState::Active && Modifier->Animation == Montage && Modifier->GetScriptStruct()->IsChildOf(FVIRootMotionModifier_AdjustmentBlendWarp::StaticStruct()))
+		{
+			IKWarpModifier = static_cast<const FVIRootMotionModifier_AdjustmentBlendWarp*>(Modifier.Get());
+			break;
+		}
+	}
 }
 
 void UVIMotionWarpingComponent::Update()
@@ -191,58 +239,15 @@ void UVIMotionWarpingComponent::Update()
 		const float PreviousPosition = VIRootMotionMontageInstance->GetPreviousPosition();
 		// const float CurrentPosition = VIRootMotionMontageInstance->GetPosition();
 
-		// Loop over notifies directly in the montage, looking for Motion Warping windows
-		for (const FAnimNotifyEvent& NotifyEvent : Montage->Notifies)
+		// Warping windows are indexed once per montage, shared by all characters
+		const FVIMotionWarpingWindowIndex& WindowIndex = FVIMotionWarpingAnimCache::Get().FindOrBuild(Montage, bSearchForWindowsInAnimsWithinMontages);
+		WindowIndex.ForEachWindowAt(PreviousPosition, [this, Montage](const FVIMotionWarpingWindow& Window)
 		{
-			const UVIAnimNotifyState_MotionWarping* const VIMotionWarpingNotify = NotifyEvent.NotifyStateClass ? Cast<UVIAnimNotifyState_MotionWarping>(NotifyEvent.NotifyStateClass) : nullptr;
-			if (VIMotionWarpingNotify)
+			if (!ContainsModifier(Montage, Window.StartTime, Window.EndTime))
 			{
-				const float StartTime = FMath::Clamp(NotifyEvent.GetTriggerTime(), 0.f, Montage->GetPlayLength());
-				const float EndTime = FMath::Clamp(NotifyEvent.GetEndTriggerTime(), 0.f, Montage->GetPlayLength());
-
-				if (PreviousPosition >= StartTime && PreviousPosition < EndTime)
-				{
-					if (!ContainsModifier(Montage, StartTime, EndTime))
-					{
-						VIMotionWarpingNotify->AddVIRootMotionModifier(this, Montage, StartTime, EndTime);
-					}
-				}
+				Window.Notify->AddVIRootMotionModifier(this, Montage, Window.StartTime, Window.EndTime);
 			}
-		}
-
-		if(bSearchForWindowsInAnimsWithinMontages)
-		{
-			// Same as before but scanning all animation within the montage
-			for (int32 SlotIdx = 0; SlotIdx < Montage->SlotAnimTracks.Num(); SlotIdx++)
-			{
-				const FAnimTrack& AnimTrack = Montage->SlotAnimTracks[SlotIdx].AnimTrack;
-				const FAnimSegment* AnimSegment = AnimTrack.GetSegmentAtTime(PreviousPosition);
-				if (AnimSegment && AnimSegment->GetAnimReference())
-				{
-					for (const FAnimNotifyEvent& NotifyEvent : AnimSegment->GetAnimReference()->Notifies)
-					{
-						const UVIAnimNotifyState_MotionWarping* VIMotionWarpingNotify = NotifyEvent.NotifyStateClass ? Cast<UVIAnimNotifyState_MotionWarping>(NotifyEvent.NotifyStateClass) : nullptr;
-						if (VIMotionWarpingNotify)
-						{
-							const float NotifyStartTime = FMath::Clamp(NotifyEvent.GetTriggerTime(), 0.f, AnimSegment->GetAnimReference()->GetPlayLength());
-							const float NotifyEndTime = FMath::Clamp(NotifyEvent.GetEndTriggerTime(), 0.f, AnimSegment->GetAnimReference()->GetPlayLength());
-
-							// Convert notify times from AnimSequence times to montage times
-							const float StartTime = (NotifyStartTime - AnimSegment->AnimStartTime) + AnimSegment->StartPos;
-							const float EndTime = (NotifyEndTime - AnimSegment->AnimStartTime) + AnimSegment->StartPos;
-
-							if (PreviousPosition >= StartTime && PreviousPosition < EndTime)
-							{
-								if (!ContainsModifier(Montage, StartTime, EndTime))
-								{
-									VIMotionWarpingNotify->AddVIRootMotionModifier(this, Montage, StartTime, EndTime);
-								}
-							}
-						}
-					}
-				}
-			}
-		}
+		});
 	}
 
 	OnPreUpdate.Broadcast(this);
@@ -250,26 +255,55 @@ void UVIMotionWarpingComponent::Update()
 	// Update the state of all the modifiers
 	if(VIRootMotionModifiers.Num() > 0)
 	{
+		bool bAnyMarkedForRemoval = false;
 		for (const TSharedPtr<FVIRootMotionModifier>& Modifier : VIRootMotionModifiers)
 		{
 			Modifier->Update(*this);
+			bAnyMarkedForRemoval |= Modifier->State == EVIRootMotionModifierState::MarkedForRemoval;
 		}
 
-		// Remove the modifiers that has been marked for removal
-		VIRootMotionModifiers.RemoveAll([this](const TSharedPtr<FVIRootMotionModifier>& Modifier) 
-		{ 
-			if(Modifier->State == EVIRootMotionModifierState::MarkedForRemoval)
-			{
-				UE_LOG(LogVIMotionWarping, Verbose, TEXT("VIMotionWarping: VIRootMotionModifier removed. NetMode: %d WorldTime: %f Char: %s Animation: %s [%f %f] [%f %f] Loc: %s Rot: %s"),
-					GetWorld()->GetNetMode(), GetWorld()->GetTimeSeconds(), *GetNameSafe(GetCharacterOwner()), *GetNameSafe(Modifier->Animation.Get()), Modifier->StartTime, Modifier->EndTime, Modifier->PreviousPosition, Modifier->CurrentPosition,
-					*GetCharacterOwner()->GetActorLocation().ToString(), *GetCharacterOwner()->GetActorRotation().ToCompactString());
+		if (bAnyMarkedForRemoval)
+		{
+			RemoveMarkedVIRootMotionModifiers();
+		}
+	}
+
+	CacheIKWarpModifier();
+}
+
+void UVIMotionWarpingComponent::RemoveMarkedVIRootMotionModifiers()
+{
+	// Remove the modifiers that has been marked for removal
+	VIRootMotionModifiers.RemoveAll([this](const TSharedPtr<FVIRootMotionModifier>& Modifier) 
+	{ 
+		if(Modifier->State == EVIRootMotionModifierState::MarkedForRemoval)
+		{
+			UE_LOG(LogVIMotionWarping, Verbose, TEXT("VIMotionWarping: VIRootMotionModifier removed. NetMode: %d WorldTime: %f Char: %s Animation: %s [%f %f] [%f %f] Loc: %s Rot: %s"),
+				GetWorld()->GetNetMode(), GetWorld()->GetTimeSeconds(), *GetNameSafe(GetCharacterOwner()), *GetNameSafe(Modifier->Animation.Get()), Modifier->StartTime, Modifier->EndTime, Modifier->PreviousPosition, Modifier->CurrentPosition,
+				*GetCharacterOwner()->GetActorLocation().ToString(), *GetCharacterOwner()->GetActorRotation().ToCompactString());
+
+			VIRootMotionModifierKeys.Remove(FVIRootMotionModifierKey(Modifier->Animation.Get(), Modifier->StartTime, Modifier->EndTime));
 
-				return true;
+			// Only reuse modifiers nobody else is holding on to
+			if (Modifier.IsUnique())
+			{
+				VIRootMotionModifierPool.FindOrAdd(Modifier->GetScriptStruct()).Add(Modifier);
 			}
 
-			return false; 
-		});
+			return true;
+		}
+
+		return false; 
+	});
+
+	// Keys for animations that were unloaded mid-window can't be matched anymore
+	if (VIRootMotionModifiers.Num() == 0)
+	{
+		VIRootMotionModifierKeys.Reset();
 	}
+
+	// The cached modifier may have just gone back to the pool
+	CacheIKWarpModifier();
 }
 
 FTransform UVIMotionWarpingComponent::ProcessRootMotionPreConvertToWorld(const FTransform& InVIRootMotion, UCharacterMovementComponent* CharacterMovementComponent, float DeltaSeconds)
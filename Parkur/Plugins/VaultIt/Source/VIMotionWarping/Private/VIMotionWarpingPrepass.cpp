@@ -0,0 +1,157 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "VIMotionWarpingPrepass.h"
+
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "Animation/AnimMontage.h"
+#include "VIMotionWarpingAnimCache.h"
+#include "VIMotionWarpingComponent.h"
+#include "VIRootMotionModifier.h"
+
+DECLARE_CYCLE_STAT(TEXT("VIMotionWarping Prepass"), STAT_VIMotionWarping_Prepass, STATGROUP_Anim);
+DECLARE_DWORD_COUNTER_STAT(TEXT("VIMotionWarping Prepass Modifiers"), STAT_VIMotionWarping_PrepassModifiers, STATGROUP_Anim);
+
+static TAutoConsoleVariable<int32> CVarVIMotionWarpingPrepass(
+	TEXT("a.VIMotionWarping.Prepass"),
+	1,
+	TEXT("If 1, warp modifiers of every character are evaluated in parallel before actors tick instead of in each character's movement"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarVIMotionWarpingPrepassParallelThreshold(
+	TEXT("a.VIMotionWarping.PrepassParallelThreshold"),
+	4,
+	TEXT("Minimum number of modifiers to prepare before the prepass goes wide, fewer are prepared on the game thread"),
+	ECVF_Default);
+
+FVIMotionWarpingPrepass& FVIMotionWarpingPrepass::Get()
+{
+	static FVIMotionWarpingPrepass Prepass;
+	return Prepass;
+}
+
+void FVIMotionWarpingPrepass::AddComponent(UVIMotionWarpingComponent* Component)
+{
+	check(IsInGameThread());
+
+	Components.AddUnique(Component);
+}
+
+void FVIMotionWarpingPrepass::RegisterDelegates()
+{
+	WorldPreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddRaw(this, &FVIMotionWarpingPrepass::OnWorldPreActorTick);
+}
+
+void FVIMotionWarpingPrepass::UnregisterDelegates()
+{
+	FWorldDelegates::OnWorldPreActorTick.Remove(WorldPreActorTickHandle);
+
+	Components.Empty();
+	Items.Empty();
+}
+
+void FVIMotionWarpingPrepass::OnWorldPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (Components.Num() == 0 || TickType == LEVELTICK_TimeOnly || CVarVIMotionWarpingPrepass.GetValueOnGameThread() == 0)
+	{
+		return;
+	}
+
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+	if (FVIMotionWarpingCVars::CVarVIMotionWarpingDisable.GetValueOnGameThread() > 0)
+	{
+		return;
+	}
+#endif
+
+	SCOPE_CYCLE_COUNTER(STAT_VIMotionWarping_Prepass);
+
+	FVIMotionWarpingAnimCache& AnimCache = FVIMotionWarpingAnimCache::Get();
+	const bool bUseRootMotionCache = AnimCache.IsRootMotionCacheEnabled();
+
+	Items.Reset();
+
+	for (int32 Idx = Components.Num() - 1; Idx >= 0; Idx--)
+	{
+		UVIMotionWarpingComponent* Component = Components[Idx].Get();
+		if (!Component || Component->GetVIRootMotionModifiers().Num() == 0)
+		{
+			Components.RemoveAtSwap(Idx, 1, false);
+			continue;
+		}
+
+		if (Component->GetWorld() != World)
+		{
+			continue;
+		}
+
+		// Movement ticks the montage from its current position, which is where the warp starts from this frame
+		const ACharacter* CharacterOwner = Component->GetCharacterOwner();
+		const FAnimMontageInstance* MontageInstance = CharacterOwner ? CharacterOwner->GetRootMotionAnimMontageInstance() : nullptr;
+		if (!MontageInstance || !MontageInstance->Montage)
+		{
+			continue;
+		}
+
+		// The server moves remote autonomous proxies when their moves arrive, by the client's delta, so no step predicted here would match
+		if (CharacterOwner->GetLocalRole() == ROLE_Authority && CharacterOwner->GetRemoteRole() == ROLE_AutonomousProxy && !CharacterOwner->IsLocallyControlled())
+		{
+			continue;
+		}
+
+		// Same step the montage advances by in movement if it ticks once with the world's delta, anything else is caught by the modifiers
+		const float StepSeconds = DeltaSeconds * CharacterOwner->CustomTimeDilation;
+		const float Position = MontageInstance->GetPosition();
+		const float NextPosition = MontageInstance->IsPlaying() ? Position + StepSeconds * (MontageInstance->GetPlayRate() * MontageInstance->Montage->RateScale) : Position;
+		const FVIWarpCharacterState State(*CharacterOwner);
+
+		for (const TSharedPtr<FVIRootMotionModifier>& Modifier : Component->GetVIRootMotionModifiers())
+		{
+			if ((Modifier->State == EVIRootMotionModifierState::Active || Modifier->State == EVIRootMotionModifierState::Waiting) && Modifier->Animation.Get() == MontageInstance->Montage)
+			{
+				FPrepassItem& Item = Items.AddDefaulted_GetRef();
+				Item.Component = Component;
+				Item.Modifier = Modifier.Get();
+				Item.Animation = MontageInstance->Montage;
+				Item.Params.Position = Position;
+				Item.Params.NextPosition = NextPosition;
+				Item.Params.DeltaSeconds = StepSeconds;
+				Item.Params.State = State;
+
+				if (bUseRootMotionCache)
+				{
+					AnimCache.FindOrBuildRootMotion(Item.Animation);
+				}
+			}
+		}
+	}
+
+	if (Items.Num() == 0)
+	{
+		return;
+	}
+
+	// Everything is built by now, so the cache doesn't move until the prepass is done
+	if (bUseRootMotionCache)
+	{
+		for (FPrepassItem& Item : Items)
+		{
+			Item.Params.RootMotion = &AnimCache.FindOrBuildRootMotion(Item.Animation);
+		}
+	}
+
+	for (FPrepassItem& Item : Items)
+	{
+		Item.Modifier->GatherVIRootMotionPrepareInputs(*Item.Component, Item.Params);
+	}
+
+	INC_DWORD_STAT_BY(STAT_VIMotionWarping_PrepassModifiers, Items.Num());
+
+	const EParallelForFlags Flags = Items.Num() < CVarVIMotionWarpingPrepassParallelThreshold.GetValueOnGameThread() ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None;
+	ParallelFor(Items.Num(), [this](int32 Index)
+	{
+		const FPrepassItem& Item = Items[Index];
+		Item.Modifier->PrepareVIRootMotion(Item.Params);
+	}, Flags);
+}
@@ -1,12 +1,60 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "VIRootMotionModifier.h"
+#include "Algo/BinarySearch.h"
 #include "GameFramework/Character.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Animation/AnimMontage.h"
 #include "VIMotionWarpingComponent.h"
+#include "VIMotionWarpingAnimCache.h"
 #include "DrawDebugHelpers.h"
+#include "VIWarpMath.h"
+
+DECLARE_CYCLE_STAT(TEXT("VIMotionWarping BuildFixedStepTrack"), STAT_VIMotionWarping_BuildFixedStepTrack, STATGROUP_Anim);
+DECLARE_DWORD_COUNTER_STAT(TEXT("VIMotionWarping Fixed Step Track Rebuilds"), STAT_VIMotionWarping_FixedStepTrackRebuilds, STATGROUP_Anim);
+DECLARE_DWORD_COUNTER_STAT(TEXT("VIMotionWarping Prepared Warp Steps Used"), STAT_VIMotionWarping_PreparedWarpStepsUsed, STATGROUP_Anim);
+DECLARE_DWORD_COUNTER_STAT(TEXT("VIMotionWarping Prepared Warp Steps Discarded"), STAT_VIMotionWarping_PreparedWarpStepsDiscarded, STATGROUP_Anim);
+
+static TAutoConsoleVariable<float> CVarVIMotionWarpingSyncPointLocationTolerance(
+	TEXT("a.VIMotionWarping.SyncPointLocationTolerance"),
+	1.f,
+	TEXT("Sync point moves up to this distance (cm) are only applied once they persist for a.VIMotionWarping.SyncPointSettleTime. 0 applies every change"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarVIMotionWarpingSyncPointRotationTolerance(
+	TEXT("a.VIMotionWarping.SyncPointRotationTolerance"),
+	1.f,
+	TEXT("Sync point rotations up to this angle (degrees) are only applied once they persist for a.VIMotionWarping.SyncPointSettleTime. 0 applies every change"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarVIMotionWarpingFixedStepRate(
+	TEXT("a.VIMotionWarping.FixedStepRate"),
+	0.f,
+	TEXT("If above 0, simple and skew warps step the whole window at this rate (Hz) when it starts or the sync point changes, and frames sample the result by montage position.\n")
+	TEXT("Root motion then doesn't depend on frame rate and is identical on every peer starting from the same state. 0 warps every frame.\n")
+	TEXT("Must match on server and clients, so it is only set from config ([ConsoleVariables] in DefaultEngine.ini) and not from the console"),
+	ECVF_ReadOnly);
+
+static TAutoConsoleVariable<float> CVarVIMotionWarpingFixedStepRebuildLocationTolerance(
+	TEXT("a.VIMotionWarping.FixedStepRebuildLocationTolerance"),
+	1.f,
+	TEXT("The fixed step track is rebuilt from where the character is when it drifts further than this distance (cm) from the track,\n")
+	TEXT("eg. after a correction, a blocked move or a base change. Config only, like a.VIMotionWarping.FixedStepRate"),
+	ECVF_ReadOnly);
+
+static TAutoConsoleVariable<float> CVarVIMotionWarpingFixedStepRebuildRotationTolerance(
+	TEXT("a.VIMotionWarping.FixedStepRebuildRotationTolerance"),
+	1.f,
+	TEXT("The fixed step track is rebuilt from where the character is when it turns further than this angle (degrees) from the track. Config only, like a.VIMotionWarping.FixedStepRate"),
+	ECVF_ReadOnly);
+
+static TAutoConsoleVariable<float> CVarVIMotionWarpingSyncPointSettleTime(
+	TEXT("a.VIMotionWarping.SyncPointSettleTime"),
+	0.25f,
+	TEXT("Montage time in seconds a sync point change within tolerance must persist before warping targets it.\n")
+	TEXT("Measured on the montage rather than the world so the server and autonomous proxy accept the change on the same frame"),
+	ECVF_Default);
 
 // FVIRootMotionModifier
 ///////////////////////////////////////////////////////////////
@@ -52,6 +100,73 @@ void FVIRootMotionModifier::Update(UVIMotionWarpingComponent& OwnerComp)
 	}
 }
 
+void FVIRootMotionModifier::ResetModifier()
+{
+	Animation = nullptr;
+	StartTime = 0.f;
+	EndTime = 0.f;
+	PreviousPosition = 0.f;
+	CurrentPosition = 0.f;
+	Weight = 0.f;
+	State = EVIRootMotionModifierState::Waiting;
+}
+
+// FVIWarpCharacterState
+///////////////////////////////////////////////////////////////
+
+FVIWarpCharacterState::FVIWarpCharacterState(const ACharacter& Character)
+	: ActorTransform(Character.GetActorTransform())
+	, MeshRelativeTransform(Character.GetBaseRotationOffset(), Character.GetBaseTranslationOffset())
+	, CapsuleHalfHeight(Character.GetSimpleCollisionHalfHeight())
+{
+	// Same transform USkeletalMeshComponent::ConvertLocalRootMotionToWorld uses, includes network smoothing offsets the base offsets don't
+	if (USkeletalMeshComponent* Mesh = Character.GetMesh())
+	{
+		Mesh->ConditionalUpdateComponentToWorld();
+		MeshRelativeTransform = Mesh->GetComponentTransform().GetRelativeTransform(ActorTransform);
+	}
+}
+
+// FVIFixedStepWarpTrack
+///////////////////////////////////////////////////////////////
+
+FTransform FVIFixedStepWarpTrack::Evaluate(float Position) const
+{
+	if (Samples.Num() == 0)
+	{
+		return FTransform::Identity;
+	}
+
+	const int32 UpperIdx = Algo::UpperBound(Positions, Position);
+	if (UpperIdx == 0)
+	{
+		return Samples[0];
+	}
+	else if (UpperIdx >= Positions.Num())
+	{
+		return Samples.Last();
+	}
+
+	const int32 LowerIdx = UpperIdx - 1;
+	const float Alpha = (Position - Positions[LowerIdx]) / (Positions[UpperIdx] - Positions[LowerIdx]);
+
+	const FTransform& Lower = Samples[LowerIdx];
+	const FTransform& Upper = Samples[UpperIdx];
+	return FTransform(FQuat::Slerp(Lower.GetRotation(), Upper.GetRotation(), Alpha), FMath::Lerp(Lower.GetLocation(), Upper.GetLocation(), Alpha), Lower.GetScale3D());
+}
+
+bool FVIFixedStepWarpTrack::HasDrifted(float Position, const FTransform& ActorTransform, float LocationTolerance, float RotationTolerance) const
+{
+	if (Samples.Num() == 0)
+	{
+		return false;
+	}
+
+	const FTransform Expected = Evaluate(Position);
+	return FVector::DistSquared(Expected.GetLocation(), ActorTransform.GetLocation()) > FMath::Square(LocationTolerance) ||
+		Expected.GetRotation().AngularDistance(ActorTransform.GetRotation()) > FMath::DegreesToRadians(RotationTolerance);
+}
+
 // FVIRootMotionModifier_Warp
 ///////////////////////////////////////////////////////////////
 
@@ -75,161 +190,321 @@ void FVIRootMotionModifier_Warp::Update(UVIMotionWarpingComponent& OwnerComp)
 			return;
 		}
 
-		if (CachedSyncPoint != *SyncPointPtr)
+		if (ShouldAcceptSyncPoint(*SyncPointPtr, PreviousPosition))
 		{
 			CachedSyncPoint = *SyncPointPtr;
+			bHasCachedSyncPoint = true;
+			SyncPointChangeStartPosition = -1.f;
+
+			// Stepped again from where the character is now
+			FixedStepTrack.Reset();
+
+			// Warped towards the previous sync point
+			bHasPreparedWarpStep = false;
 
 			OnSyncPointChanged(OwnerComp);
 		}
 	}
 }
 
-float ComputeDirectionForVector(const FVector& Vector, const FVector& Dir)
+bool FVIRootMotionModifier_Warp::ShouldAcceptSyncPoint(const FVIMotionWarpingSyncPoint& SyncPoint, float Position)
 {
-	const FVector VectorProject = Vector.ProjectOnTo(Dir);
-	const float SignDirection = FMath::Sign(VectorProject | Dir);
+	if (!bHasCachedSyncPoint)
+	{
+		return true;
+	}
 
-	return VectorProject.Size() * SignDirection;
+	if (CachedSyncPoint == SyncPoint)
+	{
+		SyncPointChangeStartPosition = -1.f;
+		return false;
+	}
+
+	const float LocationTolerance = CVarVIMotionWarpingSyncPointLocationTolerance.GetValueOnGameThread();
+	const float RotationTolerance = FMath::DegreesToRadians(CVarVIMotionWarpingSyncPointRotationTolerance.GetValueOnGameThread());
+	if (FVector::DistSquared(CachedSyncPoint.GetLocation(), SyncPoint.GetLocation()) > FMath::Square(LocationTolerance) ||
+		CachedSyncPoint.GetRotation().AngularDistance(SyncPoint.GetRotation()) > RotationTolerance)
+	{
+		return true;
+	}
+
+	// Within tolerance, most likely noise. Only follow it if it stays
+	if (SyncPointChangeStartPosition < 0.f)
+	{
+		SyncPointChangeStartPosition = Position;
+	}
+
+	// Montages can play backwards
+	return FMath::Abs(Position - SyncPointChangeStartPosition) >= CVarVIMotionWarpingSyncPointSettleTime.GetValueOnGameThread();
+}
+
+void FVIRootMotionModifier_Warp::ResetModifier()
+{
+	FVIRootMotionModifier::ResetModifier();
+
+	// Makes sure OnSyncPointChanged fires for the new window
+	CachedSyncPoint = FVIMotionWarpingSyncPoint();
+	bHasCachedSyncPoint = false;
+	SyncPointChangeStartPosition = -1.f;
+	PreparedPosition = -1.f;
+	bHasPreparedWarpStep = false;
+	FixedStepTrack.Reset();
+}
+
+void FVIRootMotionModifier_Warp::PrepareVIRootMotion(const FVIRootMotionPrepareParams& Params)
+{
+	bHasPreparedWarpStep = false;
+
+	if (!Params.RootMotion)
+	{
+		PreparedPosition = -1.f;
+		return;
+	}
+
+	PreparedVIRootMotionTotal = Params.RootMotion->Extract(Params.Position, EndTime);
+	PreparedPosition = Params.Position;
+
+	// The same step ProcessWarp() takes, from the snapshot. Nothing to warp without a sync point, and fixed step frames only sample their track
+	if (bHasCachedSyncPoint && NeedsPreparedWarpStep())
+	{
+		PreparedNextPosition = FMath::Min(Params.NextPosition, EndTime);
+		PreparedDeltaSeconds = Params.DeltaSeconds;
+		PreparedState = Params.State;
+
+		const FTransform VIRootMotionDelta = Params.RootMotion->Extract(Params.Position, PreparedNextPosition);
+		PreparedInVIRootMotion = bInLocalSpace ? VIRootMotionDelta : FVIWarpMath::ConvertLocalRootMotionToWorld(VIRootMotionDelta, PreparedState.ActorTransform, PreparedState.MeshRelativeTransform);
+		PreparedWarpedVIRootMotion = WarpStep(PreparedState, PreparedInVIRootMotion, VIRootMotionDelta, PreparedVIRootMotionTotal, Params.Position, Params.DeltaSeconds);
+		bHasPreparedWarpStep = true;
+	}
+}
+
+bool FVIRootMotionModifier_Warp::NeedsPreparedWarpStep() const
+{
+	return FixedStepTrack.IsEmpty();
+}
+
+bool FVIRootMotionModifier_Warp::ConsumePreparedWarpStep(const FVIWarpCharacterState& State, const FTransform& InVIRootMotion, float DeltaSeconds, FTransform& OutWarpedVIRootMotion)
+{
+	if (!bHasPreparedWarpStep)
+	{
+		return false;
+	}
+
+	bHasPreparedWarpStep = false;
+
+	// Anything that moved the character, a different step or blended root motion since the prepass and it's evaluated again.
+	// Root motion from the montage and from the cache only differ by float error
+	if (PreparedPosition != PreviousPosition || PreparedNextPosition != FMath::Min(CurrentPosition, EndTime) || PreparedDeltaSeconds != DeltaSeconds
+		|| !PreparedState.Identical(State) || !PreparedInVIRootMotion.Equals(InVIRootMotion, KINDA_SMALL_NUMBER))
+	{
+		INC_DWORD_STAT(STAT_VIMotionWarping_PreparedWarpStepsDiscarded);
+		return false;
+	}
+
+	INC_DWORD_STAT(STAT_VIMotionWarping_PreparedWarpStepsUsed);
+	OutWarpedVIRootMotion = PreparedWarpedVIRootMotion;
+	return true;
+}
+
+FTransform FVIRootMotionModifier_Warp::GetVIRootMotionTotal() const
+{
+	if (PreparedPosition >= 0.f && PreparedPosition == PreviousPosition)
+	{
+		return PreparedVIRootMotionTotal;
+	}
+
+	return FVIMotionWarpingAnimCache::Get().ExtractRootMotion(Animation.Get(), PreviousPosition, EndTime);
 }
 
 FTransform FVIRootMotionModifier_Warp::ProcessVIRootMotion(UVIMotionWarpingComponent& OwnerComp, const FTransform& InVIRootMotion, float DeltaSeconds)
+{
+	const FTransform FinalVIRootMotion = ProcessWarp(OwnerComp, InVIRootMotion, DeltaSeconds);
+
+	// Debug
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+	const int32 DebugLevel = FVIMotionWarpingCVars::CVarVIMotionWarpingDebug.GetValueOnGameThread();
+	if (DebugLevel > 0)
+	{
+		PrintLog(OwnerComp, TEXT("FVIRootMotionModifier_Simple"), InVIRootMotion, FinalVIRootMotion);
+
+		if (DebugLevel >= 2)
+		{
+			const float DrawDebugDuration = FVIMotionWarpingCVars::CVarVIMotionWarpingDrawDebugDuration.GetValueOnGameThread();
+			DrawDebugCoordinateSystem(OwnerComp.GetWorld(), CachedSyncPoint.GetLocation(), CachedSyncPoint.Rotator(), 50.f, false, DrawDebugDuration, 0, 1.f);
+		}
+	}
+#endif
+
+	return FinalVIRootMotion;
+}
+
+FTransform FVIRootMotionModifier_Warp::ProcessWarp(UVIMotionWarpingComponent& OwnerComp, const FTransform& InVIRootMotion, float DeltaSeconds)
 {
 	const ACharacter* CharacterOwner = OwnerComp.GetCharacterOwner();
 	check(CharacterOwner);
 
-	const FTransform& CharacterTransform = CharacterOwner->GetActorTransform();
+	const FVIWarpCharacterState State(*CharacterOwner);
 
-	FTransform FinalVIRootMotion = InVIRootMotion;
+	const float StepSeconds = GetFixedStepSeconds();
+	if (StepSeconds > 0.f)
+	{
+		// The track is open loop, so re-anchor it on where the character actually is once it no longer follows it
+		const bool bDrifted = FixedStepTrack.HasDrifted(PreviousPosition, State.ActorTransform,
+			CVarVIMotionWarpingFixedStepRebuildLocationTolerance.GetValueOnGameThread(), CVarVIMotionWarpingFixedStepRebuildRotationTolerance.GetValueOnGameThread());
+		if (bDrifted)
+		{
+			INC_DWORD_STAT(STAT_VIMotionWarping_FixedStepTrackRebuilds);
+		}
 
-	const FTransform VIRootMotionTotal = UVIMotionWarpingUtilities::ExtractVIRootMotionFromAnimation(Animation.Get(), PreviousPosition, EndTime);
+		if (FixedStepTrack.IsEmpty() || bDrifted)
+		{
+			const UAnimSequenceBase* AnimationPtr = Animation.Get();
+			BuildFixedStepTrack(State, PreviousPosition, StepSeconds, [AnimationPtr](float Start, float End)
+			{
+				return FVIMotionWarpingAnimCache::Get().ExtractRootMotion(AnimationPtr, Start, End);
+			});
+		}
 
-	if (bWarpTranslation)
+		return ExtractFixedStepRootMotion(State);
+	}
+
+	FTransform WarpedVIRootMotion;
+	if (ConsumePreparedWarpStep(State, InVIRootMotion, DeltaSeconds, WarpedVIRootMotion))
 	{
-		const FVector& Up = CharacterOwner->GetActorUpVector();
+		return WarpedVIRootMotion;
+	}
 
-		FVector DeltaTranslation = InVIRootMotion.GetTranslation();
+	const FTransform VIRootMotionTotal = GetVIRootMotionTotal();
+	const FTransform VIRootMotionDelta = FVIMotionWarpingAnimCache::Get().ExtractRootMotion(Animation.Get(), PreviousPosition, FMath::Min(CurrentPosition, EndTime));
+
+	return WarpStep(State, InVIRootMotion, VIRootMotionDelta, VIRootMotionTotal, PreviousPosition, DeltaSeconds);
+}
+
+FTransform FVIRootMotionModifier_Warp::WarpStep(const FVIWarpCharacterState& State, const FTransform& InVIRootMotion, const FTransform& VIRootMotionDelta, const FTransform& VIRootMotionTotal, float Position, float DeltaSeconds) const
+{
+	const FTransform& CharacterTransform = State.ActorTransform;
+
+	FTransform FinalVIRootMotion = InVIRootMotion;
 
-		const FTransform VIRootMotionDelta = UVIMotionWarpingUtilities::ExtractVIRootMotionFromAnimation(Animation.Get(), PreviousPosition, FMath::Min(CurrentPosition, EndTime));
+	if (bWarpTranslation)
+	{
+		const FVector Up = CharacterTransform.GetUnitAxis(EAxis::Z);
 
-		const FVector VIRootMotionFwdDelta = FVector::VectorPlaneProject(VIRootMotionDelta.GetTranslation(), Up);
+		// Custom Arbitrary Up Vector code
 		const FVector CharacterTransformFwd = FVector::VectorPlaneProject(CharacterTransform.GetLocation(), Up);
 		const FVector CachedSyncPointFwd = FVector::VectorPlaneProject(CachedSyncPoint.GetLocation(), Up);
-		const FVector VIRootMotionTotalFwd = FVector::VectorPlaneProject(VIRootMotionTotal.GetTranslation(), Up);
-
-		const float HorizontalDelta = VIRootMotionFwdDelta.Size();
 		const float HorizontalTarget = FVector::Dist(CharacterTransformFwd, CachedSyncPointFwd);
-		const float HorizontalOriginal = VIRootMotionTotalFwd.Size();
-		const float HorizontalTranslationWarped = HorizontalOriginal != 0.f ? ((HorizontalDelta * HorizontalTarget) / HorizontalOriginal) : 0.f;
-
-		// Original Z-Bound Code
-		/*
-		const float HorizontalDelta = VIRootMotionDelta.GetTranslation().Size2D();
-		const float HorizontalTarget = FVector::Dist2D(CharacterTransform.GetLocation(), CachedSyncPoint.GetLocation());
-		const float HorizontalOriginal = VIRootMotionTotal.GetTranslation().Size2D();
-		const float HorizontalTranslationWarped = HorizontalOriginal != 0.f ? ((HorizontalDelta * HorizontalTarget) / HorizontalOriginal) : 0.f;
-		*/
 
+		FVector Direction;
 		if (bInLocalSpace)
 		{
-			const FTransform MeshRelativeTransform = FTransform(CharacterOwner->GetBaseRotationOffset(), CharacterOwner->GetBaseTranslationOffset());
-			const FTransform MeshTransform = MeshRelativeTransform * CharacterOwner->GetActorTransform();
-			DeltaTranslation = MeshTransform.InverseTransformPositionNoScale(CachedSyncPoint.GetLocation()).GetSafeNormal2D() * HorizontalTranslationWarped;
+			const FTransform MeshTransform = State.MeshRelativeTransform * CharacterTransform;
+			Direction = MeshTransform.InverseTransformPositionNoScale(CachedSyncPoint.GetLocation()).GetSafeNormal2D();
 		}
 		else
 		{
 			// This is the default (in world space)
-
-			// Custom Arbitrary Up Vector code
-			DeltaTranslation = (CachedSyncPointFwd - CharacterTransformFwd).GetSafeNormal() * HorizontalTranslationWarped;
-
-			// Original Z-Bound Code
-			//DeltaTranslation = (CachedSyncPoint.GetLocation() - CharacterTransform.GetLocation()).GetSafeNormal2D() * HorizontalTranslationWarped;
+			Direction = (CachedSyncPointFwd - CharacterTransformFwd).GetSafeNormal();
 		}
 
+		float VerticalTarget = 0.f;
 		if (!bIgnoreZAxis)
 		{
-			// Custom Arbitrary Up Vector code
-			const FVector CapsuleBottomLocation = (CharacterOwner->GetActorLocation() - (Up * CharacterOwner->GetSimpleCollisionHalfHeight()));
-			const float VerticalDelta = ComputeDirectionForVector(VIRootMotionDelta.GetTranslation(), Up);
-			const float VerticalTarget = ComputeDirectionForVector(CachedSyncPoint.GetLocation(), Up) - ComputeDirectionForVector(CapsuleBottomLocation, Up);
-			const float VerticalOriginal = ComputeDirectionForVector(VIRootMotionTotal.GetTranslation(), Up);
-			const float VerticalTranslationWarped = VerticalOriginal != 0.f ? ((VerticalDelta * VerticalTarget) / VerticalOriginal) : 0.f;
-
-			// Remove the Z component
-			DeltaTranslation = FVector::VectorPlaneProject(DeltaTranslation, Up);
-
-			// Add in new Z component
-			DeltaTranslation += Up * VerticalTranslationWarped;
-
-			// Original Z-Bound Code
-			/*
-			const FVector CapsuleBottomLocation = (CharacterOwner->GetActorLocation() - FVector::UpVector * CharacterOwner->GetSimpleCollisionHalfHeight());
-			const float VerticalDelta = VIRootMotionDelta.GetTranslation().Z;
-			const float VerticalTarget = CachedSyncPoint.GetLocation().Z - CapsuleBottomLocation.Z;
-			const float VerticalOriginal = VIRootMotionTotal.GetTranslation().Z;
-			const float VerticalTranslationWarped = VerticalOriginal != 0.f ? ((VerticalDelta * VerticalTarget) / VerticalOriginal) : 0.f;
-
-			DeltaTranslation.Z = VerticalTranslationWarped;
-			*/
+			const FVector CapsuleBottomLocation = (CharacterTransform.GetLocation() - (Up * State.CapsuleHalfHeight));
+			VerticalTarget = FVIWarpMath::ComputeDirectionForVector(CachedSyncPoint.GetLocation(), Up) - FVIWarpMath::ComputeDirectionForVector(CapsuleBottomLocation, Up);
 		}
 
+		const FVector DeltaTranslation = FVIWarpMath::WarpTranslation(VIRootMotionDelta.GetTranslation(), VIRootMotionTotal.GetTranslation(), HorizontalTarget, Direction, VerticalTarget, Up, bIgnoreZAxis);
 		FinalVIRootMotion.SetTranslation(DeltaTranslation);
 	}
 
 	if (bWarpRotation)
 	{
-		const FQuat WarpedRotation = WarpRotation(OwnerComp, InVIRootMotion, VIRootMotionTotal, DeltaSeconds);
+		const FQuat WarpedRotation = WarpRotation(CharacterTransform, InVIRootMotion, VIRootMotionTotal, Position, DeltaSeconds);
 		FinalVIRootMotion.SetRotation(WarpedRotation);
 	}
 
-	// Debug
-#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
-	const int32 DebugLevel = FVIMotionWarpingCVars::CVarVIMotionWarpingDebug.GetValueOnGameThread();
-	if (DebugLevel > 0)
+	return FinalVIRootMotion;
+}
+
+float FVIRootMotionModifier_Warp::GetFixedStepSeconds()
+{
+	const float StepRate = CVarVIMotionWarpingFixedStepRate.GetValueOnGameThread();
+	return StepRate > 0.f ? 1.f / FMath::Min(StepRate, 1000.f) : 0.f;
+}
+
+void FVIRootMotionModifier_Warp::BuildFixedStepTrack(const FVIWarpCharacterState& StartState, float StartPosition, float StepSeconds, TFunctionRef<FTransform(float, float)> ExtractRootMotion)
+{
+	SCOPE_CYCLE_COUNTER(STAT_VIMotionWarping_BuildFixedStepTrack);
+
+	check(StepSeconds > 0.f);
+
+	FixedStepTrack.Reset();
+
+	FVIWarpCharacterState State = StartState;
+	float Position = FMath::Min(StartPosition, EndTime);
+	FixedStepTrack.Positions.Add(Position);
+	FixedStepTrack.Samples.Add(State.ActorTransform);
+
+	int32 Step = FMath::Max(FMath::FloorToInt((Position - StartTime) / StepSeconds), 0) + 1;
+	while (Position < EndTime)
 	{
-		PrintLog(OwnerComp, TEXT("FVIRootMotionModifier_Simple"), InVIRootMotion, FinalVIRootMotion);
+		const float NextPosition = FMath::Min(StartTime + Step * StepSeconds, EndTime);
+		Step++;
 
-		if (DebugLevel >= 2)
+		if (NextPosition <= Position)
 		{
-			const float DrawDebugDuration = FVIMotionWarpingCVars::CVarVIMotionWarpingDrawDebugDuration.GetValueOnGameThread();
-			DrawDebugCoordinateSystem(OwnerComp.GetWorld(), CachedSyncPoint.GetLocation(), CachedSyncPoint.Rotator(), 50.f, false, DrawDebugDuration, 0, 1.f);
+			continue;
 		}
-	}
-#endif
 
-	return FinalVIRootMotion;
+		const FTransform VIRootMotionDelta = ExtractRootMotion(Position, NextPosition);
+		const FTransform VIRootMotionTotal = ExtractRootMotion(Position, EndTime);
+		const FTransform InVIRootMotion = bInLocalSpace ? VIRootMotionDelta : FVIWarpMath::ConvertLocalRootMotionToWorld(VIRootMotionDelta, State.ActorTransform, State.MeshRelativeTransform);
+
+		const FTransform WarpedVIRootMotion = WarpStep(State, InVIRootMotion, VIRootMotionDelta, VIRootMotionTotal, Position, NextPosition - Position);
+		const FTransform WorldVIRootMotion = bInLocalSpace ? FVIWarpMath::ConvertLocalRootMotionToWorld(WarpedVIRootMotion, State.ActorTransform, State.MeshRelativeTransform) : WarpedVIRootMotion;
+
+		// Moves like character movement applies root motion, without collision
+		State.ActorTransform.AddToTranslation(WorldVIRootMotion.GetTranslation());
+		State.ActorTransform.SetRotation((WorldVIRootMotion.GetRotation() * State.ActorTransform.GetRotation()).GetNormalized());
+
+		Position = NextPosition;
+		FixedStepTrack.Positions.Add(Position);
+		FixedStepTrack.Samples.Add(State.ActorTransform);
+	}
 }
 
-FQuat FVIRootMotionModifier_Warp::GetTargetRotation(UVIMotionWarpingComponent& OwnerComp) const
+FTransform FVIRootMotionModifier_Warp::ExtractFixedStepRootMotion(const FVIWarpCharacterState& State) const
 {
-	const FTransform& CharacterTransform = OwnerComp.GetCharacterOwner()->GetActorTransform();
+	const FTransform StartTransform = FixedStepTrack.Evaluate(PreviousPosition);
+	const FTransform EndTransform = FixedStepTrack.Evaluate(FMath::Min(CurrentPosition, EndTime));
+
+	const FTransform WorldVIRootMotion(EndTransform.GetRotation() * StartTransform.GetRotation().Inverse(), EndTransform.GetLocation() - StartTransform.GetLocation());
 
+	return bInLocalSpace ? FVIWarpMath::ConvertWorldRootMotionToLocal(WorldVIRootMotion, State.ActorTransform, State.MeshRelativeTransform) : WorldVIRootMotion;
+}
+
+FQuat FVIRootMotionModifier_Warp::GetTargetRotation(const FTransform& CharacterTransform, const FVIMotionWarpingSyncPoint& SyncPoint) const
+{
 	if (RotationType == EVIMotionWarpRotationType::Default)
 	{
-		return CachedSyncPoint.GetRotation();
+		return SyncPoint.GetRotation();
 	}
 	else if (RotationType == EVIMotionWarpRotationType::Facing)
 	{
-		const FVector ToSyncPoint = (CachedSyncPoint.GetLocation() - CharacterTransform.GetLocation()).GetSafeNormal2D();
-		return FRotationMatrix::MakeFromXZ(ToSyncPoint, FVector::UpVector).ToQuat();
+		return FVIWarpMath::FacingRotation(CharacterTransform.GetLocation(), SyncPoint.GetLocation());
 	}
 
 	return FQuat::Identity;
 }
 
-FQuat FVIRootMotionModifier_Warp::WarpRotation(UVIMotionWarpingComponent& OwnerComp, const FTransform& VIRootMotionDelta, const FTransform& VIRootMotionTotal, float DeltaSeconds)
+FQuat FVIRootMotionModifier_Warp::WarpRotation(const FTransform& CharacterTransform, const FTransform& VIRootMotionDelta, const FTransform& VIRootMotionTotal, float Position, float DeltaSeconds) const
 {
-	const FTransform& CharacterTransform = OwnerComp.GetCharacterOwner()->GetActorTransform();
 	const FQuat CurrentRotation = CharacterTransform.GetRotation();
-	const FQuat TargetRotation = GetTargetRotation(OwnerComp);
-	const float TimeRemaining = (EndTime - PreviousPosition) * WarpRotationTimeMultiplier;
-	const FQuat RemainingRootRotationInWorld = VIRootMotionTotal.GetRotation();
-	const FQuat CurrentPlusRemainingVIRootMotion = RemainingRootRotationInWorld * CurrentRotation;
-	const float PercentThisStep = FMath::Clamp(DeltaSeconds / TimeRemaining, 0.f, 1.f);
-	const FQuat TargetRotThisFrame = FQuat::Slerp(CurrentPlusRemainingVIRootMotion, TargetRotation, PercentThisStep);
-	const FQuat DeltaOut = TargetRotThisFrame * CurrentPlusRemainingVIRootMotion.Inverse();
-
-	return (DeltaOut * VIRootMotionDelta.GetRotation());
+	const FQuat TargetRotation = GetTargetRotation(CharacterTransform);
+	const float TimeRemaining = (EndTime - Position) * WarpRotationTimeMultiplier;
+
+	return FVIWarpMath::WarpRotation(VIRootMotionDelta.GetRotation(), VIRootMotionTotal.GetRotation(), CurrentRotation, TargetRotation, TimeRemaining, DeltaSeconds);
 }
 
 #if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
@@ -264,7 +539,7 @@ void UVIRootMotionModifierConfig_Warp::AddVIRootMotionModifierSimpleWarp(UVIMoti
 {
 	if (ensureAlways(InVIMotionWarpingComp))
 	{
-		TSharedPtr<FVIRootMotionModifier_Warp> NewModifier = MakeShared<FVIRootMotionModifier_Warp>();
+		TSharedPtr<FVIRootMotionModifier_Warp> NewModifier = InVIMotionWarpingComp->AcquireVIRootMotionModifier<FVIRootMotionModifier_Warp>();
 		NewModifier->Animation = InAnimation;
 		NewModifier->StartTime = InStartTime;
 		NewModifier->EndTime = InEndTime;
@@ -285,7 +560,7 @@ void UVIRootMotionModifierConfig_Scale::AddVIRootMotionModifierScale(UVIMotionWa
 {
 	if (ensureAlways(InVIMotionWarpingComp))
 	{
-		TSharedPtr<FVIRootMotionModifier_Scale> NewModifier = MakeShared<FVIRootMotionModifier_Scale>();
+		TSharedPtr<FVIRootMotionModifier_Scale> NewModifier = InVIMotionWarpingComp->AcquireVIRootMotionModifier<FVIRootMotionModifier_Scale>();
 		NewModifier->Animation = InAnimation;
 		NewModifier->StartTime = InStartTime;
 		NewModifier->EndTime = InEndTime;
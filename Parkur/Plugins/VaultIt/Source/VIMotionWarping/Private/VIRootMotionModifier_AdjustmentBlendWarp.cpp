@@ -10,135 +10,937 @@
 #include "GameFramework/Character.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "VIMotionWarpingComponent.h"
+#include "VIMotionWarpingAnimCache.h"
+#include "VIWarpMath.h"
+#include "VIAnimNotifyState_MotionWarping.h"
+#include "Animation/Skeleton.h"
+#include "UObject/ObjectSaveContext.h"
+#include "Misc/MemStack.h"
+#include "Tasks/Task.h"
+#include "UObject/GarbageCollection.h"
+#include <atomic>
 
 DECLARE_CYCLE_STAT(TEXT("VIMotionWarping PrecomputeWarpedTracks"), STAT_VIMotionWarping_PrecomputeWarpedTracks, STATGROUP_Anim);
 DECLARE_CYCLE_STAT(TEXT("VIMotionWarping ExtractMotionDelta"), STAT_VIMotionWarping_ExtractMotionDelta, STATGROUP_Anim);
+DECLARE_CYCLE_STAT(TEXT("VIMotionWarping RewarpRemainingTracks"), STAT_VIMotionWarping_RewarpRemainingTracks, STATGROUP_Anim);
+DECLARE_CYCLE_STAT(TEXT("VIMotionWarping CompressWarpedTracks"), STAT_VIMotionWarping_CompressWarpedTracks, STATGROUP_Anim);
+DECLARE_MEMORY_STAT(TEXT("VIMotionWarping Warped Tracks Memory"), STAT_VIMotionWarping_WarpedTracksMemory, STATGROUP_Anim);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("VIMotionWarping Warped Track Sets"), STAT_VIMotionWarping_WarpedTrackSets, STATGROUP_Anim);
+DECLARE_DWORD_COUNTER_STAT(TEXT("VIMotionWarping Prepared Warped Tracks Used"), STAT_VIMotionWarping_PreparedWarpedTracksUsed, STATGROUP_Anim);
+DECLARE_DWORD_COUNTER_STAT(TEXT("VIMotionWarping Prepared Warped Tracks Discarded"), STAT_VIMotionWarping_PreparedWarpedTracksDiscarded, STATGROUP_Anim);
+
+static TAutoConsoleVariable<int32> CVarVIMotionWarpingBakedDeltaTracks(
+	TEXT("a.VIMotionWarping.BakedDeltaTracks"),
+	1,
+	TEXT("If 1, adjustment blend warp uses the motion delta tracks baked with the animation instead of sampling them when the window starts"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarVIMotionWarpingCompressWarpedTracks(
+	TEXT("a.VIMotionWarping.CompressWarpedTracks"),
+	1,
+	TEXT("If 1, adjustment blend warped tracks are quantized once built. With a.VIMotionWarping.Debug the error against the uncompressed tracks is logged"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarVIMotionWarpingIncrementalRewarp(
+	TEXT("a.VIMotionWarping.IncrementalRewarp"),
+	1,
+	TEXT("If 1, small sync point changes shift the remaining part of the adjustment blend warped tracks instead of rebuilding them"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarVIMotionWarpingIncrementalRewarpMaxDistance(
+	TEXT("a.VIMotionWarping.IncrementalRewarpMaxDistance"),
+	50.f,
+	TEXT("Sync point moves (cm) beyond this rebuild the adjustment blend warped tracks"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarVIMotionWarpingIncrementalRewarpMaxAngle(
+	TEXT("a.VIMotionWarping.IncrementalRewarpMaxAngle"),
+	1.f,
+	TEXT("Sync point rotations (degrees) beyond this rebuild the adjustment blend warped tracks when warping rotation"),
+	ECVF_Default);
+
+// FVIBakedMotionDeltaTracks
+///////////////////////////////////////////////////////////////
+
+bool FVIBakedMotionDeltaTracks::Matches(const UAnimSequenceBase* InAnimation, float ActualStartTime, float InEndTime) const
+{
+	// Within half a sample the baked tracks are what we would sample anyway
+	const float Tolerance = FVIRootMotionModifier_AdjustmentBlendWarp::MotionDeltaSampleRate * 0.5f;
+	return IsValid() && Animation.Get() == InAnimation && FMath::IsNearlyEqual(StartTime, ActualStartTime, Tolerance) && FMath::IsNearlyEqual(EndTime, InEndTime, KINDA_SMALL_NUMBER);
+}
+
+bool FVIBakedMotionDeltaTracks::CopyTo(const FBoneContainer& BoneContainer, FVIMotionDeltaTrackContainer& OutMotionDeltaTracks) const
+{
+	const int32 TotalBones = BoneContainer.GetCompactPoseNumBones();
+	OutMotionDeltaTracks.Init(TotalBones, Tracks.NumFrames);
+
+	for (int32 BoneIdx = 0; BoneIdx < TotalBones; BoneIdx++)
+	{
+		const FName BoneName = BoneContainer.GetReferenceSkeleton().GetBoneName(BoneContainer.GetBoneIndicesArray()[BoneIdx]);
+		const int32 TrackIdx = BoneNames.IndexOfByKey(BoneName);
+		if (TrackIdx == INDEX_NONE)
+		{
+			return false;
+		}
+
+		OutMotionDeltaTracks.CopyBone(BoneIdx, Tracks, TrackIdx);
+	}
+
+	return true;
+}
+
+// FVICompressedWarpedTrack
+///////////////////////////////////////////////////////////////
+
+namespace VIWarpedTrackCompression
+{
+	static constexpr float TranslationQuantizationMax = 65535.f;
+	static constexpr float RotationQuantizationMax = 32767.f;
+}
+
+void FVICompressedWarpedTrack::Compress(const FRawAnimSequenceTrack& RawTrack)
+{
+	using namespace VIWarpedTrackCompression;
+
+	NumFrames = FMath::Min(RawTrack.PosKeys.Num(), RawTrack.RotKeys.Num());
+
+	Translations.SetNumUninitialized(NumFrames * 3);
+	Rotations.SetNumUninitialized(NumFrames * 3);
+
+	if (NumFrames == 0)
+	{
+		ScaleKeys.Reset();
+		return;
+	}
+
+	FVector3f TranslationMax = RawTrack.PosKeys[0];
+	TranslationMin = RawTrack.PosKeys[0];
+	for (int32 Frame = 1; Frame < NumFrames; Frame++)
+	{
+		TranslationMin = TranslationMin.ComponentMin(RawTrack.PosKeys[Frame]);
+		TranslationMax = TranslationMax.ComponentMax(RawTrack.PosKeys[Frame]);
+	}
+
+	TranslationStep = (TranslationMax - TranslationMin) / TranslationQuantizationMax;
+
+	for (int32 Frame = 0; Frame < NumFrames; Frame++)
+	{
+		const FVector3f Offset = RawTrack.PosKeys[Frame] - TranslationMin;
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			const float Quantized = TranslationStep[Axis] > 0.f ? FMath::RoundToFloat(Offset[Axis] / TranslationStep[Axis]) : 0.f;
+			Translations[Frame * 3 + Axis] = (uint16)FMath::Clamp(Quantized, 0.f, TranslationQuantizationMax);
+		}
+
+		EncodeRotation(RawTrack.RotKeys[Frame], &Rotations[Frame * 3]);
+	}
+
+	// Drop scale keys when there is nothing to interpolate
+	ScaleKeys.Reset();
+	if (RawTrack.ScaleKeys.Num() > 0)
+	{
+		bool bConstantScale = true;
+		for (int32 Idx = 1; Idx < RawTrack.ScaleKeys.Num() && bConstantScale; Idx++)
+		{
+			bConstantScale = RawTrack.ScaleKeys[Idx].Equals(RawTrack.ScaleKeys[0]);
+		}
+
+		if (bConstantScale)
+		{
+			ScaleKeys.Add(RawTrack.ScaleKeys[0]);
+		}
+		else
+		{
+			ScaleKeys = RawTrack.ScaleKeys;
+		}
+	}
+}
+
+void FVICompressedWarpedTrack::Decompress(FRawAnimSequenceTrack& OutRawTrack) const
+{
+	OutRawTrack.PosKeys.SetNumUninitialized(NumFrames);
+	OutRawTrack.RotKeys.SetNumUninitialized(NumFrames);
+	for (int32 Frame = 0; Frame < NumFrames; Frame++)
+	{
+		OutRawTrack.PosKeys[Frame] = GetTranslation(Frame);
+		OutRawTrack.RotKeys[Frame] = GetRotation(Frame);
+	}
+
+	OutRawTrack.ScaleKeys = ScaleKeys;
+}
+
+void FVICompressedWarpedTrack::ExtractTransformForFrame(int32 Frame, FTransform& OutTransform) const
+{
+	if (NumFrames == 0)
+	{
+		OutTransform.SetIdentity();
+		return;
+	}
+
+	Frame = FMath::Clamp(Frame, 0, NumFrames - 1);
+	OutTransform = FTransform(FQuat(GetRotation(Frame)), FVector(GetTranslation(Frame)), FVector(GetScale(Frame)));
+}
+
+void FVICompressedWarpedTrack::ExtractTransform(float Time, float SequenceLength, FTransform& OutTransform) const
+{
+	if (NumFrames == 0)
+	{
+		OutTransform.SetIdentity();
+		return;
+	}
+
+	int32 KeyIndex1, KeyIndex2;
+	float Alpha;
+	FAnimationRuntime::GetKeyIndicesFromTime(KeyIndex1, KeyIndex2, Alpha, Time, NumFrames, SequenceLength);
+
+	if (Alpha <= 0.f)
+	{
+		ExtractTransformForFrame(KeyIndex1, OutTransform);
+		return;
+	}
+	else if (Alpha >= 1.f)
+	{
+		ExtractTransformForFrame(KeyIndex2, OutTransform);
+		return;
+	}
+
+	FTransform KeyAtom1, KeyAtom2;
+	ExtractTransformForFrame(KeyIndex1, KeyAtom1);
+	ExtractTransformForFrame(KeyIndex2, KeyAtom2);
+
+	OutTransform.Blend(KeyAtom1, KeyAtom2, Alpha);
+	OutTransform.NormalizeRotation();
+}
+
+void FVICompressedWarpedTrack::EncodeRotation(const FQuat4f& InRotation, uint16* OutPacked)
+{
+	using namespace VIWarpedTrackCompression;
+
+	const FQuat4f Rotation = InRotation.GetNormalized();
+	const float Components[4] = { Rotation.X, Rotation.Y, Rotation.Z, Rotation.W };
+
+	int32 Largest = 0;
+	for (int32 Idx = 1; Idx < 4; Idx++)
+	{
+		if (FMath::Abs(Components[Idx]) > FMath::Abs(Components[Largest]))
+		{
+			Largest = Idx;
+		}
+	}
+
+	// q and -q are the same rotation, flip so the dropped component is positive and can be rebuilt
+	const float Sign = Components[Largest] < 0.f ? -1.f : 1.f;
+
+	// 2 bit index of the dropped component, then 15 bits for each of the others which are within +-1/sqrt(2)
+	uint64 Packed = (uint64)Largest << 45;
+	int32 Shift = 30;
+	for (int32 Idx = 0; Idx < 4; Idx++)
+	{
+		if (Idx != Largest)
+		{
+			const float Normalized = Components[Idx] * Sign * UE_HALF_SQRT_2 + 0.5f;
+			const uint64 Quantized = (uint64)FMath::Clamp(FMath::RoundToInt(Normalized * RotationQuantizationMax), 0, (int32)RotationQuantizationMax);
+			Packed |= Quantized << Shift;
+			Shift -= 15;
+		}
+	}
+
+	OutPacked[0] = (uint16)(Packed & 0xFFFF);
+	OutPacked[1] = (uint16)((Packed >> 16) & 0xFFFF);
+	OutPacked[2] = (uint16)((Packed >> 32) & 0xFFFF);
+}
+
+FQuat4f FVICompressedWarpedTrack::DecodeRotation(const uint16* Packed)
+{
+	using namespace VIWarpedTrackCompression;
+
+	const uint64 Bits = (uint64)Packed[0] | ((uint64)Packed[1] << 16) | ((uint64)Packed[2] << 32);
+	const int32 Largest = (int32)((Bits >> 45) & 3);
+
+	float Components[4];
+	float SumSquared = 0.f;
+	int32 Shift = 30;
+	for (int32 Idx = 0; Idx < 4; Idx++)
+	{
+		if (Idx != Largest)
+		{
+			const float Normalized = (float)((Bits >> Shift) & 0x7FFF) / RotationQuantizationMax;
+			Components[Idx] = (Normalized - 0.5f) * UE_SQRT_2;
+			SumSquared += FMath::Square(Components[Idx]);
+			Shift -= 15;
+		}
+	}
+
+	Components[Largest] = FMath::Sqrt(FMath::Max(0.f, 1.f - SumSquared));
+
+	return FQuat4f(Components[0], Components[1], Components[2], Components[3]);
+}
+
+// FVICompressedWarpedTrackContainer
+///////////////////////////////////////////////////////////////
+
+void FVICompressedWarpedTrackContainer::Compress(const FAnimSequenceTrackContainer& RawTracks)
+{
+	SCOPE_CYCLE_COUNTER(STAT_VIMotionWarping_CompressWarpedTracks);
+
+	Tracks.SetNum(RawTracks.AnimationTracks.Num());
+	for (int32 TrackIndex = 0; TrackIndex < Tracks.Num(); TrackIndex++)
+	{
+		Tracks[TrackIndex].Compress(RawTracks.AnimationTracks[TrackIndex]);
+	}
+
+	TrackNames = RawTracks.TrackNames;
+}
+
+void FVICompressedWarpedTrackContainer::Decompress(FAnimSequenceTrackContainer& OutRawTracks) const
+{
+	OutRawTracks.AnimationTracks.SetNum(Tracks.Num());
+	for (int32 TrackIndex = 0; TrackIndex < Tracks.Num(); TrackIndex++)
+	{
+		Tracks[TrackIndex].Decompress(OutRawTracks.AnimationTracks[TrackIndex]);
+	}
+
+	OutRawTracks.TrackNames = TrackNames;
+}
+
+SIZE_T FVICompressedWarpedTrackContainer::GetAllocatedSize() const
+{
+	SIZE_T Size = Tracks.GetAllocatedSize() + TrackNames.GetAllocatedSize();
+	for (const FVICompressedWarpedTrack& Track : Tracks)
+	{
+		Size += Track.GetAllocatedSize();
+	}
+
+	return Size;
+}
+
+SIZE_T FVICompressedWarpedTrackContainer::GetAllocatedSize(const FAnimSequenceTrackContainer& RawTracks)
+{
+	SIZE_T Size = RawTracks.AnimationTracks.GetAllocatedSize() + RawTracks.TrackNames.GetAllocatedSize();
+	for (const FRawAnimSequenceTrack& Track : RawTracks.AnimationTracks)
+	{
+		Size += Track.PosKeys.GetAllocatedSize() + Track.RotKeys.GetAllocatedSize() + Track.ScaleKeys.GetAllocatedSize();
+	}
+
+	return Size;
+}
+
+void FVICompressedWarpedTrackContainer::MeasureError(const FAnimSequenceTrackContainer& RawTracks, float& OutMaxTranslationError, float& OutMaxRotationError) const
+{
+	OutMaxTranslationError = 0.f;
+	OutMaxRotationError = 0.f;
+
+	for (int32 TrackIndex = 0; TrackIndex < Tracks.Num() && TrackIndex < RawTracks.AnimationTracks.Num(); TrackIndex++)
+	{
+		const FVICompressedWarpedTrack& Track = Tracks[TrackIndex];
+		const FRawAnimSequenceTrack& RawTrack = RawTracks.AnimationTracks[TrackIndex];
+		for (int32 Frame = 0; Frame < Track.NumFrames; Frame++)
+		{
+			// Angular distance in double, in float the acos alone is only good to a few hundredths of a degree
+			OutMaxTranslationError = FMath::Max(OutMaxTranslationError, FVector3f::Dist(Track.GetTranslation(Frame), RawTrack.PosKeys[Frame]));
+			OutMaxRotationError = FMath::Max(OutMaxRotationError, (float)FMath::RadiansToDegrees(FQuat(Track.GetRotation(Frame)).AngularDistance(FQuat(RawTrack.RotKeys[Frame]).GetNormalized())));
+		}
+	}
+}
+
+namespace VIWarpedTrackCompression
+{
+	/**
+	 * Compresses RawTracks into OutCompressedTracks and drops the raw keys, keeping the allocations for the next build
+	 * Doesn't touch the modifier so it can run on the worker building the tracks
+	 * @param DebugName		Logs the compression error under this name if set
+	 */
+	static void CompressWarpedTracks(FAnimSequenceTrackContainer& RawTracks, FVICompressedWarpedTrackContainer& OutCompressedTracks, const FString& DebugName)
+	{
+		OutCompressedTracks.Compress(RawTracks);
+
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+		if (!DebugName.IsEmpty())
+		{
+			float MaxTranslationError = 0.f;
+			float MaxRotationError = 0.f;
+			OutCompressedTracks.MeasureError(RawTracks, MaxTranslationError, MaxRotationError);
+
+			UE_LOG(LogVIMotionWarping, Log, TEXT("VIMotionWarping: Compressed warped tracks. Animation: %s Max error: %fcm %fdeg. Size: %d -> %d bytes"),
+				*DebugName, MaxTranslationError, MaxRotationError,
+				(int32)FVICompressedWarpedTrackContainer::GetAllocatedSize(RawTracks), (int32)OutCompressedTracks.GetAllocatedSize());
+		}
+#endif
+
+		// The full precision tracks are what we are saving
+		RawTracks.AnimationTracks.Reset();
+		RawTracks.TrackNames.Reset();
+	}
+}
+
+void FVIWarpedTracksMemoryTracker::Update(SIZE_T NewSize)
+{
+#if STATS
+	if (NewSize != Size)
+	{
+		if (Size == 0)
+		{
+			INC_DWORD_STAT(STAT_VIMotionWarping_WarpedTrackSets);
+		}
+		else if (NewSize == 0)
+		{
+			DEC_DWORD_STAT(STAT_VIMotionWarping_WarpedTrackSets);
+		}
+
+		DEC_MEMORY_STAT_BY(STAT_VIMotionWarping_WarpedTracksMemory, Size);
+		INC_MEMORY_STAT_BY(STAT_VIMotionWarping_WarpedTracksMemory, NewSize);
+	}
+#endif
+
+	Size = NewSize;
+}
+
+// FVIMotionDeltaTrackContainer
+///////////////////////////////////////////////////////////////
+
+void FVIMotionDeltaTrackContainer::CopyBone(int32 BoneIdx, const FVIMotionDeltaTrackContainer& Other, int32 OtherBoneIdx)
+{
+	check(NumFrames == Other.NumFrames);
+
+	// Channels of a bone are contiguous
+	FMemory::Memcpy(GetBase(BoneIdx, 0), Other.GetBase(OtherBoneIdx, 0), NumChannels * NumFrames * sizeof(float));
+	FMemory::Memcpy(GetWeights(BoneIdx, 0), Other.GetWeights(OtherBoneIdx, 0), NumChannels * NumFrames * sizeof(float));
+}
+
+void FVIMotionDeltaTrackContainer::ApplyAdditive(const float* RESTRICT InBase, const float* RESTRICT InWeights, float Additive, float* RESTRICT Out, int32 Num)
+{
+	const VectorRegister4Float AdditiveReg = VectorSetFloat1(Additive);
+
+	int32 Idx = 0;
+	for (; Idx + 4 <= Num; Idx += 4)
+	{
+		VectorStore(VectorMultiplyAdd(VectorLoad(InWeights + Idx), AdditiveReg, VectorLoad(InBase + Idx)), Out + Idx);
+	}
+
+	for (; Idx < Num; Idx++)
+	{
+		Out[Idx] = InBase[Idx] + Additive * InWeights[Idx];
+	}
+}
+
+// FVIAdjustmentBlendWarpParams
+///////////////////////////////////////////////////////////////
+
+bool FVIAdjustmentBlendWarpParams::Identical(const FVIAdjustmentBlendWarpParams& Other) const
+{
+	return Animation == Other.Animation && BoneContainerAsset == Other.BoneContainerAsset && BakedConfig == Other.BakedConfig
+		&& RequiredBoneIndexArray == Other.RequiredBoneIndexArray && IKBones == Other.IKBones
+		&& CachedMeshTransform.Equals(Other.CachedMeshTransform, 0.f) && CachedVIRootMotion.Equals(Other.CachedVIRootMotion, 0.f)
+		&& SyncPointLocation == Other.SyncPointLocation && OriginalRotation == Other.OriginalRotation && TargetRotation == Other.TargetRotation
+		&& StartTime == Other.StartTime && EndTime == Other.EndTime
+		&& bWarpTranslation == Other.bWarpTranslation && bIgnoreZAxis == Other.bIgnoreZAxis && bWarpRotation == Other.bWarpRotation && bWarpIKBones == Other.bWarpIKBones;
+}
+
+// FVIRootMotionModifier_AdjustmentBlendWarp
+///////////////////////////////////////////////////////////////
+
+struct FVIAdjustmentBlendWarpTask
+{
+	FVIAdjustmentBlendWarpParams Params;
+
+	/** Compress the tracks on the worker once built, Result is then empty */
+	bool bCompress = false;
+
+	/** Name compression errors are logged under, empty to skip measuring them */
+	FString CompressionDebugName;
+
+	/** Only read once bComplete is set */
+	FAnimSequenceTrackContainer Result;
+	FVICompressedWarpedTrackContainer CompressedResult;
+
+	std::atomic<bool> bComplete { false };
+};
+
+FVIRootMotionModifier_AdjustmentBlendWarp::FVIRootMotionModifier_AdjustmentBlendWarp()
+{
+	bInLocalSpace = true; 
+}
+
+void FVIRootMotionModifier_AdjustmentBlendWarp::ExtractBoneTransformAtTime(FTransform& OutTransform, int32 TrackIndex, float Time) const
+{
+	const float TrackLength = (EndTime - ActualStartTime);
+	const float TimePercent = (Time - ActualStartTime) / (EndTime - ActualStartTime);
+	const float RemappedTime = TimePercent * TrackLength;
+
+	if (CompressedResult.Tracks.IsValidIndex(TrackIndex))
+	{
+		CompressedResult.Tracks[TrackIndex].ExtractTransform(RemappedTime, TrackLength, OutTransform);
+		return;
+	}
+
+	if (!Result.AnimationTracks.IsValidIndex(TrackIndex))
+	{
+		OutTransform = FTransform::Identity;
+		return;
+	}
+
+	const int32 TotalFrames = FMath::Max(Result.AnimationTracks[TrackIndex].PosKeys.Num(), Result.AnimationTracks[TrackIndex].RotKeys.Num());
+	FVIAnimationUtils::ExtractTransformFromTrack(RemappedTime, TotalFrames, TrackLength, Result.AnimationTracks[TrackIndex], EAnimInterpolationType::Linear, OutTransform);
+}
+
+void FVIRootMotionModifier_AdjustmentBlendWarp::ExtractBoneTransformAtFrame(FTransform& OutTransform, int32 TrackIndex, int32 Frame) const
+{
+	if (CompressedResult.Tracks.IsValidIndex(TrackIndex) && Frame >= 0 && Frame < CompressedResult.Tracks[TrackIndex].NumFrames)
+	{
+		CompressedResult.Tracks[TrackIndex].ExtractTransformForFrame(Frame, OutTransform);
+		return;
+	}
+
+	if (!Result.AnimationTracks.IsValidIndex(TrackIndex) || !Result.AnimationTracks[TrackIndex].PosKeys.IsValidIndex(Frame))
+	{
+		OutTransform = FTransform::Identity;
+		return;
+	}
+
+	FVIAnimationUtils::ExtractTransformForFrameFromTrack(Result.AnimationTracks[TrackIndex], Frame, OutTransform);
+}
+
+int32 FVIRootMotionModifier_AdjustmentBlendWarp::GetNumWarpedFrames(int32 TrackIndex) const
+{
+	if (CompressedResult.GetNum() > 0)
+	{
+		return CompressedResult.Tracks.IsValidIndex(TrackIndex) ? CompressedResult.Tracks[TrackIndex].NumFrames : 0;
+	}
+
+	return Result.AnimationTracks.IsValidIndex(TrackIndex) ? Result.AnimationTracks[TrackIndex].PosKeys.Num() : 0;
+}
+
+void FVIRootMotionModifier_AdjustmentBlendWarp::OnWarpedTracksBuilt()
+{
+	WarpedTracksSyncPoint = CachedSyncPoint;
+	PreparedStartRootPosition = -1.f;
+
+	// Tracks built on a worker arrive compressed already
+	if (CVarVIMotionWarpingCompressWarpedTracks.GetValueOnGameThread() > 0 && Result.GetNum() > 0)
+	{
+		VIWarpedTrackCompression::CompressWarpedTracks(Result, CompressedResult, GetCompressionDebugName());
+	}
+
+	WarpedTracksMemory.Update(FVICompressedWarpedTrackContainer::GetAllocatedSize(Result) + CompressedResult.GetAllocatedSize());
+
+	CacheIKBoneTrackIndices();
+}
+
+FString FVIRootMotionModifier_AdjustmentBlendWarp::GetCompressionDebugName() const
+{
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+	if (FVIMotionWarpingCVars::CVarVIMotionWarpingDebug.GetValueOnGameThread() > 0)
+	{
+		return FString::Printf(TEXT("%s [%f %f]"), *GetNameSafe(Animation.Get()), ActualStartTime, EndTime);
+	}
+#endif
+
+	return FString();
+}
+
+void FVIRootMotionModifier_AdjustmentBlendWarp::ResetWarpedTracks()
+{
+	Result.AnimationTracks.Reset();
+	Result.TrackNames.Reset();
+	CompressedResult.Reset();
+	IKBoneTrackIndices.Reset();
+	WarpedTracksMemory.Update(0);
+}
+
+void FVIRootMotionModifier_AdjustmentBlendWarp::OnSyncPointChanged(UVIMotionWarpingComponent& OwnerComp)
+{
+	PreparedStartRootPosition = -1.f;
+
+	if (RewarpRemainingTracks())
+	{
+		return;
+	}
+
+	const ACharacter* CharacterOwner = OwnerComp.GetCharacterOwner();
+	const USkeletalMeshComponent* SkelMeshComp = CharacterOwner->GetMesh();
+
+	ActualStartTime = PreviousPosition;
+	CachedVIRootMotion = GetVIRootMotionTotal();
+	CachedMeshRelativeTransform = SkelMeshComp->GetRelativeTransform();
+	CachedMeshTransform = SkelMeshComp->GetComponentTransform();
+
+	ResetWarpedTracks();
+
+	// Anything in flight was built for the previous sync point
+	PendingTask.Reset();
+}
+
+void FVIRootMotionModifier_AdjustmentBlendWarp::ResetModifier()
+{
+	FVIRootMotionModifier_Warp::ResetModifier();
+
+	ActualStartTime = 0.f;
+	CachedMeshTransform = FTransform::Identity;
+	CachedMeshRelativeTransform = FTransform::Identity;
+	CachedVIRootMotion = FTransform::Identity;
+	AsyncBlendInAlpha = 1.f;
+	PreparedStartRootPosition = -1.f;
+	PendingTask.Reset();
+	Config.Reset();
+	WarpedTracksSyncPoint = FVIMotionWarpingSyncPoint();
+	bPrepareTracks = false;
+	bHasPreparedTracks = false;
+
+	// Keep the track allocations for the next window
+	ResetWarpedTracks();
+}
+
+FTransform FVIRootMotionModifier_AdjustmentBlendWarp::ProcessVIRootMotion(UVIMotionWarpingComponent& OwnerComp, const FTransform& InVIRootMotion, float DeltaSeconds)
+{
+	// If warped tracks has not been generated yet, do it now
+	if (!HasWarpedTracks())
+	{
+		// When and how much simple warping blends in depends on the machine, only allowed where nothing replays or validates the root motion
+		if (ShouldPrecomputeAsync(OwnerComp))
+		{
+			if (!PendingTask.IsValid())
+			{
+				PrecomputeWarpedTracksAsync(OwnerComp);
+			}
+
+			// Simple warp until the warped tracks are ready, then blend them in
+			if (!ConsumePendingTask())
+			{
+				AsyncBlendInAlpha = 0.f;
+				return FVIRootMotionModifier_Warp::ProcessVIRootMotion(OwnerComp, InVIRootMotion, DeltaSeconds);
+			}
+		}
+		else
+		{
+			PrecomputeWarpedTracks(OwnerComp);
+		}
+	}
+
+	// Extract root motion from warped tracks
+	const FTransform WarpedVIRootMotion = ExtractWarpedVIRootMotion();
+
+	FTransform FinalVIRootMotion = WarpedVIRootMotion;
+	if (AsyncBlendInAlpha < 1.f)
+	{
+		const FTransform SimpleVIRootMotion = FVIRootMotionModifier_Warp::ProcessVIRootMotion(OwnerComp, InVIRootMotion, DeltaSeconds);
+
+		AsyncBlendInAlpha = AsyncBlendInTime > 0.f ? FMath::Min(AsyncBlendInAlpha + DeltaSeconds / AsyncBlendInTime, 1.f) : 1.f;
+		FinalVIRootMotion.Blend(SimpleVIRootMotion, WarpedVIRootMotion, AsyncBlendInAlpha);
+	}
+
+	// Debug
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+	if (FVIMotionWarpingCVars::CVarVIMotionWarpingDebug.GetValueOnGameThread() > 0)
+	{
+		PrintLog(OwnerComp, TEXT("FVIRootMotionModifier_AdjustmentBlend"), InVIRootMotion, FinalVIRootMotion);
+
+		if(FVIMotionWarpingCVars::CVarVIMotionWarpingDebug.GetValueOnGameThread() >= 2)
+		{
+			const float DrawDebugDuration = FVIMotionWarpingCVars::CVarVIMotionWarpingDrawDebugDuration.GetValueOnGameThread();
+			DrawDebugWarpedTracks(OwnerComp, DrawDebugDuration);
+		}
+	}
+#endif
+
+	return FinalVIRootMotion;
+}
+
+bool FVIRootMotionModifier_AdjustmentBlendWarp::IsRootMotionNetRelevant(const UVIMotionWarpingComponent& OwnerComp)
+{
+	// Server, autonomous proxies and their saved move replays all have to compute the same root motion for a move
+	const ACharacter* CharacterOwner = OwnerComp.GetCharacterOwner();
+	return CharacterOwner && CharacterOwner->GetNetMode() != NM_Standalone && CharacterOwner->GetLocalRole() != ROLE_SimulatedProxy;
+}
+
+bool FVIRootMotionModifier_AdjustmentBlendWarp::ShouldPrecomputeAsync(const UVIMotionWarpingComponent& OwnerComp) const
+{
+	// When and how much simple warping blends in depends on the machine, only allowed where nothing replays or validates the root motion
+	return bPrecomputeAsync && GetFixedStepSeconds() <= 0.f && !IsRootMotionNetRelevant(OwnerComp);
+}
+
+bool FVIRootMotionModifier_AdjustmentBlendWarp::GatherPrecomputeParams(UVIMotionWarpingComponent& OwnerComp, FVIAdjustmentBlendWarpParams& OutParams) const
+{
+	return GatherPrecomputeParams(OwnerComp, CachedSyncPoint, ActualStartTime, CachedVIRootMotion, CachedMeshTransform, CachedMeshRelativeTransform, OutParams);
+}
+
+bool FVIRootMotionModifier_AdjustmentBlendWarp::GatherPrecomputeParams(UVIMotionWarpingComponent& OwnerComp, const FVIMotionWarpingSyncPoint& SyncPoint, float InStartTime, const FTransform& VIRootMotionTotal, const FTransform& MeshTransform, const FTransform& MeshRelativeTransform, FVIAdjustmentBlendWarpParams& OutParams) const
+{
+	const ACharacter* CharacterOwner = OwnerComp.GetCharacterOwner();
+	const UAnimInstance* AnimInstance = CharacterOwner && CharacterOwner->GetMesh() ? CharacterOwner->GetMesh()->GetAnimInstance() : nullptr;
+	if (!AnimInstance || !Animation.IsValid())
+	{
+		return false;
+	}
+
+	const FBoneContainer& BoneContainer = AnimInstance->GetRequiredBones();
+
+	// Only the bones that we are interested in
+	OutParams.RequiredBoneIndexArray.Reset();
+	OutParams.RequiredBoneIndexArray.Add(0);
+
+	const bool bShouldWarpIKBones = bWarpIKBones && IKBones.Num() > 0;
+	if (bShouldWarpIKBones)
+	{
+		for (const FName& BoneName : IKBones)
+		{
+			const int32 BoneIndex = BoneContainer.GetPoseBoneIndexForBoneName(BoneName);
+			if(BoneIndex != INDEX_NONE)
+			{
+				OutParams.RequiredBoneIndexArray.Add(BoneIndex);
+			}
+		}
+
+		BoneContainer.GetReferenceSkeleton().EnsureParentsExistAndSort(OutParams.RequiredBoneIndexArray);
+	}
+
+	OutParams.Animation = Animation;
+	OutParams.BoneContainerAsset = BoneContainer.GetAsset();
+	OutParams.IKBones = IKBones;
+	OutParams.CachedMeshTransform = MeshTransform;
+	OutParams.CachedVIRootMotion = VIRootMotionTotal;
+	OutParams.SyncPointLocation = SyncPoint.GetLocation();
+	OutParams.StartTime = InStartTime;
+	OutParams.EndTime = EndTime;
+	OutParams.bWarpTranslation = bWarpTranslation;
+	OutParams.bIgnoreZAxis = bIgnoreZAxis;
+	OutParams.bWarpRotation = bWarpRotation;
+	OutParams.bWarpIKBones = bShouldWarpIKBones;
+
+	const bool bUseBakedTracks = CVarVIMotionWarpingBakedDeltaTracks.GetValueOnGameThread() > 0;
+	if (bUseBakedTracks && Config.IsValid() && Config->BakedMotionDeltaTracks.Matches(Animation.Get(), InStartTime, EndTime))
+	{
+		OutParams.BakedConfig = Config;
+	}
+
+	if (bWarpRotation)
+	{
+		OutParams.TargetRotation = GetTargetRotation(CharacterOwner->GetActorTransform(), SyncPoint);
+		OutParams.OriginalRotation = MeshRelativeTransform.GetRotation().Inverse() * (VIRootMotionTotal * MeshTransform).GetRotation();
+	}
+
+	return OutParams.BoneContainerAsset.IsValid();
+}
+
+void FVIRootMotionModifier_AdjustmentBlendWarp::PrecomputeWarpedTracks(UVIMotionWarpingComponent& OwnerComp)
+{
+	FVIAdjustmentBlendWarpParams Params;
+	if (GatherPrecomputeParams(OwnerComp, Params))
+	{
+		if (bHasPreparedTracks && PreparedTracksParams.Identical(Params))
+		{
+			INC_DWORD_STAT(STAT_VIMotionWarping_PreparedWarpedTracksUsed);
+
+			// Keeps the allocations of both for the next build
+			Swap(Result, PreparedTracks);
+		}
+		else
+		{
+			if (bHasPreparedTracks)
+			{
+				INC_DWORD_STAT(STAT_VIMotionWarping_PreparedWarpedTracksDiscarded);
+			}
 
-FVIRootMotionModifier_AdjustmentBlendWarp::FVIRootMotionModifier_AdjustmentBlendWarp()
-{
-	bInLocalSpace = true; 
-}
+			PrecomputeWarpedTracks(Params, Result);
+		}
 
-void FVIRootMotionModifier_AdjustmentBlendWarp::ExtractBoneTransformAtTime(FTransform& OutTransform, const FName& BoneName, float Time) const
-{
-	const int32 TrackIndex = Result.TrackNames.IndexOfByKey(BoneName);
-	ExtractBoneTransformAtTime(OutTransform, TrackIndex, Time);
+		bHasPreparedTracks = false;
+		OnWarpedTracksBuilt();
+	}
 }
 
-void FVIRootMotionModifier_AdjustmentBlendWarp::ExtractBoneTransformAtTime(FTransform& OutTransform, int32 TrackIndex, float Time) const
+void FVIRootMotionModifier_AdjustmentBlendWarp::PrecomputeWarpedTracksAsync(UVIMotionWarpingComponent& OwnerComp)
 {
-	if (!Result.AnimationTracks.IsValidIndex(TrackIndex))
+	TSharedPtr<FVIAdjustmentBlendWarpTask, ESPMode::ThreadSafe> Task = MakeShared<FVIAdjustmentBlendWarpTask, ESPMode::ThreadSafe>();
+	if (!GatherPrecomputeParams(OwnerComp, Task->Params))
 	{
-		OutTransform = FTransform::Identity;
 		return;
 	}
 
-	const int32 TotalFrames = FMath::Max(Result.AnimationTracks[TrackIndex].PosKeys.Num(), Result.AnimationTracks[TrackIndex].RotKeys.Num());
-	const float TrackLength = (EndTime - ActualStartTime);
-	const float TimePercent = (Time - ActualStartTime) / (EndTime - ActualStartTime);
-	const float RemappedTime = TimePercent * TrackLength;
-	FVIAnimationUtils::ExtractTransformFromTrack(RemappedTime, TotalFrames, TrackLength, Result.AnimationTracks[TrackIndex], EAnimInterpolationType::Linear, OutTransform);
+	Task->bCompress = CVarVIMotionWarpingCompressWarpedTracks.GetValueOnGameThread() > 0;
+	Task->CompressionDebugName = GetCompressionDebugName();
+
+	PendingTask = Task;
+
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [Task]()
+	{
+		SCOPE_CYCLE_COUNTER(STAT_VIMotionWarping_PrecomputeWarpedTracks);
+
+		FMemMark Mark(FMemStack::Get());
+
+		FVIAdjustmentBlendWarpInput Input;
+		bool bGathered = false;
+		{
+			// Animation and skeleton can't be collected while we read them, building from the copies doesn't need them
+			FGCScopeGuard GCGuard;
+			bGathered = FVIRootMotionModifier_AdjustmentBlendWarp::GatherWarpInput(Task->Params, Input);
+		}
+
+		if (bGathered)
+		{
+			FVIRootMotionModifier_AdjustmentBlendWarp::AdjustmentBlendWarp(Input, Task->Result);
+
+			if (Task->bCompress && Task->Result.GetNum() > 0)
+			{
+				VIWarpedTrackCompression::CompressWarpedTracks(Task->Result, Task->CompressedResult, Task->CompressionDebugName);
+			}
+		}
+
+		Task->bComplete = true;
+	});
 }
 
-void FVIRootMotionModifier_AdjustmentBlendWarp::ExtractBoneTransformAtFrame(FTransform& OutTransform, int32 TrackIndex, int32 Frame) const
+bool FVIRootMotionModifier_AdjustmentBlendWarp::ConsumePendingTask()
 {
-	if (!Result.AnimationTracks.IsValidIndex(TrackIndex) || !Result.AnimationTracks[TrackIndex].PosKeys.IsValidIndex(Frame))
+	if (!PendingTask.IsValid() || !PendingTask->bComplete)
 	{
-		OutTransform = FTransform::Identity;
-		return;
+		return false;
 	}
 
-	FVIAnimationUtils::ExtractTransformForFrameFromTrack(Result.AnimationTracks[TrackIndex], Frame, OutTransform);
+	// Task is done with it, no other references remain. Swapping keeps the tracks we had allocated around in the task rather than copying
+	Swap(Result, PendingTask->Result);
+	Swap(CompressedResult, PendingTask->CompressedResult);
+	PendingTask.Reset();
+
+	// Sync point changes reset the task, so it was built for the current one
+	OnWarpedTracksBuilt();
+	return true;
 }
 
-void FVIRootMotionModifier_AdjustmentBlendWarp::OnSyncPointChanged(UVIMotionWarpingComponent& OwnerComp)
+bool FVIRootMotionModifier_AdjustmentBlendWarp::RewarpRemainingTracks()
 {
-	const ACharacter* CharacterOwner = OwnerComp.GetCharacterOwner();
-	const USkeletalMeshComponent* SkelMeshComp = CharacterOwner->GetMesh();
+	// Nothing to patch yet, or a task is building tracks for the previous sync point
+	if (CVarVIMotionWarpingIncrementalRewarp.GetValueOnGameThread() == 0 || !HasWarpedTracks() || PendingTask.IsValid())
+	{
+		return false;
+	}
 
-	ActualStartTime = PreviousPosition;
-	CachedVIRootMotion = UVIMotionWarpingUtilities::ExtractVIRootMotionFromAnimation(Animation.Get(), ActualStartTime, EndTime);
-	CachedMeshRelativeTransform = SkelMeshComp->GetRelativeTransform();
-	CachedMeshTransform = SkelMeshComp->GetComponentTransform();
+	// A new target rotation changes the additive of every bone, that needs adjustment blending again
+	const float MaxAngle = FMath::DegreesToRadians(CVarVIMotionWarpingIncrementalRewarpMaxAngle.GetValueOnGameThread());
+	if (bWarpRotation && WarpedTracksSyncPoint.GetRotation().AngularDistance(CachedSyncPoint.GetRotation()) > MaxAngle)
+	{
+		return false;
+	}
 
-	Result.AnimationTracks.Reset();
-	Result.TrackNames.Reset();
-}
+	// Tracks are relative to the mesh when the window started
+	FVector Offset = FVector::ZeroVector;
+	if (bWarpTranslation)
+	{
+		Offset = CachedMeshTransform.InverseTransformVectorNoScale(CachedSyncPoint.GetLocation() - WarpedTracksSyncPoint.GetLocation());
+		if (bIgnoreZAxis)
+		{
+			Offset.Z = 0.f;
+		}
+	}
 
-FTransform FVIRootMotionModifier_AdjustmentBlendWarp::ProcessVIRootMotion(UVIMotionWarpingComponent& OwnerComp, const FTransform& InVIRootMotion, float DeltaSeconds)
-{
-	// If warped tracks has not been generated yet, do it now
-	if (Result.GetNum() == 0)
+	const float MaxDistance = CVarVIMotionWarpingIncrementalRewarpMaxDistance.GetValueOnGameThread();
+	if (Offset.SizeSquared() > FMath::Square(MaxDistance))
 	{
-		PrecomputeWarpedTracks(OwnerComp);
+		return false;
 	}
 
-	// Extract root motion from warped tracks
-	const FTransform FinalVIRootMotion = ExtractWarpedVIRootMotion();
+	SCOPE_CYCLE_COUNTER(STAT_VIMotionWarping_RewarpRemainingTracks);
 
-	// Debug
-#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
-	if (FVIMotionWarpingCVars::CVarVIMotionWarpingDebug.GetValueOnGameThread() > 0)
+	// Ramp the offset in over what's left of the window, what we already played is untouched
+	const float TrackLength = EndTime - ActualStartTime;
+	const float RemainingTime = EndTime - PreviousPosition;
+	if (!Offset.IsNearlyZero() && TrackLength > KINDA_SMALL_NUMBER && RemainingTime > KINDA_SMALL_NUMBER)
 	{
-		PrintLog(OwnerComp, TEXT("FVIRootMotionModifier_AdjustmentBlend"), InVIRootMotion, FinalVIRootMotion);
+		auto ShiftTrack = [this, &Offset, TrackLength](FRawAnimSequenceTrack& Track)
+		{
+			const int32 TotalFrames = Track.PosKeys.Num();
+			for (int32 FrameIdx = 1; FrameIdx < TotalFrames; FrameIdx++)
+			{
+				const float Time = ActualStartTime + TrackLength * FrameIdx / (TotalFrames - 1);
+				const float Alpha = FVIWarpMath::RemainingWindowAlpha(Time, PreviousPosition, EndTime);
+				Track.PosKeys[FrameIdx] += FVector3f(Offset * Alpha);
+			}
+		};
 
-		if(FVIMotionWarpingCVars::CVarVIMotionWarpingDebug.GetValueOnGameThread() >= 2)
+		if (CompressedResult.GetNum() > 0)
 		{
-			const float DrawDebugDuration = FVIMotionWarpingCVars::CVarVIMotionWarpingDrawDebugDuration.GetValueOnGameThread();
-			DrawDebugWarpedTracks(OwnerComp, DrawDebugDuration);
+			// Translation range changes with the offset, so requantize
+			FRawAnimSequenceTrack RawTrack;
+			for (FVICompressedWarpedTrack& Track : CompressedResult.Tracks)
+			{
+				if (Track.NumFrames > 1)
+				{
+					Track.Decompress(RawTrack);
+					ShiftTrack(RawTrack);
+					Track.Compress(RawTrack);
+				}
+			}
+		}
+		else
+		{
+			for (FRawAnimSequenceTrack& Track : Result.AnimationTracks)
+			{
+				ShiftTrack(Track);
+			}
 		}
 	}
-#endif
 
-	return FinalVIRootMotion;
+	// Keep the rotation the tracks were built for, so small rotations add up until they need a rebuild
+	WarpedTracksSyncPoint = FVIMotionWarpingSyncPoint(CachedSyncPoint.GetLocation(), WarpedTracksSyncPoint.GetRotation());
+	return true;
 }
 
-void FVIRootMotionModifier_AdjustmentBlendWarp::PrecomputeWarpedTracks(UVIMotionWarpingComponent& OwnerComp)
+void FVIRootMotionModifier_AdjustmentBlendWarp::CacheIKBoneTrackIndices()
 {
-	SCOPE_CYCLE_COUNTER(STAT_VIMotionWarping_PrecomputeWarpedTracks);
-
-	// First, extract pose at the end of the window for the bones we are going to warp
-
-	const ACharacter* CharacterOwner = OwnerComp.GetCharacterOwner();
-	const FBoneContainer& BoneContainer = CharacterOwner->GetMesh()->GetAnimInstance()->GetRequiredBones();
+	IKBoneTrackIndices.Reset();
 
-	// Init FBoneContainer with only the bones that we are interested in
-	TArray<FBoneIndexType> RequiredBoneIndexArray;
-	RequiredBoneIndexArray.Add(0);
-
-	const bool bShouldWarpIKBones = bWarpIKBones && IKBones.Num() > 0;
-	if (bShouldWarpIKBones)
+	if (bWarpIKBones)
 	{
 		for (const FName& BoneName : IKBones)
 		{
-			const int32 BoneIndex = BoneContainer.GetPoseBoneIndexForBoneName(BoneName);
-			if(BoneIndex != INDEX_NONE)
+			const int32 TrackIndex = GetWarpedTrackNames().IndexOfByKey(BoneName);
+			if (TrackIndex != INDEX_NONE)
 			{
-				RequiredBoneIndexArray.Add(BoneIndex);
+				IKBoneTrackIndices.Add(BoneName, TrackIndex);
 			}
 		}
+	}
+}
+
+void FVIRootMotionModifier_AdjustmentBlendWarp::PrecomputeWarpedTracks(const FVIAdjustmentBlendWarpParams& Params, FAnimSequenceTrackContainer& Output)
+{
+	SCOPE_CYCLE_COUNTER(STAT_VIMotionWarping_PrecomputeWarpedTracks);
+
+	FVIAdjustmentBlendWarpInput Input;
+	if (GatherWarpInput(Params, Input))
+	{
+		AdjustmentBlendWarp(Input, Output);
+	}
+}
 
-		BoneContainer.GetReferenceSkeleton().EnsureParentsExistAndSort(RequiredBoneIndexArray);
+bool FVIRootMotionModifier_AdjustmentBlendWarp::GatherWarpInput(const FVIAdjustmentBlendWarpParams& Params, FVIAdjustmentBlendWarpInput& OutInput)
+{
+	const UAnimSequenceBase* Anim = Params.Animation.Get();
+	UObject* BoneContainerAsset = Params.BoneContainerAsset.Get();
+	if (!Anim || !BoneContainerAsset)
+	{
+		return false;
 	}
 
+	// First, extract pose at the end of the window for the bones we are going to warp
+
 	// Init BoneContainer
-	FBoneContainer RequiredBones(RequiredBoneIndexArray, FCurveEvaluationOption(false), *BoneContainer.GetAsset());
+	FBoneContainer RequiredBones(Params.RequiredBoneIndexArray, FCurveEvaluationOption(false), *BoneContainerAsset);
 
 	// Extract pose
 	FCSPose<FCompactPose> CSPose;
-	UVIMotionWarpingUtilities::ExtractComponentSpacePose(Animation.Get(), RequiredBones, EndTime, true, CSPose);
+	UVIMotionWarpingUtilities::ExtractComponentSpacePose(Anim, RequiredBones, Params.EndTime, true, CSPose);
 
 	// Second, calculate additive pose
 
 	//Calculate additive translation for root bone
-	FVector RootTargetLocation = CachedMeshTransform.InverseTransformPositionNoScale(CachedSyncPoint.GetLocation());
+	FVector RootTargetLocation = Params.CachedMeshTransform.InverseTransformPositionNoScale(Params.SyncPointLocation);
 
 	FVector RootTotalAdditiveTranslation = FVector::ZeroVector;
-	if (bWarpTranslation)
+	if (Params.bWarpTranslation)
 	{
-		RootTotalAdditiveTranslation = RootTargetLocation - CachedVIRootMotion.GetLocation();
+		RootTotalAdditiveTranslation = RootTargetLocation - Params.CachedVIRootMotion.GetLocation();
 
-		if (bIgnoreZAxis)
+		if (Params.bIgnoreZAxis)
 		{
 			RootTotalAdditiveTranslation.Z = 0.f;
 		}
@@ -146,11 +948,9 @@ void FVIRootMotionModifier_AdjustmentBlendWarp::PrecomputeWarpedTracks(UVIMotion
 
 	// Calculate additive rotation for root bone
 	FQuat RootTotalAdditiveRotation = FQuat::Identity;
-	if (bWarpRotation)
+	if (Params.bWarpRotation)
 	{
-		const FQuat TargetRotation = GetTargetRotation(OwnerComp);
-		const FQuat OriginalRotation = CachedMeshRelativeTransform.GetRotation().Inverse() * (CachedVIRootMotion * CachedMeshTransform).GetRotation();
-		RootTotalAdditiveRotation = FQuat::FindBetweenNormals(OriginalRotation.GetForwardVector(), TargetRotation.GetForwardVector());
+		RootTotalAdditiveRotation = FQuat::FindBetweenNormals(Params.OriginalRotation.GetForwardVector(), Params.TargetRotation.GetForwardVector());
 	}
 
 	// Init Additive Pose
@@ -159,19 +959,19 @@ void FVIRootMotionModifier_AdjustmentBlendWarp::PrecomputeWarpedTracks(UVIMotion
 	AdditivePose.SetComponentSpaceTransform(FCompactPoseBoneIndex(0), FTransform(RootTotalAdditiveRotation, RootTotalAdditiveTranslation));
 
 	// Calculate and add additive pose for IK bones
-	if (bShouldWarpIKBones)
+	if (Params.bWarpIKBones)
 	{
-		const FTransform RootTargetPoseCS = FTransform((RootTotalAdditiveRotation * CachedVIRootMotion.GetRotation()), CachedVIRootMotion.GetTranslation() + RootTotalAdditiveTranslation);
+		const FTransform RootTargetPoseCS = FTransform((RootTotalAdditiveRotation * Params.CachedVIRootMotion.GetRotation()), Params.CachedVIRootMotion.GetTranslation() + RootTotalAdditiveTranslation);
 		for (int32 Idx = 1; Idx < CSPose.GetPose().GetNumBones(); Idx++)
 		{
 			const FName BoneName = RequiredBones.GetReferenceSkeleton().GetBoneName(RequiredBones.GetBoneIndicesArray()[Idx]);
-			if (IKBones.Contains(BoneName))
+			if (Params.IKBones.Contains(BoneName))
 			{
 				const int32 BoneIdx = Idx;
 				const FTransform BonePoseCS = CSPose.GetComponentSpaceTransform(FCompactPoseBoneIndex(BoneIdx));
 
 				const FTransform BoneTargetPoseCS = BonePoseCS * RootTargetPoseCS;
-				const FTransform BoneOriginalPoseCS = BonePoseCS * CachedVIRootMotion;
+				const FTransform BoneOriginalPoseCS = BonePoseCS * Params.CachedVIRootMotion;
 
 				const FVector TotalAdditiveTranslation = BoneTargetPoseCS.GetLocation() - BoneOriginalPoseCS.GetLocation();
 
@@ -180,14 +980,25 @@ void FVIRootMotionModifier_AdjustmentBlendWarp::PrecomputeWarpedTracks(UVIMotion
 		}
 	}
 
-	// Finally, run adjustment blending to generate the warped poses for each bone
+	// Copy out what adjustment blending needs, so the warped poses for each bone can be generated without the skeleton
+	const int32 TotalBones = RequiredBones.GetCompactPoseNumBones();
+	OutInput.BoneNames.SetNumUninitialized(TotalBones);
+	OutInput.AdditivePose.SetNumUninitialized(TotalBones);
+	for (const FCompactPoseBoneIndex PoseBoneIndex : AdditivePose.GetPose().ForEachBoneIndex())
+	{
+		const int32 BoneIndex = PoseBoneIndex.GetInt();
+		OutInput.BoneNames[BoneIndex] = RequiredBones.GetReferenceSkeleton().GetBoneName(RequiredBones.GetBoneIndicesArray()[BoneIndex]);
+		OutInput.AdditivePose[BoneIndex] = AdditivePose.GetPose()[PoseBoneIndex];
+	}
 
-	//@todo_fer: We could extract and cache this offline when the WarpingWindow is created
-	const float SampleRate = 1 / 60.f;
-	FVIMotionDeltaTrackContainer MotionDeltaTracks;
-	FVIRootMotionModifier_AdjustmentBlendWarp::ExtractMotionDeltaFromRange(RequiredBones, Animation.Get(), ActualStartTime, EndTime, SampleRate, MotionDeltaTracks);
+	// Use the tracks baked with the animation, only sample them if the window started late or the bones weren't baked
+	const UVIRootMotionModifierConfig_AdjustmentBlendWarp* BakedConfig = Params.BakedConfig.Get();
+	if (!BakedConfig || !BakedConfig->BakedMotionDeltaTracks.CopyTo(RequiredBones, OutInput.MotionDeltaTracks))
+	{
+		FVIRootMotionModifier_AdjustmentBlendWarp::ExtractMotionDeltaFromRange(RequiredBones, Anim, Params.StartTime, Params.EndTime, MotionDeltaSampleRate, OutInput.MotionDeltaTracks);
+	}
 
-	FVIRootMotionModifier_AdjustmentBlendWarp::AdjustmentBlendWarp(RequiredBones, AdditivePose, MotionDeltaTracks, Result);
+	return true;
 }
 
 void FVIRootMotionModifier_AdjustmentBlendWarp::ExtractMotionDeltaFromRange(const FBoneContainer& BoneContainer, const UAnimSequenceBase* Animation, float StartTime, float EndTime, float SampleRate, FVIMotionDeltaTrackContainer& OutMotionDeltaTracks)
@@ -196,143 +1007,182 @@ void FVIRootMotionModifier_AdjustmentBlendWarp::ExtractMotionDeltaFromRange(cons
 
 	check(Animation);
 
-	const int32 TotalFrames = FMath::CeilToInt((EndTime - StartTime) / SampleRate) + 1;
+	constexpr int32 NumChannels = FVIMotionDeltaTrackContainer::NumChannels;
+
+	const int32 TotalFrames = FMath::Max(FMath::CeilToInt((EndTime - StartTime) / SampleRate - KINDA_SMALL_NUMBER), 0) + 1;
 	const int32 TotalBones = BoneContainer.GetCompactPoseNumBones();
 
+	OutMotionDeltaTracks.Init(TotalBones, TotalFrames);
+
 	FCompactPose FirstFramePose;
 	UVIMotionWarpingUtilities::ExtractLocalSpacePose(Animation, BoneContainer, StartTime, false, FirstFramePose);
 	const FTransform RootTransformFirstFrame = FirstFramePose[FCompactPoseBoneIndex(0)];
 
+	// Sample the channels of every bone
 	FCSPose<FCompactPose> CSPose;
-	UVIMotionWarpingUtilities::ExtractComponentSpacePose(Animation, BoneContainer, StartTime, false, CSPose);
-
-	OutMotionDeltaTracks.Init(TotalBones);
-	for (int32 BoneIdx = 0; BoneIdx < TotalBones; BoneIdx++)
-	{
-		const FTransform& BoneTransform = (CSPose.GetComponentSpaceTransform(FCompactPoseBoneIndex(BoneIdx)).GetRelativeTransform(RootTransformFirstFrame));
-
-		FVIMotionDeltaTrack& NewTrack = OutMotionDeltaTracks.Tracks.AddDefaulted_GetRef();
-
-		NewTrack.BoneTransformTrack.Reserve(TotalFrames);
-		NewTrack.DeltaTranslationTrack.Reserve(TotalFrames);
-		NewTrack.DeltaRotationTrack.Reserve(TotalFrames);
-
-		NewTrack.BoneTransformTrack.Add(BoneTransform);
-		NewTrack.DeltaTranslationTrack.Add(FVector::ZeroVector);
-		NewTrack.DeltaRotationTrack.Add(FRotator::ZeroRotator);
-
-		NewTrack.TotalTranslation = FVector::ZeroVector;
-		NewTrack.TotalRotation = FRotator::ZeroRotator;
-	}
-
-	float Time = StartTime;
-	while (Time < EndTime)
+	for (int32 FrameIdx = 0; FrameIdx < TotalFrames; FrameIdx++)
 	{
-		Time += FMath::Min(SampleRate, EndTime - Time);
-
+		const float Time = FMath::Min(StartTime + FrameIdx * SampleRate, EndTime);
 		UVIMotionWarpingUtilities::ExtractComponentSpacePose(Animation, BoneContainer, Time, false, CSPose);
 
 		for (int32 BoneIdx = 0; BoneIdx < TotalBones; BoneIdx++)
 		{
-			FVIMotionDeltaTrack& Track = OutMotionDeltaTracks.Tracks[BoneIdx];
-
-			const FTransform& BoneTransform = (CSPose.GetComponentSpaceTransform(FCompactPoseBoneIndex(BoneIdx)).GetRelativeTransform(RootTransformFirstFrame));
-
-			const FTransform& LastBoneTransform = Track.BoneTransformTrack.Last();
-
-			Track.BoneTransformTrack.Add(BoneTransform);
-
+			const FTransform BoneTransform = CSPose.GetComponentSpaceTransform(FCompactPoseBoneIndex(BoneIdx)).GetRelativeTransform(RootTransformFirstFrame);
 			const FVector Translation = BoneTransform.GetTranslation();
-			const FVector LastTranslation = LastBoneTransform.GetTranslation();
-			const FVector DeltaTranslation(FMath::Abs(Translation.X - LastTranslation.X), FMath::Abs(Translation.Y - LastTranslation.Y), FMath::Abs(Translation.Z - LastTranslation.Z));
-			Track.DeltaTranslationTrack.Add(DeltaTranslation);
-			Track.TotalTranslation = Track.TotalTranslation + DeltaTranslation;
+			const FVector Rotation = BoneTransform.GetRotation().Rotator().Euler();
 
-			const FRotator Rotation = BoneTransform.GetRotation().Rotator();
-			const FRotator LastRotation = LastBoneTransform.GetRotation().Rotator();
-			const FRotator DeltaRotation(FMath::Abs(Rotation.Pitch - LastRotation.Pitch), FMath::Abs(Rotation.Yaw - LastRotation.Yaw), FMath::Abs(Rotation.Roll - LastRotation.Roll));
-			Track.DeltaRotationTrack.Add(DeltaRotation);
-			Track.TotalRotation = Track.TotalRotation + DeltaRotation;
+			for (int32 Channel = 0; Channel < 3; Channel++)
+			{
+				OutMotionDeltaTracks.GetBase(BoneIdx, Channel)[FrameIdx] = Translation[Channel];
+				OutMotionDeltaTracks.GetBase(BoneIdx, Channel + 3)[FrameIdx] = Rotation[Channel];
+			}
 		}
 	}
-}
 
-void FVIRootMotionModifier_AdjustmentBlendWarp::AdjustmentBlendWarp(const FBoneContainer& BoneContainer, const FCSPose<FCompactPose>& AdditivePose, const FVIMotionDeltaTrackContainer& MotionDeltaTracks, FAnimSequenceTrackContainer& Output)
-{
-	auto CalculateAdditive = [](const FVector& Total, const FVector& Delta, const FVector& Additive, const FVector& PreviousAdditive, float Alpha)
+	// Each frame gets the share of the additive matching its share of the channel's total motion
+	for (int32 BoneIdx = 0; BoneIdx < TotalBones; BoneIdx++)
 	{
-		FVector CurrentAdditive = FVector::ZeroVector;
-		for (int32 Idx = 0; Idx < 3; Idx++)
+		for (int32 Channel = 0; Channel < NumChannels; Channel++)
 		{
-			if (!FMath::IsNearlyZero(Total[Idx], (FVector::FReal)1.f))
-			{
-				const FVector::FReal Percent = Delta[Idx] / Total[Idx];
-				const FVector::FReal AdditiveDelta = FMath::Abs(Additive[Idx]) * Percent;
-				CurrentAdditive[Idx] = (Additive[Idx] > 0.f) ? PreviousAdditive[Idx] + AdditiveDelta : PreviousAdditive[Idx] - AdditiveDelta;
-			}
-			else
-			{
-				CurrentAdditive[Idx] = Additive[Idx] * Alpha;
-			}
+			FVIWarpMath::ComputeAdjustmentBlendWeights(OutMotionDeltaTracks.GetBase(BoneIdx, Channel), OutMotionDeltaTracks.GetWeights(BoneIdx, Channel), TotalFrames);
 		}
-		return CurrentAdditive;
-	};
+	}
+}
 
-	Output.Initialize(BoneContainer.GetCompactPoseNumBones());
+void FVIRootMotionModifier_AdjustmentBlendWarp::AdjustmentBlendWarp(const FVIAdjustmentBlendWarpInput& Input, FAnimSequenceTrackContainer& Output)
+{
+	constexpr int32 NumChannels = FVIMotionDeltaTrackContainer::NumChannels;
 
-	for (const FCompactPoseBoneIndex PoseBoneIndex : AdditivePose.GetPose().ForEachBoneIndex())
+	const FVIMotionDeltaTrackContainer& MotionDeltaTracks = Input.MotionDeltaTracks;
+
+	Output.Initialize(Input.BoneNames.Num());
+
+	const int32 TotalFrames = MotionDeltaTracks.NumFrames;
+
+	// Warped channels of the bone being processed, [Channel][Frame]
+	TArray<float, TInlineAllocator<FVIMotionDeltaTrackContainer::NumChannels * 64>> Warped;
+	Warped.SetNumUninitialized(NumChannels * TotalFrames);
+
+	for (int32 BoneIndex = 0; BoneIndex < Input.AdditivePose.Num(); BoneIndex++)
 	{
-		const FTransform& AdditiveTransform = AdditivePose.GetPose()[PoseBoneIndex];
+		const FTransform& AdditiveTransform = Input.AdditivePose[BoneIndex];
 		if (AdditiveTransform.Equals(FTransform::Identity))
 		{
 			continue;
 		}
 
-		const int32 BoneIndex = PoseBoneIndex.GetInt();
-		const FVIMotionDeltaTrack& MotionDeltaTrack = MotionDeltaTracks.Tracks[BoneIndex];
-		const int32 TotalFrames = MotionDeltaTrack.BoneTransformTrack.Num();
-
-		FRawAnimSequenceTrack& Track = Output.AnimationTracks[BoneIndex];
+		if (BoneIndex >= MotionDeltaTracks.NumBones)
+		{
+			continue;
+		}
 
-		Track.PosKeys.Reserve(TotalFrames);
-		Track.RotKeys.Reserve(TotalFrames);
+		const FVector TotalAdditiveTranslation = AdditiveTransform.GetTranslation();
+		const FVector TotalAdditiveRotation = AdditiveTransform.GetRotation().Rotator().Euler();
 
-		Track.PosKeys.Add(FVector3f(MotionDeltaTrack.BoneTransformTrack[0].GetLocation()));
-		Track.RotKeys.Add(FQuat4f(MotionDeltaTrack.BoneTransformTrack[0].GetRotation()));
+		for (int32 Channel = 0; Channel < 3; Channel++)
+		{
+			FVIMotionDeltaTrackContainer::ApplyAdditive(MotionDeltaTracks.GetBase(BoneIndex, Channel), MotionDeltaTracks.GetWeights(BoneIndex, Channel), TotalAdditiveTranslation[Channel], Warped.GetData() + Channel * TotalFrames, TotalFrames);
+			FVIMotionDeltaTrackContainer::ApplyAdditive(MotionDeltaTracks.GetBase(BoneIndex, Channel + 3), MotionDeltaTracks.GetWeights(BoneIndex, Channel + 3), TotalAdditiveRotation[Channel], Warped.GetData() + (Channel + 3) * TotalFrames, TotalFrames);
+		}
 
+		FRawAnimSequenceTrack& Track = Output.AnimationTracks[BoneIndex];
+		Track.PosKeys.SetNumUninitialized(TotalFrames);
+		Track.RotKeys.SetNumUninitialized(TotalFrames);
 		Track.ScaleKeys.Add(FVector3f(1));
 
-		Output.TrackNames[BoneIndex] = BoneContainer.GetReferenceSkeleton().GetBoneName(BoneContainer.GetBoneIndicesArray()[BoneIndex]);
-
-		const FVector TotalAdditiveTranslation = AdditiveTransform.GetTranslation();
-		const FVector TotalAdditiveRotation = AdditiveTransform.GetRotation().Rotator().Euler();
+		Output.TrackNames[BoneIndex] = Input.BoneNames[BoneIndex];
 
-		FVector PrevAdditiveTranslation = FVector::ZeroVector;
-		FVector PrevAdditiveRotation = FVector::ZeroVector;
-		for (int32 FrameIdx = 1; FrameIdx < TotalFrames; FrameIdx++)
+		const float* TX = Warped.GetData();
+		const float* TY = TX + TotalFrames;
+		const float* TZ = TY + TotalFrames;
+		const float* RX = TZ + TotalFrames;
+		const float* RY = RX + TotalFrames;
+		const float* RZ = RY + TotalFrames;
+		for (int32 FrameIdx = 0; FrameIdx < TotalFrames; FrameIdx++)
 		{
-			const FTransform& BoneTransform = MotionDeltaTrack.BoneTransformTrack[FrameIdx];
-			const float Alpha = (FrameIdx / (float)(TotalFrames - 1));
+			Track.PosKeys[FrameIdx] = FVector3f(TX[FrameIdx], TY[FrameIdx], TZ[FrameIdx]);
+			Track.RotKeys[FrameIdx] = FQuat4f(FRotator3f::MakeFromEuler(FVector3f(RX[FrameIdx], RY[FrameIdx], RZ[FrameIdx])).Quaternion());
+		}
+	}
+}
+
+void FVIRootMotionModifier_AdjustmentBlendWarp::GatherVIRootMotionPrepareInputs(UVIMotionWarpingComponent& OwnerComp, const FVIRootMotionPrepareParams& Params)
+{
+	bPrepareTracks = false;
+	bHasPreparedTracks = false;
 
-			// Translation Key
-			const FVector DeltaTranslation = MotionDeltaTrack.DeltaTranslationTrack[FrameIdx];
-			const FVector CurrentAdditiveTranslation = CalculateAdditive(MotionDeltaTrack.TotalTranslation, DeltaTranslation, TotalAdditiveTranslation, PrevAdditiveTranslation, Alpha);
-			Output.AnimationTracks[BoneIndex].PosKeys.Add(FVector3f(BoneTransform.GetTranslation() + CurrentAdditiveTranslation));
-			PrevAdditiveTranslation = CurrentAdditiveTranslation;
+	// Only tracks movement would build on the game thread this frame
+	if (HasWarpedTracks() || PendingTask.IsValid() || ShouldPrecomputeAsync(OwnerComp))
+	{
+		return;
+	}
 
-			// Rotation Key
-			const FVector DeltaRotation = MotionDeltaTrack.DeltaRotationTrack[FrameIdx].Euler();
-			const FVector CurrentAdditiveRotation = CalculateAdditive(MotionDeltaTrack.TotalRotation.Euler(), DeltaRotation, TotalAdditiveRotation, PrevAdditiveRotation, Alpha);
-			Output.AnimationTracks[BoneIndex].RotKeys.Add(FQuat4f(FRotator::MakeFromEuler(BoneTransform.GetRotation().Rotator().Euler() + CurrentAdditiveRotation).Quaternion()));
-			PrevAdditiveRotation = CurrentAdditiveRotation;
+	if (State == EVIRootMotionModifierState::Waiting)
+	{
+		// Update() starts the window if movement ticks from inside it, and OnSyncPointChanged() caches the sync point and mesh as they are now
+		const FVIMotionWarpingSyncPoint* SyncPoint = OwnerComp.FindSyncPoint(SyncPointName);
+		const USkeletalMeshComponent* SkelMeshComp = OwnerComp.GetCharacterOwner()->GetMesh();
+		if (!SyncPoint || !SkelMeshComp || Params.Position < StartTime || Params.Position >= EndTime)
+		{
+			return;
 		}
+
+		// Same root motion GetVIRootMotionTotal() returns once PrepareVIRootMotion() ran
+		const FTransform VIRootMotionTotal = Params.RootMotion ? Params.RootMotion->Extract(Params.Position, EndTime) : FVIMotionWarpingAnimCache::Get().ExtractRootMotion(Animation.Get(), Params.Position, EndTime);
+		bPrepareTracks = GatherPrecomputeParams(OwnerComp, *SyncPoint, Params.Position, VIRootMotionTotal, SkelMeshComp->GetComponentTransform(), SkelMeshComp->GetRelativeTransform(), PreparedTracksParams);
+	}
+	else if (bHasCachedSyncPoint)
+	{
+		// Tracks were reset by a sync point change but not built yet
+		bPrepareTracks = GatherPrecomputeParams(OwnerComp, PreparedTracksParams);
+	}
+}
+
+void FVIRootMotionModifier_AdjustmentBlendWarp::PrepareVIRootMotion(const FVIRootMotionPrepareParams& Params)
+{
+	FVIRootMotionModifier_Warp::PrepareVIRootMotion(Params);
+
+	// The prepass waits for us on the game thread, so nothing can collect the animation while we read it
+	if (bPrepareTracks)
+	{
+		FMemMark Mark(FMemStack::Get());
+		PreparedTracks.AnimationTracks.Reset();
+		PreparedTracks.TrackNames.Reset();
+		PrecomputeWarpedTracks(PreparedTracksParams, PreparedTracks);
+		bPrepareTracks = false;
+		bHasPreparedTracks = true;
+	}
+
+	// Tracks only change on the game thread, during Update() or once built
+	if (HasWarpedTracks())
+	{
+		ExtractBoneTransformAtTime(PreparedStartRootTransform, 0, Params.Position);
+		PreparedStartRootPosition = Params.Position;
 	}
+	else
+	{
+		PreparedStartRootPosition = -1.f;
+	}
+}
+
+bool FVIRootMotionModifier_AdjustmentBlendWarp::NeedsPreparedWarpStep() const
+{
+	// Simple warping only runs while the warped tracks are built async and blended in
+	const bool bSimpleWarping = HasWarpedTracks() ? AsyncBlendInAlpha < 1.f : PendingTask.IsValid();
+	return bSimpleWarping && FVIRootMotionModifier_Warp::NeedsPreparedWarpStep();
 }
 
 FTransform FVIRootMotionModifier_AdjustmentBlendWarp::ExtractWarpedVIRootMotion() const
 {
 	FTransform StartRootTransform;
-	ExtractBoneTransformAtTime(StartRootTransform, 0, PreviousPosition);
+	if (PreparedStartRootPosition >= 0.f && PreparedStartRootPosition == PreviousPosition)
+	{
+		StartRootTransform = PreparedStartRootTransform;
+	}
+	else
+	{
+		ExtractBoneTransformAtTime(StartRootTransform, 0, PreviousPosition);
+	}
 
 	FTransform EndRootTransform;
 	ExtractBoneTransformAtTime(EndRootTransform, 0, CurrentPosition);
@@ -344,17 +1194,17 @@ FTransform FVIRootMotionModifier_AdjustmentBlendWarp::ExtractWarpedVIRootMotion(
 void FVIRootMotionModifier_AdjustmentBlendWarp::DrawDebugWarpedTracks(UVIMotionWarpingComponent& OwnerComp, float DrawDuration) const
 {
 	const UWorld* World = OwnerComp.GetWorld();
-	if (World && Result.GetNum() > 0 && PreviousPosition <= EndTime)
+	if (World && HasWarpedTracks() && PreviousPosition <= EndTime)
 	{
 		FTransform RootStartTransform;
 		ExtractBoneTransformAtFrame(RootStartTransform, 0, 0);
 
-		for (int32 TrackIndex = 0; TrackIndex < Result.GetNum(); TrackIndex++)
+		for (int32 TrackIndex = 0; TrackIndex < GetNumWarpedTracks(); TrackIndex++)
 		{
-			const int32 TotalFrames = Result.AnimationTracks[TrackIndex].PosKeys.Num();
+			const int32 TotalFrames = GetNumWarpedFrames(TrackIndex);
 			if (TotalFrames > 1)
 			{
-				for (int32 FrameIdx = 0; FrameIdx < Result.AnimationTracks[TrackIndex].PosKeys.Num() - 1; FrameIdx++)
+				for (int32 FrameIdx = 0; FrameIdx < TotalFrames - 1; FrameIdx++)
 				{
 					FTransform StartTransform;
 					ExtractBoneTransformAtFrame(StartTransform, TrackIndex, FrameIdx);
@@ -380,7 +1230,8 @@ void FVIRootMotionModifier_AdjustmentBlendWarp::DrawDebugWarpedTracks(UVIMotionW
 
 void FVIRootMotionModifier_AdjustmentBlendWarp::GetIKBoneTransformAndAlpha(FName BoneName, FTransform& OutTransform, float& OutAlpha) const
 {
-	if (Result.GetNum() == 0 || !bWarpIKBones || !IKBones.Contains(BoneName))
+	const int32* TrackIndex = IKBoneTrackIndices.Find(BoneName);
+	if (!TrackIndex)
 	{
 		OutTransform = FTransform::Identity;
 		OutAlpha = 0.f;
@@ -391,46 +1242,58 @@ void FVIRootMotionModifier_AdjustmentBlendWarp::GetIKBoneTransformAndAlpha(FName
 	ExtractBoneTransformAtTime(RootPrevPosition, 0, 0.f);
 
 	FTransform BoneTransform;
-	ExtractBoneTransformAtTime(BoneTransform, BoneName, PreviousPosition);
+	ExtractBoneTransformAtTime(BoneTransform, *TrackIndex, PreviousPosition);
 
 	OutTransform = BoneTransform * RootPrevPosition.Inverse() * CachedMeshTransform;
 	OutAlpha = Weight;
 }
 
 void UVIRootMotionModifierConfig_AdjustmentBlendWarp::GetIKBoneTransformAndAlpha(ACharacter* Character, FName BoneName, FTransform& OutTransform, float& OutAlpha)
+{
+	GetIKBoneTransformAndAlphaFromHandle(MakeIKHandle(Character), BoneName, OutTransform, OutAlpha);
+}
+
+FVIAdjustmentBlendWarpIKHandle UVIRootMotionModifierConfig_AdjustmentBlendWarp::MakeIKHandle(ACharacter* Character)
+{
+	FVIAdjustmentBlendWarpIKHandle Handle;
+	Handle.VIMotionWarpingComp = Character ? Character->FindComponentByClass<UVIMotionWarpingComponent>() : nullptr;
+	return Handle;
+}
+
+void UVIRootMotionModifierConfig_AdjustmentBlendWarp::GetIKBoneTransformAndAlphaFromHandle(const FVIAdjustmentBlendWarpIKHandle& Handle, FName BoneName, FTransform& OutTransform, float& OutAlpha)
 {
 	OutTransform = FTransform::Identity;
 	OutAlpha = 0.f;
 
-	const UVIMotionWarpingComponent* VIMotionWarpingComp = Character ? Character->FindComponentByClass<UVIMotionWarpingComponent>() : nullptr;
-	if (VIMotionWarpingComp)
+	const UVIMotionWarpingComponent* VIMotionWarpingComp = Handle.VIMotionWarpingComp.Get();
+	if (const FVIRootMotionModifier_AdjustmentBlendWarp* Modifier = VIMotionWarpingComp ? VIMotionWarpingComp->GetIKWarpModifier() : nullptr)
 	{
-		for (const auto& Modifier : VIMotionWarpingComp->GetVIRootMotionModifiers())
-		{
-			if (Modifier.IsValid() && Modifier->State == EVIRootMotionModifierState::Active && Modifier->GetScriptStruct()->IsChildOf(FVIRootMotionModifier_AdjustmentBlendWarp::StaticStruct()))
-			{
-				// We must check if the Animation for the modifier is still relevant because in VIRootMotionFromMontageOnlyMode the montage could be aborted 
-				// but the modifier will remain in the list until the next update
-				const FAnimMontageInstance* VIRootMotionMontageInstance = Character->GetRootMotionAnimMontageInstance();
-				const UAnimMontage* Montage = VIRootMotionMontageInstance ? VIRootMotionMontageInstance->Montage : nullptr;
-				if (Modifier->Animation == Montage)
-				{
-					static_cast<const FVIRootMotionModifier_AdjustmentBlendWarp*>(Modifier.Get())->GetIKBoneTransformAndAlpha(BoneName, OutTransform, OutAlpha);
-					break;
-				}
-			}
-		}
+		Modifier->GetIKBoneTransformAndAlpha(BoneName, OutTransform, OutAlpha);
 	}
 }
 
 // UVIRootMotionModifierConfig_AdjustmentBlendWarp
 ///////////////////////////////////////////////////////////////
 
-void UVIRootMotionModifierConfig_AdjustmentBlendWarp::AddVIRootMotionModifierAdjustmentBlendWarp(UVIMotionWarpingComponent* InVIMotionWarpingComp, const UAnimSequenceBase* InAnimation, float InStartTime, float InEndTime, FName InSyncPointName, bool bInWarpTranslation, bool bInIgnoreZAxis, bool bInWarpRotation, bool bInWarpIKBones, const TArray<FName>& InIKBones)
+void UVIRootMotionModifierConfig_AdjustmentBlendWarp::AddVIRootMotionModifier(UVIMotionWarpingComponent* VIMotionWarpingComp, const UAnimSequenceBase* Animation, float StartTime, float EndTime) const
+{
+	TSharedPtr<FVIRootMotionModifier_AdjustmentBlendWarp> NewModifier = MakeVIRootMotionModifierAdjustmentBlendWarp(VIMotionWarpingComp, Animation, StartTime, EndTime, SyncPointName, bWarpTranslation, bIgnoreZAxis, bWarpRotation, bWarpIKBones, IKBones, bPrecomputeAsync, AsyncBlendInTime);
+	if (NewModifier.IsValid())
+	{
+		NewModifier->Config = this;
+	}
+}
+
+void UVIRootMotionModifierConfig_AdjustmentBlendWarp::AddVIRootMotionModifierAdjustmentBlendWarp(UVIMotionWarpingComponent* InVIMotionWarpingComp, const UAnimSequenceBase* InAnimation, float InStartTime, float InEndTime, FName InSyncPointName, bool bInWarpTranslation, bool bInIgnoreZAxis, bool bInWarpRotation, bool bInWarpIKBones, const TArray<FName>& InIKBones, bool bInPrecomputeAsync, float InAsyncBlendInTime)
+{
+	MakeVIRootMotionModifierAdjustmentBlendWarp(InVIMotionWarpingComp, InAnimation, InStartTime, InEndTime, InSyncPointName, bInWarpTranslation, bInIgnoreZAxis, bInWarpRotation, bInWarpIKBones, InIKBones, bInPrecomputeAsync, InAsyncBlendInTime);
+}
+
+TSharedPtr<FVIRootMotionModifier_AdjustmentBlendWarp> UVIRootMotionModifierConfig_AdjustmentBlendWarp::MakeVIRootMotionModifierAdjustmentBlendWarp(UVIMotionWarpingComponent* InVIMotionWarpingComp, const UAnimSequenceBase* InAnimation, float InStartTime, float InEndTime, FName InSyncPointName, bool bInWarpTranslation, bool bInIgnoreZAxis, bool bInWarpRotation, bool bInWarpIKBones, const TArray<FName>& InIKBones, bool bInPrecomputeAsync, float InAsyncBlendInTime)
 {
 	if (ensureAlways(InVIMotionWarpingComp))
 	{
-		TSharedPtr<FVIRootMotionModifier_AdjustmentBlendWarp> NewModifier = MakeShared<FVIRootMotionModifier_AdjustmentBlendWarp>();
+		TSharedPtr<FVIRootMotionModifier_AdjustmentBlendWarp> NewModifier = InVIMotionWarpingComp->AcquireVIRootMotionModifier<FVIRootMotionModifier_AdjustmentBlendWarp>();
 		NewModifier->Animation = InAnimation;
 		NewModifier->StartTime = InStartTime;
 		NewModifier->EndTime = InEndTime;
@@ -439,7 +1302,81 @@ void UVIRootMotionModifierConfig_AdjustmentBlendWarp::AddVIRootMotionModifierAdj
 		NewModifier->bIgnoreZAxis = bInIgnoreZAxis;
 		NewModifier->bWarpRotation = bInWarpRotation;
 		NewModifier->bWarpIKBones = bInWarpIKBones;
-		NewModifier->IKBones = InIKBones;
+		NewModifier->IKBones.Reset();
+		NewModifier->IKBones.Append(InIKBones);
+		NewModifier->bPrecomputeAsync = bInPrecomputeAsync;
+		NewModifier->AsyncBlendInTime = InAsyncBlendInTime;
 		InVIMotionWarpingComp->AddVIRootMotionModifier(NewModifier);
+		return NewModifier;
+	}
+
+	return nullptr;
+}
+
+bool UVIRootMotionModifierConfig_AdjustmentBlendWarp::SampleMotionDeltaTracks(FVIBakedMotionDeltaTracks& OutBakedTracks) const
+{
+	OutBakedTracks = FVIBakedMotionDeltaTracks();
+
+	// Config is instanced on the notify, which is owned by the animation
+	const UVIAnimNotifyState_MotionWarping* Notify = Cast<UVIAnimNotifyState_MotionWarping>(GetOuter());
+	const UAnimSequenceBase* Animation = GetTypedOuter<UAnimSequenceBase>();
+	USkeleton* Skeleton = Animation ? Animation->GetSkeleton() : nullptr;
+	if (!Notify || !Skeleton)
+	{
+		return false;
 	}
-}
\ No newline at end of file
+
+	const FAnimNotifyEvent* NotifyEvent = Animation->Notifies.FindByPredicate([Notify](const FAnimNotifyEvent& Event) { return Event.NotifyStateClass == Notify; });
+	if (!NotifyEvent)
+	{
+		return false;
+	}
+
+	const FReferenceSkeleton& RefSkeleton = Skeleton->GetReferenceSkeleton();
+
+	// Same bones the modifier warps, by name so they can be matched to any mesh
+	TArray<FBoneIndexType> RequiredBoneIndexArray;
+	RequiredBoneIndexArray.Add(0);
+
+	if (bWarpIKBones)
+	{
+		for (const FName& BoneName : IKBones)
+		{
+			const int32 BoneIndex = RefSkeleton.FindBoneIndex(BoneName);
+			if (BoneIndex != INDEX_NONE)
+			{
+				RequiredBoneIndexArray.Add(BoneIndex);
+			}
+		}
+
+		RefSkeleton.EnsureParentsExistAndSort(RequiredBoneIndexArray);
+	}
+
+	FBoneContainer BoneContainer(RequiredBoneIndexArray, FCurveEvaluationOption(false), *Skeleton);
+
+	OutBakedTracks.Animation = Animation;
+	OutBakedTracks.StartTime = FMath::Clamp(NotifyEvent->GetTriggerTime(), 0.f, Animation->GetPlayLength());
+	OutBakedTracks.EndTime = FMath::Clamp(NotifyEvent->GetEndTriggerTime(), 0.f, Animation->GetPlayLength());
+
+	FVIRootMotionModifier_AdjustmentBlendWarp::ExtractMotionDeltaFromRange(BoneContainer, Animation, OutBakedTracks.StartTime, OutBakedTracks.EndTime, FVIRootMotionModifier_AdjustmentBlendWarp::MotionDeltaSampleRate, OutBakedTracks.Tracks);
+
+	for (int32 BoneIdx = 0; BoneIdx < BoneContainer.GetCompactPoseNumBones(); BoneIdx++)
+	{
+		OutBakedTracks.BoneNames.Add(RefSkeleton.GetBoneName(BoneContainer.GetBoneIndicesArray()[BoneIdx]));
+	}
+
+	return OutBakedTracks.IsValid();
+}
+
+#if WITH_EDITOR
+void UVIRootMotionModifierConfig_AdjustmentBlendWarp::PreSave(FObjectPreSaveContext SaveContext)
+{
+	Super::PreSave(SaveContext);
+
+	// Saved and cooked with the animation, windows moved since the last save are sampled at runtime until saved again
+	if (!HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject))
+	{
+		SampleMotionDeltaTracks(BakedMotionDeltaTracks);
+	}
+}
+#endif
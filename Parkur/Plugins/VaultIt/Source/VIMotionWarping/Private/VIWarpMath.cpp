@@ -0,0 +1,199 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "VIWarpMath.h"
+
+// FVIWarpMath
+///////////////////////////////////////////////////////////////
+
+float FVIWarpMath::ComputeDirectionForVector(const FVector& Vector, const FVector& Dir)
+{
+	const FVector VectorProject = Vector.ProjectOnTo(Dir);
+	const float SignDirection = FMath::Sign(VectorProject | Dir);
+
+	return VectorProject.Size() * SignDirection;
+}
+
+FVector FVIWarpMath::WarpTranslation(const FVector& RootMotionDelta, const FVector& RootMotionTotal, float HorizontalTarget, const FVector& Direction, float VerticalTarget, const FVector& Up, bool bIgnoreZAxis)
+{
+	const float HorizontalDelta = FVector::VectorPlaneProject(RootMotionDelta, Up).Size();
+	const float HorizontalOriginal = FVector::VectorPlaneProject(RootMotionTotal, Up).Size();
+	const float HorizontalTranslationWarped = ScaleToTarget(HorizontalDelta, HorizontalTarget, HorizontalOriginal);
+
+	FVector DeltaTranslation = Direction * HorizontalTranslationWarped;
+
+	if (!bIgnoreZAxis)
+	{
+		const float VerticalDelta = ComputeDirectionForVector(RootMotionDelta, Up);
+		const float VerticalOriginal = ComputeDirectionForVector(RootMotionTotal, Up);
+		const float VerticalTranslationWarped = ScaleToTarget(VerticalDelta, VerticalTarget, VerticalOriginal);
+
+		// Replace the vertical component
+		DeltaTranslation = FVector::VectorPlaneProject(DeltaTranslation, Up) + Up * VerticalTranslationWarped;
+	}
+
+	return DeltaTranslation;
+}
+
+FVector FVIWarpMath::SkewWarpTranslation(const FVector& RootMotionDelta, const FVector& CurrentLocation, const FQuat& CurrentRotation, const FVector& FutureLocation, const FVector& TargetLocation)
+{
+	const FVector CurrentToWorldOffset = TargetLocation - CurrentLocation;
+	const FVector CurrentToRootOffset = FutureLocation - CurrentLocation;
+
+	// Create a matrix we can use to put everything into a space looking straight at VIRootMotionSyncPosition. "forward" should be the axis along which we want to scale.
+	FVector ToRootNormalized = CurrentToRootOffset.GetSafeNormal();
+
+	float BestMatchDot = FMath::Abs(FVector::DotProduct(ToRootNormalized, CurrentRotation.GetAxisX()));
+	FMatrix ToRootSyncSpace = FRotationMatrix::MakeFromXZ(ToRootNormalized, CurrentRotation.GetAxisZ());
+
+	float ZDot = FMath::Abs(FVector::DotProduct(ToRootNormalized, CurrentRotation.GetAxisZ()));
+	if (ZDot > BestMatchDot)
+	{
+		ToRootSyncSpace = FRotationMatrix::MakeFromXZ(ToRootNormalized, CurrentRotation.GetAxisX());
+		BestMatchDot = ZDot;
+	}
+
+	float YDot = FMath::Abs(FVector::DotProduct(ToRootNormalized, CurrentRotation.GetAxisY()));
+	if (YDot > BestMatchDot)
+	{
+		ToRootSyncSpace = FRotationMatrix::MakeFromXZ(ToRootNormalized, CurrentRotation.GetAxisZ());
+	}
+
+	// Put everything into RootSyncSpace.
+	const FVector VIRootMotionInSyncSpace = ToRootSyncSpace.InverseTransformVector(RootMotionDelta);
+	const FVector CurrentToWorldSync = ToRootSyncSpace.InverseTransformVector(CurrentToWorldOffset);
+	const FVector CurrentToVIRootMotionSync = ToRootSyncSpace.InverseTransformVector(CurrentToRootOffset);
+
+	FVector CurrentToWorldSyncNorm = CurrentToWorldSync;
+	CurrentToWorldSyncNorm.Normalize();
+
+	FVector CurrentToVIRootMotionSyncNorm = CurrentToVIRootMotionSync;
+	CurrentToVIRootMotionSyncNorm.Normalize();
+
+	// Calculate skew Yaw Angle.
+	FVector FlatToWorld = FVector(CurrentToWorldSyncNorm.X, CurrentToWorldSyncNorm.Y, 0.0f);
+	FlatToWorld.Normalize();
+	FVector FlatToRoot = FVector(CurrentToVIRootMotionSyncNorm.X, CurrentToVIRootMotionSyncNorm.Y, 0.0f);
+	FlatToRoot.Normalize();
+	float AngleAboutZ = FMath::Acos(FVector::DotProduct(FlatToWorld, FlatToRoot));
+	float AngleAboutZNorm = FMath::DegreesToRadians(FRotator::NormalizeAxis(FMath::RadiansToDegrees(AngleAboutZ)));
+	if (FlatToWorld.Y < 0.0f)
+	{
+		AngleAboutZNorm *= -1.0f;
+	}
+
+	// Calculate Skew Pitch Angle.
+	FVector ToWorldNoY = FVector(CurrentToWorldSyncNorm.X, 0.0f, CurrentToWorldSyncNorm.Z);
+	ToWorldNoY.Normalize();
+	FVector ToRootNoY = FVector(CurrentToVIRootMotionSyncNorm.X, 0.0f, CurrentToVIRootMotionSyncNorm.Z);
+	ToRootNoY.Normalize();
+	const float AngleAboutY = FMath::Acos(FVector::DotProduct(ToWorldNoY, ToRootNoY));
+	float AngleAboutYNorm = FMath::DegreesToRadians(FRotator::NormalizeAxis(FMath::RadiansToDegrees(AngleAboutY)));
+	if (ToWorldNoY.Z < 0.0f)
+	{
+		AngleAboutYNorm *= -1.0f;
+	}
+
+	FVector SkewedVIRootMotion = FVector::ZeroVector;
+	float ProjectedScale = FVector::DotProduct(CurrentToWorldSync, CurrentToVIRootMotionSyncNorm) / CurrentToVIRootMotionSync.Size();
+	if (ProjectedScale != 0.0f)
+	{
+		FMatrix ScaleMatrix;
+		ScaleMatrix.SetIdentity();
+		ScaleMatrix.SetAxis(0, FVector(ProjectedScale, 0.0f, 0.0f));
+		ScaleMatrix.SetAxis(1, FVector(0.0f, 1.0f, 0.0f));
+		ScaleMatrix.SetAxis(2, FVector(0.0f, 0.0f, 1.0f));
+
+		FMatrix ShearXAlongYMatrix;
+		ShearXAlongYMatrix.SetIdentity();
+		ShearXAlongYMatrix.SetAxis(0, FVector(1.0f, FMath::Tan(AngleAboutZNorm), 0.0f));
+		ShearXAlongYMatrix.SetAxis(1, FVector(0.0f, 1.0f, 0.0f));
+		ShearXAlongYMatrix.SetAxis(2, FVector(0.0f, 0.0f, 1.0f));
+
+		FMatrix ShearXAlongZMatrix;
+		ShearXAlongZMatrix.SetIdentity();
+		ShearXAlongZMatrix.SetAxis(0, FVector(1.0f, 0.0f, FMath::Tan(AngleAboutYNorm)));
+		ShearXAlongZMatrix.SetAxis(1, FVector(0.0f, 1.0f, 0.0f));
+		ShearXAlongZMatrix.SetAxis(2, FVector(0.0f, 0.0f, 1.0f));
+
+		FMatrix ScaledSkewMatrix = ScaleMatrix * ShearXAlongYMatrix * ShearXAlongZMatrix;
+
+		// Skew and scale the Root motion.
+		SkewedVIRootMotion = ScaledSkewMatrix.TransformVector(VIRootMotionInSyncSpace);
+	}
+	else if (!CurrentToVIRootMotionSync.IsZero() && !CurrentToWorldSync.IsZero() && !VIRootMotionInSyncSpace.IsZero())
+	{
+		// Figure out ratio between remaining Root and remaining World. Then project scaled length of current Root onto World.
+		const float Scale = CurrentToWorldSync.Size() / CurrentToVIRootMotionSync.Size();
+		const float StepTowardTarget = VIRootMotionInSyncSpace.ProjectOnTo(VIRootMotionInSyncSpace).Size();
+		SkewedVIRootMotion = CurrentToWorldSyncNorm * (Scale * StepTowardTarget);
+	}
+
+	// Put our result back in world space.
+	return ToRootSyncSpace.TransformVector(SkewedVIRootMotion);
+}
+
+FQuat FVIWarpMath::WarpRotation(const FQuat& RootMotionDeltaRotation, const FQuat& RootMotionTotalRotation, const FQuat& CurrentRotation, const FQuat& TargetRotation, float TimeRemaining, float DeltaSeconds)
+{
+	const FQuat CurrentPlusRemainingVIRootMotion = RootMotionTotalRotation * CurrentRotation;
+	const float PercentThisStep = FMath::Clamp(DeltaSeconds / TimeRemaining, 0.f, 1.f);
+	const FQuat TargetRotThisFrame = FQuat::Slerp(CurrentPlusRemainingVIRootMotion, TargetRotation, PercentThisStep);
+	const FQuat DeltaOut = TargetRotThisFrame * CurrentPlusRemainingVIRootMotion.Inverse();
+
+	return (DeltaOut * RootMotionDeltaRotation);
+}
+
+FTransform FVIWarpMath::ConvertLocalRootMotionToWorld(const FTransform& LocalRootMotion, const FTransform& ActorTransform, const FTransform& MeshRelativeTransform)
+{
+	const FTransform MeshTransform = MeshRelativeTransform * ActorTransform;
+	const FTransform NewActorTransform = MeshRelativeTransform.Inverse() * LocalRootMotion * MeshTransform;
+
+	const FQuat MeshRotation = MeshTransform.GetRotation();
+	const FQuat DeltaWorldRotation = MeshRotation * LocalRootMotion.GetRotation() * MeshRotation.Inverse();
+
+	return FTransform(DeltaWorldRotation, NewActorTransform.GetTranslation() - ActorTransform.GetTranslation());
+}
+
+FTransform FVIWarpMath::ConvertWorldRootMotionToLocal(const FTransform& WorldRootMotion, const FTransform& ActorTransform, const FTransform& MeshRelativeTransform)
+{
+	const FTransform NewActorTransform(WorldRootMotion.GetRotation() * ActorTransform.GetRotation(), ActorTransform.GetTranslation() + WorldRootMotion.GetTranslation(), ActorTransform.GetScale3D());
+
+	return MeshRelativeTransform * NewActorTransform.GetRelativeTransform(ActorTransform) * MeshRelativeTransform.Inverse();
+}
+
+FQuat FVIWarpMath::FacingRotation(const FVector& Location, const FVector& TargetLocation)
+{
+	const FVector ToSyncPoint = (TargetLocation - Location).GetSafeNormal2D();
+	return FRotationMatrix::MakeFromXZ(ToSyncPoint, FVector::UpVector).ToQuat();
+}
+
+void FVIWarpMath::ComputeAdjustmentBlendWeights(const float* Values, float* OutWeights, int32 Num)
+{
+	if (Num <= 0)
+	{
+		return;
+	}
+
+	float Total = 0.f;
+	OutWeights[0] = 0.f;
+	for (int32 Idx = 1; Idx < Num; Idx++)
+	{
+		Total += FMath::Abs(Values[Idx] - Values[Idx - 1]);
+		OutWeights[Idx] = Total;
+	}
+
+	if (!FMath::IsNearlyZero(Total, 1.f))
+	{
+		const float InvTotal = 1.f / Total;
+		for (int32 Idx = 1; Idx < Num; Idx++)
+		{
+			OutWeights[Idx] *= InvTotal;
+		}
+	}
+	else
+	{
+		for (int32 Idx = 1; Idx < Num; Idx++)
+		{
+			OutWeights[Idx] = Idx / (float)(Num - 1);
+		}
+	}
+}
@@ -0,0 +1,134 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Algo/BinarySearch.h"
+#include "UObject/ObjectKey.h"
+
+class UAnimMontage;
+class UAnimSequenceBase;
+class UVIAnimNotifyState_MotionWarping;
+
+/** A warping window in montage time */
+struct VIMOTIONWARPING_API FVIMotionWarpingWindow
+{
+	const UVIAnimNotifyState_MotionWarping* Notify = nullptr;
+
+	/** Window used by the root motion modifier */
+	float StartTime = 0.f;
+	float EndTime = 0.f;
+
+	/** Montage positions that add the window, narrower than the window if it comes from an anim within the montage */
+	float ActiveStartTime = 0.f;
+	float ActiveEndTime = 0.f;
+};
+
+/** Warping windows of a montage sorted by ActiveStartTime */
+struct VIMOTIONWARPING_API FVIMotionWarpingWindowIndex
+{
+	TArray<FVIMotionWarpingWindow> Windows;
+
+	/** Longest active range, bounds how far back a lookup needs to search */
+	float MaxActiveLength = 0.f;
+
+	/** Calls Func for every window active at montage Position */
+	template<typename FuncType>
+	void ForEachWindowAt(float Position, FuncType&& Func) const
+	{
+		// First window starting after Position
+		const int32 UpperIdx = Algo::UpperBoundBy(Windows, Position, &FVIMotionWarpingWindow::ActiveStartTime);
+		for (int32 Idx = UpperIdx - 1; Idx >= 0 && Windows[Idx].ActiveStartTime >= Position - MaxActiveLength; Idx--)
+		{
+			const FVIMotionWarpingWindow& Window = Windows[Idx];
+			if (Position < Window.ActiveEndTime)
+			{
+				Func(Window);
+			}
+		}
+	}
+
+	void Build(const UAnimMontage* Montage, bool bSearchForWindowsInAnimsWithinMontages);
+};
+
+/**
+ * Root motion accumulated from the start of an animation, sampled at a fixed rate
+ * Root motion between any two positions is Evaluate(End).GetRelativeTransform(Evaluate(Start))
+ */
+struct VIMOTIONWARPING_API FVIRootMotionPrefixTrack
+{
+	/** Samples per second */
+	static constexpr float SampleRate = 60.f;
+
+	/** Root motion from 0 to each sample time, the last sample is at PlayLength */
+	TArray<FTransform> Samples;
+
+	float PlayLength = 0.f;
+
+	/** @return Root motion from 0 to Position, interpolated between samples */
+	FTransform Evaluate(float Position) const;
+
+	/** @return Root motion from StartPosition to EndPosition */
+	FTransform Extract(float StartPosition, float EndPosition) const
+	{
+		return Evaluate(EndPosition).GetRelativeTransform(Evaluate(StartPosition));
+	}
+
+	void Build(const UAnimSequenceBase* Animation);
+};
+
+/**
+ * Warping windows and root motion for each animation, built once on first use and shared by every UVIMotionWarpingComponent
+ * so the root motion tick does not walk and cast every notify of the montage or extract root motion from its tracks
+ *
+ * Game thread only. Entries are rebuilt in editor when an animation is modified
+ */
+class VIMOTIONWARPING_API FVIMotionWarpingAnimCache
+{
+public:
+	static FVIMotionWarpingAnimCache& Get();
+
+	/** @return Warping windows for the montage, built if not cached */
+	const FVIMotionWarpingWindowIndex& FindOrBuild(const UAnimMontage* Montage, bool bSearchForWindowsInAnimsWithinMontages);
+
+	/** @return Cumulative root motion for the animation, built if not cached. Only valid until the next FindOrBuild call */
+	const FVIRootMotionPrefixTrack& FindOrBuildRootMotion(const UAnimSequenceBase* Animation);
+
+	/**
+	 * Root motion between two positions of the animation
+	 * Interpolated from the cached prefix track rather than walking the animation's tracks, unless a.VIMotionWarping.RootMotionCache is 0
+	 */
+	FTransform ExtractRootMotion(const UAnimSequenceBase* Animation, float StartTime, float EndTime);
+
+	/** @return False if a.VIMotionWarping.RootMotionCache is 0 and root motion is extracted from the animation instead */
+	bool IsRootMotionCacheEnabled() const;
+
+	/** Remove all cached montages */
+	void Reset();
+
+	/** Called by the module */
+	void RegisterDelegates();
+	void UnregisterDelegates();
+
+protected:
+	struct FCacheEntry
+	{
+		TOptional<FVIMotionWarpingWindowIndex> MontageWindows;
+		TOptional<FVIMotionWarpingWindowIndex> AllWindows;
+		TOptional<FVIRootMotionPrefixTrack> RootMotion;
+	};
+
+	TMap<FObjectKey, FCacheEntry> Entries;
+
+	FDelegateHandle PostGarbageCollectHandle;
+
+	void OnPostGarbageCollect();
+
+#if WITH_EDITOR
+	FDelegateHandle ObjectModifiedHandle;
+	FDelegateHandle ObjectPropertyChangedHandle;
+
+	void OnObjectModified(UObject* Object);
+	void OnObjectPropertyChanged(UObject* Object, struct FPropertyChangedEvent& PropertyChangedEvent);
+#endif
+};
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "Kismet/KismetSystemLibrary.h"
+#include "UObject/ObjectKey.h"
 #include "VIRootMotionModifier.h"
 #include "VIMotionWarpingComponent.generated.h"
 
@@ -13,6 +14,7 @@ class UAnimSequenceBase;
 class UCharacterMovementComponent;
 class UVIMotionWarpingComponent;
 class UVIAnimNotifyState_MotionWarping;
+struct FVIRootMotionModifier_AdjustmentBlendWarp;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogVIMotionWarping, Log, All);
 
@@ -74,6 +76,36 @@ public:
 	static void GetVIMotionWarpingWindowsForSyncPointFromAnimation(const UAnimSequenceBase* Animation, FName SyncPointName, TArray<FVIMotionWarpingWindowData>& OutWindows);
 };
 
+/** Identifies the warping window a modifier was added for, times are quantized so lookups don't rely on exact float equality */
+struct FVIRootMotionModifierKey
+{
+	FObjectKey Animation;
+	int32 StartTime;
+	int32 EndTime;
+
+	/** Window times are quantized to this many steps per second */
+	static constexpr float TimeQuantization = 1000.f;
+
+	FVIRootMotionModifierKey(const UAnimSequenceBase* InAnimation, float InStartTime, float InEndTime)
+		: Animation(InAnimation)
+		, StartTime(FMath::RoundToInt(InStartTime * TimeQuantization))
+		, EndTime(FMath::RoundToInt(InEndTime * TimeQuantization))
+	{}
+
+	FORCEINLINE bool operator==(const FVIRootMotionModifierKey& Other) const
+	{
+		return Animation == Other.Animation && StartTime == Other.StartTime && EndTime == Other.EndTime;
+	}
+
+	friend FORCEINLINE uint32 GetTypeHash(const FVIRootMotionModifierKey& Key)
+	{
+		return HashCombine(GetTypeHash(Key.Animation), HashCombine(::GetTypeHash(Key.StartTime), ::GetTypeHash(Key.EndTime)));
+	}
+};
+
+/** Active modifiers, a vault rarely has more than a couple of windows so these live inline in the component */
+typedef TArray<TSharedPtr<FVIRootMotionModifier>, TInlineAllocator<4>> FVIRootMotionModifierArray;
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FVIMotionWarpingPreUpdate, class UVIMotionWarpingComponent*, VIMotionWarpingComp);
 
 UCLASS(ClassGroup = Movement, meta = (BlueprintSpawnableComponent))
@@ -99,7 +131,7 @@ public:
 	FORCEINLINE ACharacter* GetCharacterOwner() const { return CharacterOwner.Get(); }
 
 	/** Returns the list of root motion modifiers */
-	FORCEINLINE const TArray<TSharedPtr<FVIRootMotionModifier>>& GetVIRootMotionModifiers() const { return VIRootMotionModifiers; }
+	FORCEINLINE const FVIRootMotionModifierArray& GetVIRootMotionModifiers() const { return VIRootMotionModifiers; }
 
 	/** Find the SyncPoint associated with a specified name */
 	FORCEINLINE const FVIMotionWarpingSyncPoint* FindSyncPoint(const FName& SyncPointName) const { return SyncPoints.Find(SyncPointName); }
@@ -118,9 +150,32 @@ public:
 	/** Add a new modifier */
 	void AddVIRootMotionModifier(TSharedPtr<FVIRootMotionModifier> Modifier);
 
+	/**
+	 * Get a modifier to add, reusing one released by a previous warping window when possible
+	 * Runtime state is reset, the caller is expected to set the config
+	 */
+	template<typename ModifierType>
+	TSharedPtr<ModifierType> AcquireVIRootMotionModifier()
+	{
+		if (FVIRootMotionModifierArray* Pool = VIRootMotionModifierPool.Find(ModifierType::StaticStruct()))
+		{
+			if (Pool->Num() > 0)
+			{
+				TSharedPtr<ModifierType> Modifier = StaticCastSharedPtr<ModifierType>(Pool->Pop(false));
+				Modifier->ResetModifier();
+				return Modifier;
+			}
+		}
+
+		return MakeShared<ModifierType>();
+	}
+
 	/** Mark all the modifiers as Disable */
 	void DisableAllVIRootMotionModifiers();
 
+	/** @return The active adjustment blend warp providing IK bone transforms for the root motion montage, if any */
+	const FVIRootMotionModifier_AdjustmentBlendWarp* GetIKWarpModifier() const;
+
 protected:
 
 	/** Character this component belongs to */
@@ -128,7 +183,22 @@ protected:
 	TWeakObjectPtr<ACharacter> CharacterOwner;
 
 	/** List of root motion modifiers */
-	TArray<TSharedPtr<FVIRootMotionModifier>> VIRootMotionModifiers;
+	FVIRootMotionModifierArray VIRootMotionModifiers;
+
+	/** Windows we have a modifier for, avoids scanning VIRootMotionModifiers every tick */
+	TSet<FVIRootMotionModifierKey, DefaultKeyFuncs<FVIRootMotionModifierKey>, TInlineSetAllocator<4>> VIRootMotionModifierKeys;
+
+	/** Removed modifiers by type, reused by AcquireVIRootMotionModifier() */
+	TMap<UScriptStruct*, FVIRootMotionModifierArray> VIRootMotionModifierPool;
+
+	/** Releases modifiers marked for removal back to the pool */
+	void RemoveMarkedVIRootMotionModifiers();
+
+	/** Active adjustment blend warp for the root motion montage, owned by VIRootMotionModifiers */
+	const FVIRootMotionModifier_AdjustmentBlendWarp* IKWarpModifier = nullptr;
+
+	/** Modifier in charge of IK bones can only change when modifiers are added, updated or removed, so it is refreshed at each of those */
+	void CacheIKWarpModifier();
 
 	UPROPERTY(Transient)
 	TMap<FName, FVIMotionWarpingSyncPoint> SyncPoints;
@@ -0,0 +1,54 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "UObject/WeakObjectPtr.h"
+#include "VIRootMotionModifier.h"
+
+class UWorld;
+class UAnimSequenceBase;
+class UVIMotionWarpingComponent;
+
+/**
+ * World level pass over every UVIMotionWarpingComponent with warping windows, runs before actors tick
+ * Snapshots each character and predicts the step its movement takes this frame from the montage play rate, then evaluates
+ * the warp for that step (root motion left in the window, the warp step itself, the warped tracks of a window starting
+ * this frame, warped track samples) for all characters in parallel. Modifiers use the result when movement runs if it took
+ * that step from that state, and warp again otherwise
+ *
+ * Characters the server moves by their owning client's moves are skipped, their steps come from the client's deltas
+ *
+ * Game thread only, besides the modifiers' PrepareVIRootMotion
+ */
+class VIMOTIONWARPING_API FVIMotionWarpingPrepass
+{
+public:
+	static FVIMotionWarpingPrepass& Get();
+
+	/** Called by components when they gain modifiers, they are dropped once they have none left */
+	void AddComponent(UVIMotionWarpingComponent* Component);
+
+	/** Called by the module */
+	void RegisterDelegates();
+	void UnregisterDelegates();
+
+protected:
+	struct FPrepassItem
+	{
+		UVIMotionWarpingComponent* Component = nullptr;
+		FVIRootMotionModifier* Modifier = nullptr;
+		const UAnimSequenceBase* Animation = nullptr;
+		FVIRootMotionPrepareParams Params;
+	};
+
+	TArray<TWeakObjectPtr<UVIMotionWarpingComponent>> Components;
+
+	/** Reused every tick */
+	TArray<FPrepassItem> Items;
+
+	FDelegateHandle WorldPreActorTickHandle;
+
+	void OnWorldPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+};
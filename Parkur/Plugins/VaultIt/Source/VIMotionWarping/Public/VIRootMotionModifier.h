@@ -4,9 +4,12 @@
 
 #include "CoreMinimal.h"
 #include "Animation/AnimSequence.h"
+#include "Templates/Function.h"
 #include "VIRootMotionModifier.generated.h"
 
+class ACharacter;
 class UVIMotionWarpingComponent;
+struct FVIRootMotionPrefixTrack;
 
 /** The possible states of a Root Motion Modifier */
 UENUM(BlueprintType)
@@ -25,6 +28,45 @@ enum class EVIRootMotionModifierState : uint8
 	Disabled
 };
 
+/** Everything warping needs from the character, the state a warp step starts from */
+struct VIMOTIONWARPING_API FVIWarpCharacterState
+{
+	FTransform ActorTransform;
+
+	/** Mesh relative to the actor, from the live mesh component transform */
+	FTransform MeshRelativeTransform;
+
+	float CapsuleHalfHeight = 0.f;
+
+	FVIWarpCharacterState() {}
+	explicit FVIWarpCharacterState(const ACharacter& Character);
+
+	/** @return True if exactly the same, a warp step from either state gives the same result */
+	bool Identical(const FVIWarpCharacterState& Other) const
+	{
+		return CapsuleHalfHeight == Other.CapsuleHalfHeight && ActorTransform.Equals(Other.ActorTransform, 0.f) && MeshRelativeTransform.Equals(Other.MeshRelativeTransform, 0.f);
+	}
+};
+
+/** What FVIMotionWarpingPrepass gathers on the game thread for a modifier before preparing it on a worker */
+struct VIMOTIONWARPING_API FVIRootMotionPrepareParams
+{
+	/** Cached root motion of the animation, null if the root motion cache is disabled */
+	const FVIRootMotionPrefixTrack* RootMotion = nullptr;
+
+	/** Animation position movement ticks from this frame */
+	float Position = 0.f;
+
+	/** Animation position movement is expected to tick to, from the montage play rate and DeltaSeconds */
+	float NextPosition = 0.f;
+
+	/** Time step movement is expected to tick the character by */
+	float DeltaSeconds = 0.f;
+
+	/** Snapshot of the character before movement ticks */
+	FVIWarpCharacterState State;
+};
+
 /** Base struct for Root Motion Modifiers */
 USTRUCT()
 struct VIMOTIONWARPING_API FVIRootMotionModifier
@@ -74,8 +116,20 @@ public:
 	/** Updates the state of the modifier. Runs before ProcessVIRootMotion */
 	virtual void Update(UVIMotionWarpingComponent& OwnerComp);
 
+	/** Clears runtime state so a pooled modifier can be reused for another window, keeps allocations */
+	virtual void ResetModifier();
+
 	/** Performs the actual modification to the motion */
 	virtual FTransform ProcessVIRootMotion(UVIMotionWarpingComponent& OwnerComp, const FTransform& InVIRootMotion, float DeltaSeconds) PURE_VIRTUAL(FVIRootMotionModifier::ProcessVIRootMotion, return FTransform::Identity;);
+
+	/** Reads anything else PrepareVIRootMotion needs, called on the game thread by FVIMotionWarpingPrepass right before preparing */
+	virtual void GatherVIRootMotionPrepareInputs(UVIMotionWarpingComponent& OwnerComp, const FVIRootMotionPrepareParams& Params) {}
+
+	/**
+	 * Evaluates ahead of movement what ProcessVIRootMotion needs for the step movement is expected to take this frame
+	 * Called on a worker by FVIMotionWarpingPrepass, must not touch anything besides this modifier
+	 */
+	virtual void PrepareVIRootMotion(const FVIRootMotionPrepareParams& Params) {}
 };
 
 /** Blueprint wrapper around the config properties of a root motion modifier */
@@ -144,6 +198,33 @@ enum class EVIMotionWarpRotationType : uint8
 	Facing,
 };
 
+/**
+ * Warped actor trajectory over what's left of a window, stepped at a fixed rate from a start state
+ * Frames sample it by montage position, so the root motion of a window doesn't depend on the frame rate it plays at
+ */
+struct VIMOTIONWARPING_API FVIFixedStepWarpTrack
+{
+	/** Montage position of each sample, ascending */
+	TArray<float> Positions;
+
+	/** Actor transform at each position */
+	TArray<FTransform> Samples;
+
+	bool IsEmpty() const { return Samples.Num() == 0; }
+
+	void Reset()
+	{
+		Positions.Reset();
+		Samples.Reset();
+	}
+
+	/** @return Actor transform at Position, interpolated between samples */
+	FTransform Evaluate(float Position) const;
+
+	/** @return True if ActorTransform is further than the tolerances (cm, degrees) from the track at Position */
+	bool HasDrifted(float Position, const FTransform& ActorTransform, float LocationTolerance, float RotationTolerance) const;
+};
+
 USTRUCT()
 struct VIMOTIONWARPING_API FVIRootMotionModifier_Warp : public FVIRootMotionModifier
 {
@@ -189,19 +270,91 @@ public:
 	virtual UScriptStruct* GetScriptStruct() const override { return FVIRootMotionModifier_Warp::StaticStruct(); }
 	virtual void Update(UVIMotionWarpingComponent& OwnerComp) override;
 	virtual FTransform ProcessVIRootMotion(UVIMotionWarpingComponent& OwnerComp, const FTransform& InVIRootMotion, float DeltaSeconds) override;
+	virtual void PrepareVIRootMotion(const FVIRootMotionPrepareParams& Params) override;
 	//~ End FVIRootMotionModifier Interface
 
 	/** Event called during update if the sync point changes while the warping is active */
 	virtual void OnSyncPointChanged(UVIMotionWarpingComponent& OwnerComp) {}
 
+	virtual void ResetModifier() override;
+
+	/** @return Seconds per warp step when warping on a fixed timestep, 0 if the warp is evaluated every frame. See a.VIMotionWarping.FixedStepRate, which is config only */
+	static float GetFixedStepSeconds();
+
+	/**
+	 * Steps the warp from StartState at StartPosition to the end of the window, moving the character by the warped root motion of each step
+	 * Steps are aligned to StartTime so peers share them even if they start at different positions
+	 * @param ExtractRootMotion		Root motion of Animation between two positions
+	 */
+	void BuildFixedStepTrack(const FVIWarpCharacterState& StartState, float StartPosition, float StepSeconds, TFunctionRef<FTransform(float, float)> ExtractRootMotion);
+
+	/** @return Root motion from PreviousPosition to CurrentPosition on the fixed step track, in the space this modifier runs in */
+	FTransform ExtractFixedStepRootMotion(const FVIWarpCharacterState& State) const;
+
 #if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
 	void PrintLog(const UVIMotionWarpingComponent& OwnerComp, const FString& Name, const FTransform& OriginalVIRootMotion, const FTransform& WarpedVIRootMotion) const;
 #endif
 
 protected:
 
-	FQuat GetTargetRotation(UVIMotionWarpingComponent& OwnerComp) const;
-	FQuat WarpRotation(UVIMotionWarpingComponent& OwnerComp, const FTransform& VIRootMotionDelta, const FTransform& VIRootMotionTotal, float DeltaSeconds);
+	/** False until a sync point is cached for this window, the first one is always accepted */
+	bool bHasCachedSyncPoint = false;
+
+	/** Montage position a sync point change within tolerance was first seen at, negative if there is none */
+	float SyncPointChangeStartPosition = -1.f;
+
+	/** Position the prepass last prepared this modifier for, prepared values only apply while it matches PreviousPosition */
+	float PreparedPosition = -1.f;
+
+	/** Root motion from PreparedPosition to EndTime */
+	FTransform PreparedVIRootMotionTotal;
+
+	/**
+	 * Warp step the prepass evaluated against a snapshot of the character, from PreparedPosition to PreparedNextPosition
+	 * Only used if movement takes exactly that step from exactly that state, see ConsumePreparedWarpStep()
+	 */
+	bool bHasPreparedWarpStep = false;
+	float PreparedNextPosition = 0.f;
+	float PreparedDeltaSeconds = 0.f;
+	FVIWarpCharacterState PreparedState;
+	FTransform PreparedInVIRootMotion;
+	FTransform PreparedWarpedVIRootMotion;
+
+	/**
+	 * @param OutWarpedVIRootMotion		Result of the prepared warp step if it applies
+	 * @return True if the prepared warp step started from State and had the same inputs as this frame
+	 */
+	bool ConsumePreparedWarpStep(const FVIWarpCharacterState& State, const FTransform& InVIRootMotion, float DeltaSeconds, FTransform& OutWarpedVIRootMotion);
+
+	/** @return False if ProcessVIRootMotion won't warp step by step this frame, so the prepass doesn't evaluate a step for nothing */
+	virtual bool NeedsPreparedWarpStep() const;
+
+	/** @return Root motion from PreviousPosition to EndTime, prepared by the prepass if possible */
+	FTransform GetVIRootMotionTotal() const;
+
+	/**
+	 * Hysteresis for sync point changes, eg. replicated sync points jitter by quantization
+	 * Changes within tolerance are only accepted once they persisted for the settle time, measured on the montage so every peer playing it agrees
+	 */
+	bool ShouldAcceptSyncPoint(const FVIMotionWarpingSyncPoint& SyncPoint, float Position);
+
+	/** Built on the first frame of the window and whenever the sync point changes, if warping on a fixed timestep */
+	FVIFixedStepWarpTrack FixedStepTrack;
+
+	/** Warps this frame's root motion, either directly or from the fixed step track */
+	FTransform ProcessWarp(UVIMotionWarpingComponent& OwnerComp, const FTransform& InVIRootMotion, float DeltaSeconds);
+
+	/**
+	 * Warps the root motion of one step starting at Position
+	 * @param InVIRootMotion		Root motion of the step, in the space this modifier runs in
+	 * @param VIRootMotionDelta		Root motion of the step extracted from the animation
+	 * @param VIRootMotionTotal		Root motion from Position to EndTime extracted from the animation
+	 */
+	virtual FTransform WarpStep(const FVIWarpCharacterState& State, const FTransform& InVIRootMotion, const FTransform& VIRootMotionDelta, const FTransform& VIRootMotionTotal, float Position, float DeltaSeconds) const;
+
+	FQuat GetTargetRotation(const FTransform& CharacterTransform) const { return GetTargetRotation(CharacterTransform, CachedSyncPoint); }
+	FQuat GetTargetRotation(const FTransform& CharacterTransform, const FVIMotionWarpingSyncPoint& SyncPoint) const;
+	FQuat WarpRotation(const FTransform& CharacterTransform, const FTransform& VIRootMotionDelta, const FTransform& VIRootMotionTotal, float Position, float DeltaSeconds) const;
 };
 
 UCLASS(meta = (DisplayName = "Simple Warp"))
@@ -6,41 +6,252 @@
 #include "VIRootMotionModifier.h"
 #include "VIRootMotionModifier_AdjustmentBlendWarp.generated.h"
 
+/** Channels stored per bone in FVIMotionDeltaTrackContainer, translation then rotation (as euler) */
+enum class EVIMotionDeltaChannel : uint8
+{
+	TranslationX,
+	TranslationY,
+	TranslationZ,
+	RotationX,
+	RotationY,
+	RotationZ,
+	Num
+};
+
+/**
+ * Motion of each bone over a warping window, in a contiguous structure-of-arrays layout
+ * Every channel of every bone is NumFrames floats, stored [Bone][Channel][Frame]
+ *
+ * Adjustment blending distributes the additive of each channel over the window in proportion to how much the
+ * channel moves each frame, so the warped value is always Base + Additive * Weight, see ApplyAdditive()
+ */
 USTRUCT()
-struct FVIMotionDeltaTrack
+struct FVIMotionDeltaTrackContainer
 {
 	GENERATED_BODY()
 
+	static constexpr int32 NumChannels = (int32)EVIMotionDeltaChannel::Num;
+
 	UPROPERTY()
-	TArray<FTransform> BoneTransformTrack;
+	int32 NumBones = 0;
 
 	UPROPERTY()
-	TArray<FVector> DeltaTranslationTrack;
+	int32 NumFrames = 0;
 
+	/** Bone value relative to the root on the first frame */
 	UPROPERTY()
-	TArray<FRotator> DeltaRotationTrack;
+	TArray<float> Base;
+
+	/** Fraction of the additive applied by each frame, 0 on the first frame and 1 on the last */
+	UPROPERTY()
+	TArray<float> Weights;
+
+	void Init(int32 InNumBones, int32 InNumFrames)
+	{
+		NumBones = InNumBones;
+		NumFrames = InNumFrames;
+		Base.SetNumZeroed(NumBones * NumChannels * NumFrames);
+		Weights.SetNumZeroed(NumBones * NumChannels * NumFrames);
+	}
+
+	FORCEINLINE int32 GetChannelOffset(int32 BoneIdx, int32 Channel) const { return (BoneIdx * NumChannels + Channel) * NumFrames; }
+
+	FORCEINLINE float* GetBase(int32 BoneIdx, int32 Channel) { return Base.GetData() + GetChannelOffset(BoneIdx, Channel); }
+	FORCEINLINE const float* GetBase(int32 BoneIdx, int32 Channel) const { return Base.GetData() + GetChannelOffset(BoneIdx, Channel); }
+	FORCEINLINE float* GetWeights(int32 BoneIdx, int32 Channel) { return Weights.GetData() + GetChannelOffset(BoneIdx, Channel); }
+	FORCEINLINE const float* GetWeights(int32 BoneIdx, int32 Channel) const { return Weights.GetData() + GetChannelOffset(BoneIdx, Channel); }
+
+	/** Copy all channels of a bone from another container with the same number of frames */
+	void CopyBone(int32 BoneIdx, const FVIMotionDeltaTrackContainer& Other, int32 OtherBoneIdx);
+
+	/** Out[i] = Base[i] + Additive * Weights[i] for one channel, vectorized */
+	static void ApplyAdditive(const float* RESTRICT InBase, const float* RESTRICT InWeights, float Additive, float* RESTRICT Out, int32 Num);
+};
+
+/** Motion delta tracks of a warping window, baked when the animation is saved so they don't have to be sampled at runtime */
+USTRUCT()
+struct FVIBakedMotionDeltaTracks
+{
+	GENERATED_BODY()
 
+	/** Animation and window the tracks were baked for */
 	UPROPERTY()
-	FVector TotalTranslation = FVector::ZeroVector;
+	TWeakObjectPtr<const UAnimSequenceBase> Animation = nullptr;
 
 	UPROPERTY()
-	FRotator TotalRotation = FRotator::ZeroRotator;
+	float StartTime = 0.f;
+
+	UPROPERTY()
+	float EndTime = 0.f;
+
+	/** Bone of each track in Tracks */
+	UPROPERTY()
+	TArray<FName> BoneNames;
+
+	UPROPERTY()
+	FVIMotionDeltaTrackContainer Tracks;
+
+	bool IsValid() const { return Animation.IsValid() && BoneNames.Num() > 0 && BoneNames.Num() == Tracks.NumBones; }
+
+	/** @return True if these tracks were baked for the window, starting at ActualStartTime */
+	bool Matches(const UAnimSequenceBase* InAnimation, float ActualStartTime, float InEndTime) const;
+
+	/**
+	 * Reorder the baked tracks to match BoneContainer
+	 * @return False if a bone in BoneContainer was not baked
+	 */
+	bool CopyTo(const FBoneContainer& BoneContainer, FVIMotionDeltaTrackContainer& OutMotionDeltaTracks) const;
 };
 
+/**
+ * Warped bone track stored compactly and decoded when sampled
+ * Translations are quantized to 16 bits per axis within the track's range, rotations are 48 bit smallest-three
+ * quaternions and scale only keeps a single key when it's constant
+ */
 USTRUCT()
-struct FVIMotionDeltaTrackContainer
+struct FVICompressedWarpedTrack
 {
 	GENERATED_BODY()
 
 	UPROPERTY()
-	TArray<FVIMotionDeltaTrack> Tracks;
+	int32 NumFrames = 0;
+
+	/** Translation range of the track, quantized translations are steps from TranslationMin */
+	UPROPERTY()
+	FVector3f TranslationMin = FVector3f::ZeroVector;
+
+	UPROPERTY()
+	FVector3f TranslationStep = FVector3f::ZeroVector;
+
+	/** 3 per frame */
+	UPROPERTY()
+	TArray<uint16> Translations;
+
+	/** 3 per frame, see EncodeRotation() */
+	UPROPERTY()
+	TArray<uint16> Rotations;
 
-	void Init(int32 InNumTracks)
+	/** A single key if scale is constant */
+	UPROPERTY()
+	TArray<FVector3f> ScaleKeys;
+
+	void Compress(const FRawAnimSequenceTrack& RawTrack);
+	void Decompress(FRawAnimSequenceTrack& OutRawTrack) const;
+
+	FORCEINLINE FVector3f GetTranslation(int32 Frame) const
 	{
-		Tracks.Reserve(InNumTracks);
+		const uint16* Quantized = &Translations[Frame * 3];
+		return TranslationMin + TranslationStep * FVector3f(Quantized[0], Quantized[1], Quantized[2]);
 	}
+
+	FORCEINLINE FQuat4f GetRotation(int32 Frame) const { return DecodeRotation(&Rotations[Frame * 3]); }
+
+	FORCEINLINE FVector3f GetScale(int32 Frame) const { return ScaleKeys.Num() > 0 ? ScaleKeys[FMath::Min(Frame, ScaleKeys.Num() - 1)] : FVector3f(1.f); }
+
+	void ExtractTransformForFrame(int32 Frame, FTransform& OutTransform) const;
+
+	/** Same sampling as FVIAnimationUtils::ExtractTransformFromTrack() with linear interpolation */
+	void ExtractTransform(float Time, float SequenceLength, FTransform& OutTransform) const;
+
+	SIZE_T GetAllocatedSize() const { return Translations.GetAllocatedSize() + Rotations.GetAllocatedSize() + ScaleKeys.GetAllocatedSize(); }
+
+	static void EncodeRotation(const FQuat4f& Rotation, uint16* OutPacked);
+	static FQuat4f DecodeRotation(const uint16* Packed);
 };
 
+USTRUCT()
+struct FVICompressedWarpedTrackContainer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FVICompressedWarpedTrack> Tracks;
+
+	UPROPERTY()
+	TArray<FName> TrackNames;
+
+	int32 GetNum() const { return Tracks.Num(); }
+
+	void Reset()
+	{
+		Tracks.Reset();
+		TrackNames.Reset();
+	}
+
+	void Compress(const FAnimSequenceTrackContainer& RawTracks);
+	void Decompress(FAnimSequenceTrackContainer& OutRawTracks) const;
+
+	SIZE_T GetAllocatedSize() const;
+
+	/** Largest difference from RawTracks on any key, translation in cm and rotation in degrees */
+	void MeasureError(const FAnimSequenceTrackContainer& RawTracks, float& OutMaxTranslationError, float& OutMaxRotationError) const;
+
+	static SIZE_T GetAllocatedSize(const FAnimSequenceTrackContainer& RawTracks);
+};
+
+/** Keeps the warped track memory stats in sync with the tracks of a modifier, copies start untracked */
+struct FVIWarpedTracksMemoryTracker
+{
+	FVIWarpedTracksMemoryTracker() {}
+	FVIWarpedTracksMemoryTracker(const FVIWarpedTracksMemoryTracker&) {}
+	FVIWarpedTracksMemoryTracker& operator=(const FVIWarpedTracksMemoryTracker&) { return *this; }
+	~FVIWarpedTracksMemoryTracker() { Update(0); }
+
+	void Update(SIZE_T NewSize);
+
+private:
+	SIZE_T Size = 0;
+};
+
+class UVIRootMotionModifierConfig_AdjustmentBlendWarp;
+
+/** Everything needed to build the warped tracks, gathered on the game thread so they can be built on a worker */
+struct FVIAdjustmentBlendWarpParams
+{
+	TWeakObjectPtr<const UAnimSequenceBase> Animation;
+
+	/** Asset and bones the FBoneContainer is built for */
+	TWeakObjectPtr<UObject> BoneContainerAsset;
+	TArray<FBoneIndexType> RequiredBoneIndexArray;
+
+	TArray<FName> IKBones;
+
+	/** Config holding baked motion delta tracks for this window, if they can be used */
+	TWeakObjectPtr<const UVIRootMotionModifierConfig_AdjustmentBlendWarp> BakedConfig;
+
+	FTransform CachedMeshTransform;
+	FTransform CachedVIRootMotion;
+	FVector SyncPointLocation = FVector::ZeroVector;
+	FQuat OriginalRotation = FQuat::Identity;
+	FQuat TargetRotation = FQuat::Identity;
+
+	float StartTime = 0.f;
+	float EndTime = 0.f;
+
+	bool bWarpTranslation = false;
+	bool bIgnoreZAxis = false;
+	bool bWarpRotation = false;
+	bool bWarpIKBones = false;
+
+	/** @return True if exactly the same, the warped tracks built from either are the same */
+	bool Identical(const FVIAdjustmentBlendWarpParams& Other) const;
+};
+
+/** Animation data the warped tracks are built from, copied out of the animation and skeleton so building them doesn't read UObjects */
+struct FVIAdjustmentBlendWarpInput
+{
+	/** Name of each required bone, in compact pose order */
+	TArray<FName> BoneNames;
+
+	/** Additive of each required bone over the window, identity for bones that aren't warped */
+	TArray<FTransform> AdditivePose;
+
+	FVIMotionDeltaTrackContainer MotionDeltaTracks;
+};
+
+/** Warped tracks being built on a worker */
+struct FVIAdjustmentBlendWarpTask;
+
 USTRUCT()
 struct VIMOTIONWARPING_API FVIRootMotionModifier_AdjustmentBlendWarp : public FVIRootMotionModifier_Warp
 {
@@ -54,17 +265,34 @@ public:
 	UPROPERTY()
 	TArray<FName> IKBones;
 
+	/** Build the warped tracks on a worker and use simple warping until they are ready, only used by characters whose root motion isn't replayed */
+	UPROPERTY()
+	bool bPrecomputeAsync = false;
+
+	/** Time to blend from simple warping to the warped tracks once they are ready */
+	UPROPERTY()
+	float AsyncBlendInTime = 0.1f;
+
+	/** Config that added this modifier, provides the baked motion delta tracks */
+	UPROPERTY()
+	TWeakObjectPtr<const UVIRootMotionModifierConfig_AdjustmentBlendWarp> Config;
+
 	FVIRootMotionModifier_AdjustmentBlendWarp();
 	virtual ~FVIRootMotionModifier_AdjustmentBlendWarp() {}
 
 	virtual UScriptStruct* GetScriptStruct() const { return FVIRootMotionModifier_AdjustmentBlendWarp::StaticStruct(); }
 	virtual void OnSyncPointChanged(UVIMotionWarpingComponent& OwnerComp) override;
+	virtual void ResetModifier() override;
 	virtual FTransform ProcessVIRootMotion(UVIMotionWarpingComponent& OwnerComp, const FTransform& InVIRootMotion, float DeltaSeconds) override;
+	virtual void GatherVIRootMotionPrepareInputs(UVIMotionWarpingComponent& OwnerComp, const FVIRootMotionPrepareParams& Params) override;
+	virtual void PrepareVIRootMotion(const FVIRootMotionPrepareParams& Params) override;
 
 	void GetIKBoneTransformAndAlpha(FName BoneName, FTransform& OutTransform, float& OutAlpha) const;
 
 protected:
 
+	virtual bool NeedsPreparedWarpStep() const override;
+
 	UPROPERTY()
 	FTransform CachedMeshTransform;
 
@@ -74,17 +302,89 @@ protected:
 	UPROPERTY()
 	FTransform CachedVIRootMotion;
 
+	/** Warped tracks as built, empty once compressed into CompressedResult */
 	UPROPERTY()
 	FAnimSequenceTrackContainer Result;
 
+	UPROPERTY()
+	FVICompressedWarpedTrackContainer CompressedResult;
+
+	FVIWarpedTracksMemoryTracker WarpedTracksMemory;
+
 	UPROPERTY()
 	float ActualStartTime = 0.f;
 
+	/** Sync point the tracks in Result currently warp to */
+	FVIMotionWarpingSyncPoint WarpedTracksSyncPoint;
+
+	/** Track in Result for each IK bone, rebuilt whenever Result is */
+	TMap<FName, int32, TInlineSetAllocator<4>> IKBoneTrackIndices;
+
+	/** Weight of the warped tracks against simple warping, below 1 while blending in async results */
+	float AsyncBlendInAlpha = 1.f;
+
+	/** Root of the warped tracks at PreparedStartRootPosition, negative position whenever the tracks change */
+	FTransform PreparedStartRootTransform;
+	float PreparedStartRootPosition = -1.f;
+
+	TSharedPtr<FVIAdjustmentBlendWarpTask, ESPMode::ThreadSafe> PendingTask;
+
+	/** Params the prepass builds PreparedTracks from, set on the game thread by GatherVIRootMotionPrepareInputs() */
+	FVIAdjustmentBlendWarpParams PreparedTracksParams;
+	bool bPrepareTracks = false;
+
+	/** Warped tracks built by the prepass, used instead of building them in movement if it gathers identical params */
+	FAnimSequenceTrackContainer PreparedTracks;
+	bool bHasPreparedTracks = false;
+
+	/** @return True if the owner's root motion is replayed or validated over the network, so must not depend on when a worker finishes */
+	static bool IsRootMotionNetRelevant(const UVIMotionWarpingComponent& OwnerComp);
+
+	/** @return True if the warped tracks are built on a worker and blended in */
+	bool ShouldPrecomputeAsync(const UVIMotionWarpingComponent& OwnerComp) const;
+
+	/** @return False if there is no character mesh to warp */
+	bool GatherPrecomputeParams(UVIMotionWarpingComponent& OwnerComp, FVIAdjustmentBlendWarpParams& OutParams) const;
+
+	/** Same as above for tracks starting at InStartTime, with the values OnSyncPointChanged() caches passed in */
+	bool GatherPrecomputeParams(UVIMotionWarpingComponent& OwnerComp, const FVIMotionWarpingSyncPoint& SyncPoint, float InStartTime, const FTransform& VIRootMotionTotal, const FTransform& MeshTransform, const FTransform& MeshRelativeTransform, FVIAdjustmentBlendWarpParams& OutParams) const;
+
 	void PrecomputeWarpedTracks(UVIMotionWarpingComponent& OwnerComp);
 
+	/** Starts building the warped tracks on a worker */
+	void PrecomputeWarpedTracksAsync(UVIMotionWarpingComponent& OwnerComp);
+
+	/** @return True if the pending task finished and its tracks were moved into Result */
+	bool ConsumePendingTask();
+
+	/** Call after Result changes */
+	void CacheIKBoneTrackIndices();
+
+	FORCEINLINE bool HasWarpedTracks() const { return Result.GetNum() > 0 || CompressedResult.GetNum() > 0; }
+	FORCEINLINE int32 GetNumWarpedTracks() const { return CompressedResult.GetNum() > 0 ? CompressedResult.GetNum() : Result.GetNum(); }
+	FORCEINLINE const TArray<FName>& GetWarpedTrackNames() const { return CompressedResult.GetNum() > 0 ? CompressedResult.TrackNames : Result.TrackNames; }
+	int32 GetNumWarpedFrames(int32 TrackIndex) const;
+
+	/** Call once the tracks in Result are built for the cached sync point, compresses them if enabled and they aren't already */
+	void OnWarpedTracksBuilt();
+
+	/** Name compression errors of this modifier's tracks are logged under, empty unless debugging */
+	FString GetCompressionDebugName() const;
+
+	/** Discards the warped tracks, keeping their allocations */
+	void ResetWarpedTracks();
+
+	/**
+	 * Shifts the part of the warped tracks we haven't played yet towards the new sync point
+	 * @return False if the change is too large to patch and the tracks must be rebuilt
+	 */
+	bool RewarpRemainingTracks();
+
+	/** Builds the warped tracks, safe to call from any thread but the animation and skeleton must be kept alive */
+	static void PrecomputeWarpedTracks(const FVIAdjustmentBlendWarpParams& Params, FAnimSequenceTrackContainer& Output);
+
 	FTransform ExtractWarpedVIRootMotion() const;
 
-	void ExtractBoneTransformAtTime(FTransform& OutTransform, const FName& BoneName, float Time) const;
 	void ExtractBoneTransformAtTime(FTransform& OutTransform, int32 TrackIndex, float Time) const;
 	void ExtractBoneTransformAtFrame(FTransform& OutTransform, int32 TrackIndex, int32 Frame) const;
 
@@ -92,9 +392,36 @@ protected:
 	void DrawDebugWarpedTracks(UVIMotionWarpingComponent& OwnerComp, float DrawDuration) const;
 #endif
 
+public:
+
+	/** Rate the motion delta tracks are sampled at, live and baked */
+	static constexpr float MotionDeltaSampleRate = 1 / 60.f;
+
 	static void ExtractMotionDeltaFromRange(const FBoneContainer& BoneContainer, const UAnimSequenceBase* Animation, float StartTime, float EndTime, float SampleRate, FVIMotionDeltaTrackContainer& OutMotionDeltaTracks);
 
-	static void AdjustmentBlendWarp(const FBoneContainer& BoneContainer, const FCSPose<FCompactPose>& AdditivePose, const FVIMotionDeltaTrackContainer& MotionDeltaTracks, FAnimSequenceTrackContainer& Output);
+	/**
+	 * Reads everything the warped tracks are built from out of the animation and skeleton, the only part of building them that needs the UObjects
+	 * Uses the baked motion delta tracks of Params.BakedConfig if it has every bone, otherwise samples them
+	 * @return False if the animation or skeleton is gone
+	 */
+	static bool GatherWarpInput(const FVIAdjustmentBlendWarpParams& Params, FVIAdjustmentBlendWarpInput& OutInput);
+
+	static void AdjustmentBlendWarp(const FVIAdjustmentBlendWarpInput& Input, FAnimSequenceTrackContainer& Output);
+};
+
+/**
+ * Resolves the motion warping component of a character once so anim graphs can query the warped IK bones
+ * every evaluation without searching the character's components
+ */
+USTRUCT(BlueprintType)
+struct VIMOTIONWARPING_API FVIAdjustmentBlendWarpIKHandle
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TWeakObjectPtr<const UVIMotionWarpingComponent> VIMotionWarpingComp;
+
+	bool IsValid() const { return VIMotionWarpingComp.IsValid(); }
 };
 
 UCLASS(meta = (DisplayName = "Adjustment Blend Warp"))
@@ -110,17 +437,54 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config", meta = (EditCondition = "bWarpIKBones"))
 	TArray<FName> IKBones;
 
+	/**
+	 * Build the warped tracks on a worker instead of the frame the window starts
+	 * Simple warping is used until they are ready, avoiding a hitch when many characters start warping on the same frame
+	 * The frame they arrive on depends on the machine, so this is ignored by the server and autonomous proxies which must compute the same root motion
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config")
+	bool bPrecomputeAsync = false;
+
+	/** Time to blend from simple warping to the warped tracks once they are ready */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config", meta = (EditCondition = "bPrecomputeAsync", ClampMin = "0", UIMin = "0"))
+	float AsyncBlendInTime = 0.1f;
+
 	UVIRootMotionModifierConfig_AdjustmentBlendWarp(const FObjectInitializer& ObjectInitializer)
 		: Super(ObjectInitializer) {}
 
-	virtual void AddVIRootMotionModifier(UVIMotionWarpingComponent* VIMotionWarpingComp, const UAnimSequenceBase* Animation, float StartTime, float EndTime) const override
-	{
-		UVIRootMotionModifierConfig_AdjustmentBlendWarp::AddVIRootMotionModifierAdjustmentBlendWarp(VIMotionWarpingComp, Animation, StartTime, EndTime, SyncPointName, bWarpTranslation, bIgnoreZAxis, bWarpRotation, bWarpIKBones, IKBones);
-	}
+	/** Motion delta tracks for the window this config is on, baked when the animation is saved */
+	UPROPERTY()
+	FVIBakedMotionDeltaTracks BakedMotionDeltaTracks;
+
+	virtual void AddVIRootMotionModifier(UVIMotionWarpingComponent* VIMotionWarpingComp, const UAnimSequenceBase* Animation, float StartTime, float EndTime) const override;
+
+#if WITH_EDITOR
+	virtual void PreSave(FObjectPreSaveContext SaveContext) override;
+#endif
+
+	/**
+	 * Sample the motion delta tracks for the window this config is on, using the skeleton's bones
+	 * @return False if this config is not on a warping window in an animation
+	 */
+	bool SampleMotionDeltaTracks(FVIBakedMotionDeltaTracks& OutBakedTracks) const;
 
 	UFUNCTION(BlueprintCallable, Category = "Motion Warping")
-	static void AddVIRootMotionModifierAdjustmentBlendWarp(UVIMotionWarpingComponent* InVIMotionWarpingComp, const UAnimSequenceBase* InAnimation, float InStartTime, float InEndTime, FName InSyncPointName, bool bInWarpTranslation, bool bInIgnoreZAxis, bool bInWarpRotation, bool bInWarpIKBones, const TArray<FName>& InIKBones);
+	static void AddVIRootMotionModifierAdjustmentBlendWarp(UVIMotionWarpingComponent* InVIMotionWarpingComp, const UAnimSequenceBase* InAnimation, float InStartTime, float InEndTime, FName InSyncPointName, bool bInWarpTranslation, bool bInIgnoreZAxis, bool bInWarpRotation, bool bInWarpIKBones, const TArray<FName>& InIKBones, bool bInPrecomputeAsync = false, float InAsyncBlendInTime = 0.1f);
+
+	/** Adds the modifier and returns it */
+	static TSharedPtr<FVIRootMotionModifier_AdjustmentBlendWarp> MakeVIRootMotionModifierAdjustmentBlendWarp(UVIMotionWarpingComponent* InVIMotionWarpingComp, const UAnimSequenceBase* InAnimation, float InStartTime, float InEndTime, FName InSyncPointName, bool bInWarpTranslation, bool bInIgnoreZAxis, bool bInWarpRotation, bool bInWarpIKBones, const TArray<FName>& InIKBones, bool bInPrecomputeAsync, float InAsyncBlendInTime);
 
+	/**
+	 * Searches the character for its motion warping component on every call, kept for anim graphs that predate IK handles
+	 * Prefer resolving a handle once with MakeIKHandle(), UVIAnimInstance exposes one as IKWarpHandle
+	 */
 	UFUNCTION(BlueprintPure, Category = "Motion Warping")
 	static void GetIKBoneTransformAndAlpha(ACharacter* Character, FName BoneName, FTransform& OutTransform, float& OutAlpha);
+
+	/** Resolve the handle once, eg. when the anim instance initializes, and pass it to GetIKBoneTransformAndAlphaFromHandle() */
+	UFUNCTION(BlueprintPure, Category = "Motion Warping")
+	static FVIAdjustmentBlendWarpIKHandle MakeIKHandle(ACharacter* Character);
+
+	UFUNCTION(BlueprintPure, Category = "Motion Warping")
+	static void GetIKBoneTransformAndAlphaFromHandle(const FVIAdjustmentBlendWarpIKHandle& Handle, FName BoneName, FTransform& OutTransform, float& OutAlpha);
 };
\ No newline at end of file
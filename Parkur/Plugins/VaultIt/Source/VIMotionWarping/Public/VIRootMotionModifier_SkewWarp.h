@@ -18,6 +18,10 @@ public:
 
 	virtual UScriptStruct* GetScriptStruct() const { return FVIRootMotionModifier_SkewWarp::StaticStruct(); }
 	virtual FTransform ProcessVIRootMotion(UVIMotionWarpingComponent& OwnerComp, const FTransform& InVIRootMotion, float DeltaSeconds) override;
+
+protected:
+
+	virtual FTransform WarpStep(const FVIWarpCharacterState& State, const FTransform& InVIRootMotion, const FTransform& VIRootMotionDelta, const FTransform& VIRootMotionTotal, float Position, float DeltaSeconds) const override;
 };
 
 UCLASS(meta = (DisplayName = "Skew Warp"))
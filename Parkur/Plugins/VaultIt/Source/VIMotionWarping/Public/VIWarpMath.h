@@ -0,0 +1,76 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Warp math used by the root motion modifiers, over plain transforms and curves
+ * Nothing here depends on components, characters or montages, so it can be profiled and validated in isolation
+ */
+class VIMOTIONWARPING_API FVIWarpMath
+{
+public:
+
+	/** @return Delta scaled by the ratio of Target to Original, 0 if Original is 0 */
+	static FORCEINLINE float ScaleToTarget(float Delta, float Target, float Original)
+	{
+		return Original != 0.f ? ((Delta * Target) / Original) : 0.f;
+	}
+
+	/** @return Signed length of Vector along Dir */
+	static float ComputeDirectionForVector(const FVector& Vector, const FVector& Dir);
+
+	/**
+	 * Simple warp of the translation for one step
+	 * @param RootMotionDelta		Root motion of this step
+	 * @param RootMotionTotal		Root motion left until the end of the window
+	 * @param HorizontalTarget		Distance left to the sync point, perpendicular to Up
+	 * @param Direction				Direction to move in, perpendicular to Up
+	 * @param VerticalTarget		Distance left to the sync point along Up, unused if bIgnoreZAxis
+	 */
+	static FVector WarpTranslation(const FVector& RootMotionDelta, const FVector& RootMotionTotal, float HorizontalTarget, const FVector& Direction, float VerticalTarget, const FVector& Up, bool bIgnoreZAxis);
+
+	/**
+	 * Skew warp of the translation for one step, everything in world space
+	 * Shears and scales the root motion so the location the remaining root motion ends at lines up with TargetLocation
+	 * @param RootMotionDelta		Root motion of this step
+	 * @param CurrentLocation		Location the remaining root motion starts from
+	 * @param CurrentRotation		Rotation the remaining root motion starts from
+	 * @param FutureLocation		Location the remaining root motion ends at
+	 * @param TargetLocation		Location to end at instead
+	 */
+	static FVector SkewWarpTranslation(const FVector& RootMotionDelta, const FVector& CurrentLocation, const FQuat& CurrentRotation, const FVector& FutureLocation, const FVector& TargetLocation);
+
+	/**
+	 * Warp of the rotation for one step, moving the rotation the remaining root motion ends at towards TargetRotation
+	 * @param TimeRemaining			Time left to reach TargetRotation
+	 * @return Rotation delta for this step
+	 */
+	static FQuat WarpRotation(const FQuat& RootMotionDeltaRotation, const FQuat& RootMotionTotalRotation, const FQuat& CurrentRotation, const FQuat& TargetRotation, float TimeRemaining, float DeltaSeconds);
+
+	/**
+	 * Same conversion as USkeletalMeshComponent::ConvertLocalRootMotionToWorld, for a mesh at MeshRelativeTransform on an actor at ActorTransform
+	 * @return Root motion as character movement applies it, translation added to the actor location and rotation applied on top of the actor rotation
+	 */
+	static FTransform ConvertLocalRootMotionToWorld(const FTransform& LocalRootMotion, const FTransform& ActorTransform, const FTransform& MeshRelativeTransform);
+
+	/** Inverse of ConvertLocalRootMotionToWorld */
+	static FTransform ConvertWorldRootMotionToLocal(const FTransform& WorldRootMotion, const FTransform& ActorTransform, const FTransform& MeshRelativeTransform);
+
+	/** @return Rotation facing TargetLocation from Location on the horizontal plane */
+	static FQuat FacingRotation(const FVector& Location, const FVector& TargetLocation);
+
+	/**
+	 * Adjustment blending weights for a curve: the fraction of the total additive applied at each sample
+	 * Every sample gets the share matching its share of the curve's total motion, curves that barely move get it linearly
+	 */
+	static void ComputeAdjustmentBlendWeights(const float* Values, float* OutWeights, int32 Num);
+
+	/** @return Alpha ramping from 0 at Position to 1 at EndTime, used to blend corrections into what's left of a window */
+	static FORCEINLINE float RemainingWindowAlpha(float Time, float Position, float EndTime)
+	{
+		const float Remaining = EndTime - Position;
+		return Remaining > KINDA_SMALL_NUMBER ? FMath::Clamp((Time - Position) / Remaining, 0.f, 1.f) : 1.f;
+	}
+};
@@ -39,6 +39,12 @@ public class VIMotionWarping : ModuleRules
 			{
             }
 			);
+
+		// Automation tests load the shipped animations
+		if (Target.bBuildEditor)
+		{
+			PrivateDependencyModuleNames.Add("AssetRegistry");
+		}
 		
 		
 		DynamicallyLoadedModuleNames.AddRange(
@@ -10,64 +10,108 @@ void UVIAnimInstance::NativeInitializeAnimation()
 	Super::NativeInitializeAnimation();
 
 	Character = (TryGetPawnOwner()) ? Cast<AVICharacterBase>(TryGetPawnOwner()) : nullptr;
+	IKWarpHandle = UVIRootMotionModifierConfig_AdjustmentBlendWarp::MakeIKHandle(Character);
+
+	RHandSlot = FBIK.IndexOfByPredicate([this](const FVIBoneFBIKData& Bone) { return Bone.BoneName == RHandName; });
+	LHandSlot = FBIK.IndexOfByPredicate([this](const FVIBoneFBIKData& Bone) { return Bone.BoneName == LHandName; });
 }
 
 void UVIAnimInstance::NativeUpdateAnimation(float DeltaTime)
 {
+	// Only gather here, anything else belongs in NativeThreadSafeUpdateAnimation
 	if (Character)
 	{
 		const bool bWasVaulting = bIsVaulting;
+
 		bIsVaulting = Character->IsVaulting();
-		if (bIsVaulting)
+		if (!bIsVaulting)
 		{
-			// Resetting these while vaulting leads to better blending out
-			bIsJumping = false;
-			bIsFalling = false;
-			Speed = 0.f;
+			CharacterData.bIsFalling = Character->GetCharacterMovement() && Character->GetCharacterMovement()->IsFalling();
+			CharacterData.bIsAscending = CharacterData.bIsFalling && UVIBlueprintFunctionLibrary::ActorIsAscending(Character, false);
+			CharacterData.Speed = Character->GetVelocity().Size();
+		}
 
-			// Interp FBIK
-			UVIBlueprintFunctionLibrary::InterpolateFBIK(DeltaTime, FBIK);
+		FBIKWrites.Append(PendingFBIKWrites);
+		PendingFBIKWrites.Reset();
 
-			// Right Hand
-			{
-				const FVIBoneFBIKData* BoneData = UVIBlueprintFunctionLibrary::GetBoneForFBIK(RHandName, FBIK);
-				bRHand = BoneData->bEnabled; 
-				RHandLoc = BoneData->Location;
-			}
-			// Left Hand
+		// Events can play montages and call into blueprint
+		if (bIsVaulting && !bWasVaulting)
+		{
+			OnStartVault();
+		}
+		else if (bWasVaulting && !bIsVaulting)
+		{
+			OnStopVault();
+		}
+	}
+}
+
+void UVIAnimInstance::NativeThreadSafeUpdateAnimation(float DeltaTime)
+{
+	if (!Character)
+	{
+		return;
+	}
+
+	for (const FVIFBIKWrite& Write : FBIKWrites)
+	{
+		const int32 Slot = (Write.Slot != INDEX_NONE) ? Write.Slot : FBIK.IndexOfByPredicate([&Write](const FVIBoneFBIKData& Bone) { return Bone.BoneName == Write.BoneName; });
+		if (FBIK.IsValidIndex(Slot))
+		{
+			if (Write.bEnabled)
 			{
-				const FVIBoneFBIKData* BoneData = UVIBlueprintFunctionLibrary::GetBoneForFBIK(LHandName, FBIK);
-				bLHand = BoneData->bEnabled;
-				LHandLoc = BoneData->Location;
+				FBIK[Slot].Enable(Write.Location);
 			}
-			// Both Hands
+			else
 			{
-				bBothHand = (bRHand && bLHand);
-				if (bBothHand)
-				{
-					// Use only control rig with both IK
-					// Only ever uses one control rig at a time
-					bRHand = false;
-					bLHand = false;
-				}
+				FBIK[Slot].Disable();
 			}
 		}
-		else
+	}
+	FBIKWrites.Reset();
+
+	if (bIsVaulting)
+	{
+		// Resetting these while vaulting leads to better blending out
+		bIsJumping = false;
+		bIsFalling = false;
+		Speed = 0.f;
+
+		// Interp FBIK
+		FVIBoneFBIKData::UpdateAll(FBIK, DeltaTime);
+
+		// Right Hand
+		if (FBIK.IsValidIndex(RHandSlot))
 		{
-			bIsFalling = Character->GetCharacterMovement() && Character->GetCharacterMovement()->IsFalling();
-			bIsJumping = bIsFalling && UVIBlueprintFunctionLibrary::ActorIsAscending(Character, false);
-			Speed = Character->GetVelocity().Size();
+			const FVIBoneFBIKData& BoneData = FBIK[RHandSlot];
+			bRHand = BoneData.bEnabled; 
+			RHandLoc = BoneData.Location;
 		}
-
-		if (bIsVaulting && !bWasVaulting)
+		// Left Hand
+		if (FBIK.IsValidIndex(LHandSlot))
 		{
-			OnStartVault();
+			const FVIBoneFBIKData& BoneData = FBIK[LHandSlot];
+			bLHand = BoneData.bEnabled;
+			LHandLoc = BoneData.Location;
 		}
-		else if (bWasVaulting && !bIsVaulting)
+		// Both Hands
 		{
-			OnStopVault();
+			bBothHand = (bRHand && bLHand);
+			if (bBothHand)
+			{
+				// Use only control rig with both IK
+				// Only ever uses one control rig at a time
+				bRHand = false;
+				bLHand = false;
+			}
 		}
 	}
+	else
+	{
+		bIsFalling = CharacterData.bIsFalling;
+		bIsJumping = CharacterData.bIsAscending;
+		Speed = CharacterData.Speed;
+	}
 }
 
 void UVIAnimInstance::OnStartVault()
@@ -87,5 +131,44 @@ void UVIAnimInstance::OnStopVault()
 
 void UVIAnimInstance::SetBoneFBIK_Implementation(const FName& BoneName, const FVector& BoneLocation, bool bEnabled)
 {
-	UVIBlueprintFunctionLibrary::ToggleBoneFBIK(BoneName, BoneLocation, bEnabled, FBIK);
+	QueueFBIKWrite(INDEX_NONE, BoneName, BoneLocation, bEnabled);
+}
+
+void UVIAnimInstance::QueueFBIKWrite(int32 Slot, const FName& BoneName, const FVector& BoneLocation, bool bEnabled)
+{
+	check(IsInGameThread());
+
+	// Only the latest write for a bone matters, keeps the buffer bounded while the anim instance isn't updating
+	FVIFBIKWrite* Write = PendingFBIKWrites.FindByPredicate([Slot, &BoneName](const FVIFBIKWrite& Other)
+	{
+		return (Slot != INDEX_NONE) ? Other.Slot == Slot : (Other.Slot == INDEX_NONE && Other.BoneName == BoneName);
+	});
+
+	if (!Write)
+	{
+		Write = &PendingFBIKWrites.AddDefaulted_GetRef();
+	}
+
+	Write->Slot = Slot;
+	Write->BoneName = BoneName;
+	Write->Location = BoneLocation;
+	Write->bEnabled = bEnabled;
+}
+
+int32 UVIAnimInstance::FindFBIKSlot(const FName& BoneName) const
+{
+	if (GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UVIAnimInstance, SetBoneFBIK)))
+	{
+		return INDEX_NONE;
+	}
+
+	return FBIK.IndexOfByPredicate([&BoneName](const FVIBoneFBIKData& Bone) { return Bone.BoneName == BoneName; });
+}
+
+void UVIAnimInstance::SetBoneFBIKSlot(int32 Slot, const FVector& BoneLocation, bool bEnabled)
+{
+	if (FBIK.IsValidIndex(Slot))
+	{
+		QueueFBIKWrite(Slot, FBIK[Slot].BoneName, BoneLocation, bEnabled);
+	}
 }
@@ -4,12 +4,14 @@
 #include "Components/SkeletalMeshComponent.h"
 #include "Animation/AnimInstance.h"
 #include "Animation/VIAnimationInterface.h"
+#include "Animation/VIAnimInstance.h"
+#include "Animation/VIFBIKTraceBatch.h"
 #include "Pawn/VIPawnInterface.h"
 #include "VIBlueprintFunctionLibrary.h"
 #include "GameFramework/Pawn.h"
-#include "Kismet/KismetSystemLibrary.h"
 
 DECLARE_CYCLE_STAT(TEXT("Update FBIK"), STAT_VAULTFBIK, STATGROUP_VaultIt);
+DECLARE_CYCLE_STAT(TEXT("Apply FBIK"), STAT_VAULTFBIK_APPLY, STATGROUP_VaultIt);
 
 #if WITH_EDITOR
 void UVIAnimNotifyState_FBIK::OnAnimNotifyCreatedInEditor(FAnimNotifyEvent& ContainingAnimNotifyEvent)
@@ -34,17 +36,26 @@ void UVIAnimNotifyState_FBIK::NotifyBegin(USkeletalMeshComponent* MeshComp, UAni
 		return;
 	}
 
-	LateralOffset = 0.f;
-	SkippedTicks = TickSkipAmount;
+	// Start from a clean slot, a trace still in flight from a previous window is ignored
+	FVIFBIKTraceSlot& Slot = FVIFBIKTraceBatch::Get().BeginSlot(MeshComp, this);
 
 	const FVector& Loc = PawnOwner->GetActorLocation();
 	const FVector& BoneLoc = MeshComp->GetSocketLocation(BoneName);
 
-	LateralOffset = UVIBlueprintFunctionLibrary::ComputeDirectionToFloat((BoneLoc - Loc), PawnOwner->GetActorRightVector());
+	Slot.LateralOffset = UVIBlueprintFunctionLibrary::ComputeDirectionToFloat((BoneLoc - Loc), PawnOwner->GetActorRightVector());
+
+	// Skip the bone name search every time the bone is set
+	if (const UVIAnimInstance* VIAnimInstance = Cast<UVIAnimInstance>(MeshComp->GetAnimInstance()))
+	{
+		Slot.AnimFBIKSlot = VIAnimInstance->FindFBIKSlot(BoneName);
+	}
 
 	if (UpdateType == EVIFBIKUpdateType::FUT_Single)
 	{
 		UpdateFBIK(MeshComp);
+
+		// Only has a result already if traces are synchronous
+		ApplyFBIK(MeshComp, 0.f);
 	}
 }
 
@@ -54,10 +65,19 @@ void UVIAnimNotifyState_FBIK::NotifyTick(USkeletalMeshComponent* MeshComp, UAnim
 	{
 		UpdateFBIK(MeshComp);
 	}
+
+	ApplyFBIK(MeshComp, FrameDeltaTime);
 }
 
 void UVIAnimNotifyState_FBIK::NotifyEnd(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation)
 {
+	// Regardless of role, it may have changed since the notify began
+	// The bone stays placed while an overlapping montage instance still has the notify active
+	if (!FVIFBIKTraceBatch::Get().RemoveSlot(MeshComp, this))
+	{
+		return;
+	}
+
 	if (MeshComp && MeshComp->GetAnimInstance())
 	{
 		APawn* const PawnOwner = GetPawnOwner(MeshComp);
@@ -71,9 +91,6 @@ void UVIAnimNotifyState_FBIK::NotifyEnd(USkeletalMeshComponent* MeshComp, UAnimS
 			return;
 		}
 
-		LateralOffset = 0.f;
-		SkippedTicks = TickSkipAmount;
-
 		if (MeshComp->GetAnimInstance()->Implements<UVIAnimationInterface>())
 		{
 			// Disable FBIK
@@ -90,7 +107,9 @@ void UVIAnimNotifyState_FBIK::UpdateFBIK(USkeletalMeshComponent* MeshComp)
 {
 	if (MeshComp && MeshComp->GetAnimInstance())
 	{
-		if (LateralOffset == 0.f)
+		// No slot if the notify didn't begin for this role
+		FVIFBIKTraceSlot* const Slot = FVIFBIKTraceBatch::Get().FindSlot(MeshComp, this);
+		if (!Slot || Slot->LateralOffset == 0.f)
 		{
 			return;
 		}
@@ -108,16 +127,35 @@ void UVIAnimNotifyState_FBIK::UpdateFBIK(USkeletalMeshComponent* MeshComp)
 
 		SCOPE_CYCLE_COUNTER(STAT_VAULTFBIK);
 
+		// Budget FBIK by how much of the screen the character takes up
+		const FVIFBIKSignificance Significance = FVIFBIKTraceBatch::Get().ComputeSignificance(MeshComp, IsLocalPlayer(PawnOwner), TickSkipAmount);
+		if (Significance.IsCulled())
+		{
+			if (!Slot->bCulled)
+			{
+				Slot->bCulled = true;
+				Slot->bPlaced = false;
+				Slot->bHasNewResult = false;
+				Slot->SkippedTicks = MAX_uint8;
+				if (MeshComp->GetAnimInstance()->Implements<UVIAnimationInterface>())
+				{
+					SetBoneFBIK(MeshComp->GetAnimInstance(), *Slot, FVector::ZeroVector, false);
+				}
+			}
+			return;
+		}
+		Slot->bCulled = false;
+
 		// Skip ticks to reduce overhead
 		// (as this is only cosmetic and old values can be safely used for the insignificant amount of time lapsed as values are interpolated anyway)
-		if (SkippedTicks != TickSkipAmount)
+		if (Slot->SkippedTicks < Significance.TickSkipAmount)
 		{
-			SkippedTicks++;
+			Slot->SkippedTicks++;
 			return;
 		}
 		else
 		{
-			SkippedTicks = 0;
+			Slot->SkippedTicks = 0;
 		}
 
 		if (!PawnOwner->Implements<UVIPawnInterface>())
@@ -128,73 +166,122 @@ void UVIAnimNotifyState_FBIK::UpdateFBIK(USkeletalMeshComponent* MeshComp)
 
 		if (MeshComp->GetAnimInstance()->Implements<UVIAnimationInterface>())
 		{
-			// Perform the trace
-			FHitResult Hit(ForceInit);
-			{
-				const FVITraceSettings& TraceSettings = IVIPawnInterface::Execute_GetVaultTraceSettings(PawnOwner);
-				const TArray<AActor*> TraceIgnore = { PawnOwner };
+			// Queue the trace, it goes out with every other FBIK trace in the world once actors have ticked
+			const FVITraceSettings& TraceSettings = IVIPawnInterface::Execute_GetVaultTraceSettings(PawnOwner);
 
-				FVector VaultLoc;
-				FVector VaultDir;
-				IVIPawnInterface::Execute_GetVaultLocationAndDirection(PawnOwner, VaultLoc, VaultDir);
+			FVector VaultLoc;
+			FVector VaultDir;
+			IVIPawnInterface::Execute_GetVaultLocationAndDirection(PawnOwner, VaultLoc, VaultDir);
 
-				const FVector& Right = PawnOwner->GetActorRightVector();
-				const FVector RightLoc = PawnOwner->GetActorLocation() + (Right * LateralOffset);
-				const FVector VaultRightLoc = VaultLoc + (Right * LateralOffset);
+			const FVector& Right = PawnOwner->GetActorRightVector();
+			const FVector RightLoc = PawnOwner->GetActorLocation() + (Right * Slot->LateralOffset);
+			const FVector VaultRightLoc = VaultLoc + (Right * Slot->LateralOffset);
 
-				const FVector& TraceStart = RightLoc;
-				const FVector TraceEnd = VaultRightLoc + (VaultDir * TraceLength);
+			bool bTraceComplex = (TraceType != EVIFBIKTraceType::FTT_Simple) && Significance.bAllowComplexTrace;
+			if (TraceType == EVIFBIKTraceType::FTT_ComplexLocalOnly)
+			{
+				bTraceComplex = Significance.bLocalPlayer;
+			}
 
-				bool bTraceComplex = (TraceType != EVIFBIKTraceType::FTT_Simple);
-				if (TraceType == EVIFBIKTraceType::FTT_ComplexLocalOnly)
-				{
-					bTraceComplex = IsLocalPlayer(PawnOwner);
-				}
+			FVIFBIKTraceRequest Request;
+			Request.Start = RightLoc;
+			Request.End = VaultRightLoc + (VaultDir * TraceLength);
+			Request.Radius = TraceRadius;
+			Request.ObjectQueryParams = FCollisionObjectQueryParams(TraceSettings.GetObjectTypes());
+			Request.QueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(VIFBIKTrace), bTraceComplex, PawnOwner);
+			Request.Priority = Significance.Significance;
+			Request.bExemptFromBudget = Significance.bLocalPlayer;
 
 #if WITH_EDITOR
-				const EDrawDebugTrace::Type DrawDebugType = (bDebugTraceDuringPIE) ? ((UpdateType == EVIFBIKUpdateType::FUT_Single) ? EDrawDebugTrace::ForDuration : EDrawDebugTrace::ForOneFrame) : EDrawDebugTrace::None;
-#else
-				const EDrawDebugTrace::Type DrawDebugType = EDrawDebugTrace::None;
+			Request.bDrawDebug = bDebugTraceDuringPIE;
+			Request.DrawTime = (UpdateType == EVIFBIKUpdateType::FUT_Single) ? 1.f : 0.f;
 #endif  // WITH_EDITOR
 
-				UKismetSystemLibrary::SphereTraceSingleForObjects(
-					PawnOwner,																// World Context
-					TraceStart,																// Start
-					TraceEnd,																// End
-					TraceRadius,															// Radius
-					TraceSettings.GetObjectTypes(),											// TraceChannels
-					bTraceComplex,															// bTraceComplex
-					TraceIgnore,															// ActorsToIgnore
-					DrawDebugType,															// DrawDebugType
-					Hit,																	// OutHit
-					false,																	// bIgnoreSelf
-					FLinearColor::Yellow,													// TraceColor
-					FLinearColor::Blue,														// TraceHitColor
-					1.f																		// DrawTime
-				);
-
-				if (Hit.bBlockingHit)
-				{
-					Hit.Location += Hit.ImpactNormal * BoneOffset;
-				}
-			}
+			FVIFBIKTraceBatch::Get().QueueTrace(MeshComp, this, MoveTemp(Request));
+		}
+		else
+		{
+			UVIBlueprintFunctionLibrary::MessageLogError(FString::Printf(TEXT("{ %s } does not implement interface VIAnimationInterface. Aborting FBIK update."), *MeshComp->GetAnimInstance()->GetName()));
+		}
+	}
+}
 
-			if (Hit.bBlockingHit)
-			{
-				IVIAnimationInterface::Execute_SetBoneFBIK(MeshComp->GetAnimInstance(), BoneName, Hit.Location, true);
-			}
-			else if (bDisableIfHitFails)
+void UVIAnimNotifyState_FBIK::ApplyFBIK(USkeletalMeshComponent* MeshComp, float DeltaTime)
+{
+	if (!MeshComp || !MeshComp->GetAnimInstance())
+	{
+		return;
+	}
+
+	// No slot if the notify didn't begin for this role
+	FVIFBIKTraceSlot* const Slot = FVIFBIKTraceBatch::Get().FindSlot(MeshComp, this);
+	if (!Slot || Slot->bCulled)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_VAULTFBIK_APPLY);
+
+	UAnimInstance* const AnimInstance = MeshComp->GetAnimInstance();
+	if (!AnimInstance->Implements<UVIAnimationInterface>())
+	{
+		return;
+	}
+
+	bool bDirty = false;
+	if (Slot->bHasNewResult)
+	{
+		Slot->bHasNewResult = false;
+
+		if (Slot->Result.bBlockingHit)
+		{
+			Slot->TargetLocation = Slot->Result.Location + Slot->Result.ImpactNormal * BoneOffset;
+			if (!Slot->bPlaced)
 			{
-				// We generally leave it enabled if there was no hit and just use the last successful hit
-				// but here the user has specified to disable it
-				IVIAnimationInterface::Execute_SetBoneFBIK(MeshComp->GetAnimInstance(), BoneName, FVector::ZeroVector, false);
+				// Nothing to blend from
+				Slot->bPlaced = true;
+				Slot->PlacedLocation = Slot->TargetLocation;
+				bDirty = true;
 			}
 		}
-		else
+		else if (bDisableIfHitFails && Slot->bPlaced)
 		{
-			UVIBlueprintFunctionLibrary::MessageLogError(FString::Printf(TEXT("{ %s } does not implement interface VIAnimationInterface. Aborting FBIK update."), *MeshComp->GetAnimInstance()->GetName()));
+			// We generally leave it enabled if there was no hit and just use the last successful hit
+			// but here the user has specified to disable it
+			Slot->bPlaced = false;
+			SetBoneFBIK(AnimInstance, *Slot, FVector::ZeroVector, false);
 		}
 	}
+
+	if (!Slot->bPlaced)
+	{
+		return;
+	}
+
+	if (!Slot->PlacedLocation.Equals(Slot->TargetLocation))
+	{
+		Slot->PlacedLocation = (HitInterpSpeed > 0.f) ? FMath::VInterpTo(Slot->PlacedLocation, Slot->TargetLocation, DeltaTime, HitInterpSpeed) : Slot->TargetLocation;
+		bDirty = true;
+	}
+
+	if (bDirty)
+	{
+		SetBoneFBIK(AnimInstance, *Slot, Slot->PlacedLocation, true);
+	}
+}
+
+void UVIAnimNotifyState_FBIK::SetBoneFBIK(UAnimInstance* AnimInstance, const FVIFBIKTraceSlot& Slot, const FVector& Location, bool bEnabled) const
+{
+	// The anim instance can be swapped while the notify is active
+	UVIAnimInstance* const VIAnimInstance = (Slot.AnimFBIKSlot != INDEX_NONE) ? Cast<UVIAnimInstance>(AnimInstance) : nullptr;
+	if (VIAnimInstance)
+	{
+		VIAnimInstance->SetBoneFBIKSlot(Slot.AnimFBIKSlot, Location, bEnabled);
+	}
+	else
+	{
+		IVIAnimationInterface::Execute_SetBoneFBIK(AnimInstance, BoneName, Location, bEnabled);
+	}
 }
 
 APawn* UVIAnimNotifyState_FBIK::GetPawnOwner(const USkeletalMeshComponent* const MeshComp)
@@ -0,0 +1,430 @@
+// Copyright (c) 2019-2022 Drowning Dragons Limited. All Rights Reserved.
+
+#include "Animation/VIFBIKTraceBatch.h"
+#include "Animation/VIAnimNotifyState_FBIK.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "DrawDebugHelpers.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "VITypes.h"
+
+DECLARE_CYCLE_STAT(TEXT("FBIK Trace Batch"), STAT_VAULTFBIK_TRACEBATCH, STATGROUP_VaultIt);
+DECLARE_DWORD_COUNTER_STAT(TEXT("FBIK Traces"), STAT_VAULTFBIK_TRACES, STATGROUP_VaultIt);
+DECLARE_DWORD_COUNTER_STAT(TEXT("FBIK Traces Deferred"), STAT_VAULTFBIK_TRACES_DEFERRED, STATGROUP_VaultIt);
+DECLARE_DWORD_COUNTER_STAT(TEXT("FBIK Culled"), STAT_VAULTFBIK_CULLED, STATGROUP_VaultIt);
+
+static TAutoConsoleVariable<int32> CVarFBIKAsyncTraces(
+	TEXT("VI.FBIK.AsyncTraces"),
+	1,
+	TEXT("If 1, FBIK surface traces of every notify are issued as one batch of async traces after actors tick and used the next frame. 0 traces synchronously")
+);
+
+static TAutoConsoleVariable<int32> CVarFBIKTraceBudget(
+	TEXT("VI.FBIK.TraceBudget"),
+	16,
+	TEXT("Max FBIK traces issued per frame across every world, the local player's are always issued and the rest go out by significance. 0 is unlimited")
+);
+
+static TAutoConsoleVariable<float> CVarFBIKBudgetAgingRate(
+	TEXT("VI.FBIK.BudgetAgingRate"),
+	0.25f,
+	TEXT("Priority added to an FBIK trace for every frame it waited on the budget, so less significant meshes still get updated")
+);
+
+static TAutoConsoleVariable<float> CVarFBIKMaxDistance(
+	TEXT("VI.FBIK.MaxDistance"),
+	5000.f,
+	TEXT("FBIK is off for meshes further than this from every local camera. 0 is unlimited")
+);
+
+static TAutoConsoleVariable<float> CVarFBIKMinScreenSize(
+	TEXT("VI.FBIK.MinScreenSize"),
+	0.05f,
+	TEXT("FBIK is off for meshes with a smaller screen size (bounds diameter over screen height)")
+);
+
+static TAutoConsoleVariable<float> CVarFBIKFullScreenSize(
+	TEXT("VI.FBIK.FullScreenSize"),
+	0.5f,
+	TEXT("Screen size at which a mesh gets full FBIK significance")
+);
+
+static TAutoConsoleVariable<int32> CVarFBIKMaxExtraTickSkip(
+	TEXT("VI.FBIK.MaxExtraTickSkip"),
+	6,
+	TEXT("Ticks skipped between FBIK traces on top of the notify's TickSkipAmount, scaled by how insignificant the mesh is")
+);
+
+static TAutoConsoleVariable<float> CVarFBIKComplexTraceSignificance(
+	TEXT("VI.FBIK.ComplexTraceSignificance"),
+	0.5f,
+	TEXT("Below this significance FBIK traces use collision instead of geometry")
+);
+
+static TAutoConsoleVariable<int32> CVarFBIKCullHidden(
+	TEXT("VI.FBIK.CullHidden"),
+	1,
+	TEXT("If 1, FBIK is off for meshes that weren't rendered recently")
+);
+
+FVIFBIKTraceBatch& FVIFBIKTraceBatch::Get()
+{
+	static FVIFBIKTraceBatch Batch;
+	return Batch;
+}
+
+FVIFBIKTraceSlot& FVIFBIKTraceBatch::BeginSlot(const USkeletalMeshComponent* Mesh, const UVIAnimNotifyState_FBIK* Notify)
+{
+	check(IsInGameThread());
+
+	FVIFBIKTraceSlot& Slot = Slots.FindOrAdd({ FObjectKey(Mesh), FObjectKey(Notify) });
+	const int32 NumBegun = Slot.NumBegun;
+
+	Slot = FVIFBIKTraceSlot();
+	Slot.NumBegun = NumBegun + 1;
+
+	return Slot;
+}
+
+FVIFBIKTraceSlot* FVIFBIKTraceBatch::FindSlot(const USkeletalMeshComponent* Mesh, const UVIAnimNotifyState_FBIK* Notify)
+{
+	return Slots.Find({ FObjectKey(Mesh), FObjectKey(Notify) });
+}
+
+bool FVIFBIKTraceBatch::RemoveSlot(const USkeletalMeshComponent* Mesh, const UVIAnimNotifyState_FBIK* Notify)
+{
+	const FSlotKey Key = { FObjectKey(Mesh), FObjectKey(Notify) };
+
+	FVIFBIKTraceSlot* Slot = Slots.Find(Key);
+	if (Slot && --Slot->NumBegun > 0)
+	{
+		return false;
+	}
+
+	// Traces in flight for it are ignored when they complete
+	Slots.Remove(Key);
+	return true;
+}
+
+void FVIFBIKTraceBatch::UpdateViewPoints(const UWorld* World)
+{
+	ViewPoints.Reset();
+	ViewPointsWorld = World;
+	ViewPointsFrame = GFrameCounter;
+
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PC = It->Get();
+		if (PC && PC->IsLocalController() && PC->PlayerCameraManager)
+		{
+			const float HalfFOV = FMath::DegreesToRadians(FMath::Clamp(PC->PlayerCameraManager->GetFOVAngle(), 1.f, 170.f) * 0.5f);
+			ViewPoints.Add({ PC->PlayerCameraManager->GetCameraLocation(), FMath::Tan(HalfFOV) });
+		}
+	}
+}
+
+FVIFBIKSignificance FVIFBIKTraceBatch::ComputeSignificance(const USkeletalMeshComponent* Mesh, bool bLocalPlayer, uint8 TickSkipAmount)
+{
+	FVIFBIKSignificance Result;
+	Result.TickSkipAmount = TickSkipAmount;
+	Result.bLocalPlayer = bLocalPlayer;
+
+	// Hand placement stays crisp for the local player
+	const UWorld* World = Mesh ? Mesh->GetWorld() : nullptr;
+	if (bLocalPlayer || !World)
+	{
+		return Result;
+	}
+
+	if (ViewPointsFrame != GFrameCounter || ViewPointsWorld.Get() != World)
+	{
+		UpdateViewPoints(World);
+	}
+
+	// Nobody is looking, eg. a server with no local players
+	if (ViewPoints.Num() == 0)
+	{
+		return Result;
+	}
+
+	if (CVarFBIKCullHidden.GetValueOnGameThread() && !Mesh->WasRecentlyRendered(0.2f))
+	{
+		Result.Significance = 0.f;
+		INC_DWORD_STAT(STAT_VAULTFBIK_CULLED);
+		return Result;
+	}
+
+	// Same as ComputeBoundsScreenSize(), bounds diameter over screen height
+	const float MaxDistance = CVarFBIKMaxDistance.GetValueOnGameThread();
+	float ScreenSize = 0.f;
+	for (const FViewPoint& ViewPoint : ViewPoints)
+	{
+		const float Distance = FVector::Dist(ViewPoint.Location, Mesh->Bounds.Origin);
+		if (MaxDistance > 0.f && Distance > MaxDistance)
+		{
+			continue;
+		}
+
+		ScreenSize = FMath::Max(ScreenSize, Mesh->Bounds.SphereRadius / FMath::Max(Distance * ViewPoint.TanHalfFOV, 1.f));
+	}
+
+	if (ScreenSize <= 0.f || ScreenSize < CVarFBIKMinScreenSize.GetValueOnGameThread())
+	{
+		Result.Significance = 0.f;
+		INC_DWORD_STAT(STAT_VAULTFBIK_CULLED);
+		return Result;
+	}
+
+	const float FullScreenSize = FMath::Max(CVarFBIKFullScreenSize.GetValueOnGameThread(), KINDA_SMALL_NUMBER);
+	Result.Significance = FMath::Clamp(ScreenSize / FullScreenSize, KINDA_SMALL_NUMBER, 1.f);
+
+	const int32 MaxExtraTickSkip = FMath::Max(CVarFBIKMaxExtraTickSkip.GetValueOnGameThread(), 0);
+	Result.TickSkipAmount = FMath::Min<int32>(TickSkipAmount + FMath::RoundToInt((1.f - Result.Significance) * MaxExtraTickSkip), MAX_uint8);
+
+	Result.bAllowComplexTrace = Result.Significance >= CVarFBIKComplexTraceSignificance.GetValueOnGameThread();
+
+	return Result;
+}
+
+void FVIFBIKTraceBatch::QueueTrace(const USkeletalMeshComponent* Mesh, const UVIAnimNotifyState_FBIK* Notify, FVIFBIKTraceRequest&& Request)
+{
+	UWorld* World = Mesh ? Mesh->GetWorld() : nullptr;
+	if (!World)
+	{
+		return;
+	}
+
+	const FSlotKey Key = { FObjectKey(Mesh), FObjectKey(Notify) };
+	FVIFBIKTraceSlot& Slot = Slots.FindOrAdd(Key);
+
+	if (CVarFBIKAsyncTraces.GetValueOnGameThread() == 0)
+	{
+		// No next frame to defer to, traces over budget are dropped and the bone keeps its last placement
+		int32& NumIssued = GetIssuedTraces();
+		const int32 Budget = CVarFBIKTraceBudget.GetValueOnGameThread();
+		if (!Request.bExemptFromBudget && Budget > 0 && NumIssued >= Budget)
+		{
+			INC_DWORD_STAT(STAT_VAULTFBIK_TRACES_DEFERRED);
+			return;
+		}
+		NumIssued++;
+
+		INC_DWORD_STAT(STAT_VAULTFBIK_TRACES);
+
+		Slot.Result = FHitResult(ForceInit);
+		World->SweepSingleByObjectType(Slot.Result, Request.Start, Request.End, FQuat::Identity, Request.ObjectQueryParams, FCollisionShape::MakeSphere(Request.Radius), Request.QueryParams);
+		Slot.bHasNewResult = true;
+
+		if (Request.bDrawDebug)
+		{
+			DrawDebugTrace(World, Request, Slot.Result);
+		}
+		return;
+	}
+
+	// Only one trace per slot goes out each frame
+	if (!Slot.PendingRequest.IsSet())
+	{
+		Queued.Add(Key);
+	}
+
+	Slot.World = World;
+	Slot.PendingRequest = MoveTemp(Request);
+}
+
+int32& FVIFBIKTraceBatch::GetIssuedTraces()
+{
+	if (IssuedTracesFrame != GFrameCounter)
+	{
+		IssuedTracesFrame = GFrameCounter;
+		IssuedTraces = 0;
+	}
+
+	return IssuedTraces;
+}
+
+void FVIFBIKTraceBatch::RegisterDelegates()
+{
+	TraceDelegate.BindRaw(this, &FVIFBIKTraceBatch::OnTraceCompleted);
+	WorldPostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddRaw(this, &FVIFBIKTraceBatch::OnWorldPostActorTick);
+}
+
+void FVIFBIKTraceBatch::UnregisterDelegates()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(WorldPostActorTickHandle);
+	TraceDelegate.Unbind();
+
+	Slots.Empty();
+	InFlight.Empty();
+	Queued.Empty();
+}
+
+void FVIFBIKTraceBatch::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	// Meshes destroyed mid notify never end it. Every world ticking this frame shares the slots, so once is enough
+	if (PruneFrame != GFrameCounter)
+	{
+		PruneFrame = GFrameCounter;
+		for (auto It = Slots.CreateIterator(); It; ++It)
+		{
+			if (!It.Key().Mesh.ResolveObjectPtr())
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	if (Queued.Num() == 0)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_VAULTFBIK_TRACEBATCH);
+
+	const float AgingRate = CVarFBIKBudgetAgingRate.GetValueOnGameThread();
+
+	Candidates.Reset();
+	for (int32 Idx = Queued.Num() - 1; Idx >= 0; Idx--)
+	{
+		const FSlotKey& Key = Queued[Idx];
+		const FVIFBIKTraceSlot* Slot = Slots.Find(Key);
+		if (!Slot || !Slot->PendingRequest.IsSet() || !Slot->World.IsValid())
+		{
+			Queued.RemoveAtSwap(Idx, 1, false);
+			continue;
+		}
+
+		if (Slot->World.Get() == World)
+		{
+			const FVIFBIKTraceRequest& Request = Slot->PendingRequest.GetValue();
+			Candidates.Add({ Key, Request.Priority + Slot->FramesDeferred * AgingRate, Request.bExemptFromBudget });
+		}
+	}
+
+	if (Candidates.Num() == 0)
+	{
+		return;
+	}
+
+	// Most significant first, whatever doesn't fit what's left of the frame's budget after worlds that ticked earlier waits for the next frame
+	int32& NumIssued = GetIssuedTraces();
+	const int32 Budget = CVarFBIKTraceBudget.GetValueOnGameThread();
+	if (Budget > 0 && NumIssued + Candidates.Num() > Budget)
+	{
+		Candidates.Sort([](const FCandidate& A, const FCandidate& B)
+		{
+			return A.bExemptFromBudget != B.bExemptFromBudget ? A.bExemptFromBudget : A.Priority > B.Priority;
+		});
+	}
+
+	for (const FCandidate& Candidate : Candidates)
+	{
+		// A slot reset by NotifyBegin while queued can be queued twice
+		FVIFBIKTraceSlot& Slot = Slots.FindChecked(Candidate.Key);
+		if (!Slot.PendingRequest.IsSet())
+		{
+			continue;
+		}
+
+		if (!Candidate.bExemptFromBudget && Budget > 0 && NumIssued >= Budget)
+		{
+			Slot.FramesDeferred = (uint16)FMath::Min<int32>(Slot.FramesDeferred + 1, MAX_uint16);
+			INC_DWORD_STAT(STAT_VAULTFBIK_TRACES_DEFERRED);
+			continue;
+		}
+
+		IssueTrace(World, Candidate.Key, Slot);
+		NumIssued++;
+	}
+
+	// Issued requests are cleared
+	Queued.RemoveAllSwap([this](const FSlotKey& Key)
+	{
+		const FVIFBIKTraceSlot* Slot = Slots.Find(Key);
+		return !Slot || !Slot->PendingRequest.IsSet();
+	});
+}
+
+void FVIFBIKTraceBatch::IssueTrace(UWorld* World, const FSlotKey& Key, FVIFBIKTraceSlot& Slot)
+{
+	// The previous trace is superseded, drop its result if it's still in flight
+	if (Slot.InFlightId != 0)
+	{
+		InFlight.Remove(Slot.InFlightId);
+	}
+
+	const uint32 TraceId = NextTraceId++;
+	if (NextTraceId == 0)
+	{
+		NextTraceId = 1;
+	}
+
+	const FVIFBIKTraceRequest& Request = Slot.PendingRequest.GetValue();
+	World->AsyncSweepByObjectType(EAsyncTraceType::Single, Request.Start, Request.End, FQuat::Identity, Request.ObjectQueryParams,
+		FCollisionShape::MakeSphere(Request.Radius), Request.QueryParams, &TraceDelegate, TraceId);
+
+	INC_DWORD_STAT(STAT_VAULTFBIK_TRACES);
+
+	Slot.InFlightId = TraceId;
+	Slot.FramesDeferred = 0;
+	InFlight.Add(TraceId, Key);
+
+	// Keep the request for debug drawing until the result arrives
+	if (Request.bDrawDebug)
+	{
+		Slot.InFlightDebugRequest = MoveTemp(Slot.PendingRequest);
+	}
+	else
+	{
+		Slot.InFlightDebugRequest.Reset();
+	}
+	Slot.PendingRequest.Reset();
+}
+
+void FVIFBIKTraceBatch::OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+	FSlotKey Key;
+	if (!InFlight.RemoveAndCopyValue(Datum.UserData, Key))
+	{
+		return;
+	}
+
+	FVIFBIKTraceSlot* Slot = Slots.Find(Key);
+	if (!Slot || Slot->InFlightId != Datum.UserData)
+	{
+		return;
+	}
+
+	Slot->InFlightId = 0;
+	Slot->bHasNewResult = true;
+	Slot->Result = Datum.OutHits.Num() > 0 ? Datum.OutHits[0] : FHitResult(ForceInit);
+
+	if (Slot->InFlightDebugRequest.IsSet())
+	{
+		DrawDebugTrace(Slot->World.Get(), Slot->InFlightDebugRequest.GetValue(), Slot->Result);
+		Slot->InFlightDebugRequest.Reset();
+	}
+}
+
+void FVIFBIKTraceBatch::DrawDebugTrace(const UWorld* World, const FVIFBIKTraceRequest& Request, const FHitResult& Hit)
+{
+#if ENABLE_DRAW_DEBUG
+	if (!World)
+	{
+		return;
+	}
+
+	if (Hit.bBlockingHit)
+	{
+		DrawDebugLine(World, Request.Start, Hit.Location, FColor::Yellow, false, Request.DrawTime);
+		DrawDebugLine(World, Hit.Location, Request.End, FColor::Blue, false, Request.DrawTime);
+		DrawDebugSphere(World, Hit.Location, Request.Radius, 12, FColor::Blue, false, Request.DrawTime);
+	}
+	else
+	{
+		DrawDebugLine(World, Request.Start, Request.End, FColor::Yellow, false, Request.DrawTime);
+		DrawDebugSphere(World, Request.End, Request.Radius, 12, FColor::Yellow, false, Request.DrawTime);
+	}
+#endif
+}
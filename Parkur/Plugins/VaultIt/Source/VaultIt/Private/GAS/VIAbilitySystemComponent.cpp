@@ -4,8 +4,11 @@
 
 #include "AbilitySystemLog.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "GameFramework/PlayerController.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "GAS/VIGameplayAbility.h"
+#include "Pawn/VICharacterBase.h"
 #include "VITypes.h"
 
 DECLARE_CYCLE_STAT(TEXT("VIAbilitySystemComponent Tick"), STAT_VIABILITYSYSTEM_TICK, STATGROUP_VaultIt);
@@ -14,17 +17,28 @@ DECLARE_CYCLE_STAT(TEXT("VIAbilitySystemComponent PlaySimulatedMontageForMesh"),
 DECLARE_CYCLE_STAT(TEXT("VIAbilitySystemComponent UpdateReplicatedDataForMesh"), STAT_VIABILITYSYSTEM_UPDATEREPLDATAFORMESH, STATGROUP_VaultIt);
 DECLARE_CYCLE_STAT(TEXT("VIAbilitySystemComponent OnReplicatedAnimMontageForMesh"), STAT_VIABILITYSYSTEM_ONREPLICATEDANIMMONTAGEFORMESH, STATGROUP_VaultIt);
 
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Net Montage Position Snaps"), STAT_VAULTNET_MONTAGESNAPS, STATGROUP_VaultIt);
+
 static TAutoConsoleVariable<float> CVarReplayMontageErrorThreshold(
 	TEXT("VI.replay.MontageErrorThreshold"),
 	0.5f,
 	TEXT("Tolerance level for when montage playback position correction occurs in replays")
 );
 
+static TAutoConsoleVariable<float> CVarCosmeticMontageDistance(
+	TEXT("VI.net.CosmeticMontageDistance"),
+	0.f,
+	TEXT("Montages of pawns further than this from every viewer are cosmetic only, the server stops sending position updates and simulated proxies do not correct position. 0 to disable")
+);
+
 void UVIAbilitySystemComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(UVIAbilitySystemComponent, RepAnimMontageInfoForMeshes);
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(UVIAbilitySystemComponent, RepAnimMontageInfoForMeshes, Params);
 }
 
 bool UVIAbilitySystemComponent::GetShouldTick() const
@@ -63,6 +77,7 @@ void UVIAbilitySystemComponent::InitAbilityActorInfo(AActor* InOwnerActor, AActo
 
 	LocalAnimMontageInfoForMeshes = TArray<FVIGameplayAbilityLocalAnimMontageForMesh>();
 	RepAnimMontageInfoForMeshes = TArray<FVIGameplayAbilityRepAnimMontageForMesh>();
+	MarkRepAnimMontageInfoDirty();
 
 	if (bPendingMontageRep)
 	{
@@ -124,15 +139,31 @@ float UVIAbilitySystemComponent::PlayMontageForMesh(UGameplayAbility* InAnimatin
 				AnimInstance->Montage_JumpToSection(StartSectionName, NewAnimMontage);
 			}
 
+			// Vault montages may move the character via a root motion source
+			AVICharacterBase* const Character = Cast<AVICharacterBase>(AbilityActorInfo->AvatarActor.Get());
+			if (Character && Character->IsVaultAbility(InAnimatingAbility))
+			{
+				Character->OnVaultMontageStarted(NewAnimMontage, InPlayRate);
+			}
+
 			// Replicate to non owners
 			if (IsOwnerActorAuthoritative())
 			{
+				// Vault montages may be sent to simulated proxies via the compact vault event instead
+				if (bReplicateMontage && Character && Character->ReplicateVaultMontage(InAnimatingAbility, NewAnimMontage, InPlayRate))
+				{
+					bReplicateMontage = false;
+				}
+
+				AnimMontageInfo.bReplicateMontage = bReplicateMontage;
+
 				if (bReplicateMontage)
 				{
 					// Those are static parameters, they are only set when the montage is played. They are not changed after that.
 					FVIGameplayAbilityRepAnimMontageForMesh& AbilityRepMontageInfo = GetGameplayAbilityRepAnimMontageForMesh(InMesh);
 					AbilityRepMontageInfo.RepMontageInfo.AnimMontage = NewAnimMontage;
 					AbilityRepMontageInfo.RepMontageInfo.PlayInstanceId = (AbilityRepMontageInfo.RepMontageInfo.PlayInstanceId + 1) % 255;
+					MarkRepAnimMontageInfoDirty();
 
 					// Update parameters that change during Montage life time.
 					AnimMontage_UpdateReplicatedDataForMesh(InMesh);
@@ -143,6 +174,17 @@ float UVIAbilitySystemComponent::PlayMontageForMesh(UGameplayAbility* InAnimatin
 						AbilityActorInfo->AvatarActor->ForceNetUpdate();
 					}
 				}
+				else
+				{
+					// Simulated proxies must stop the previously replicated montage, the new one isn't replicated
+					FVIGameplayAbilityRepAnimMontageForMesh& AbilityRepMontageInfo = GetGameplayAbilityRepAnimMontageForMesh(InMesh);
+					if (AbilityRepMontageInfo.RepMontageInfo.AnimMontage && !AbilityRepMontageInfo.RepMontageInfo.IsStopped)
+					{
+						AbilityRepMontageInfo.RepMontageInfo.IsStopped = true;
+						MarkRepAnimMontageInfoDirty();
+						UpdateShouldTick();
+					}
+				}
 			}
 			else
 			{
@@ -254,8 +296,11 @@ void UVIAbilitySystemComponent::AnimMontage_UpdateReplicatedDataForMesh(FVIGamep
 		AbilityActorInfo->AvatarActor ? OutRepAnimMontageInfo.Mesh->GetAnimInstance() : nullptr;
 	const FVIGameplayAbilityLocalAnimMontageForMesh& AnimMontageInfo = GetLocalAnimMontageInfoForMesh(OutRepAnimMontageInfo.Mesh);
 
-	if (AnimInstance && AnimMontageInfo.LocalMontageInfo.AnimMontage)
+	if (AnimInstance && AnimMontageInfo.LocalMontageInfo.AnimMontage && AnimMontageInfo.bReplicateMontage)
 	{
+		// Only mark for replication if something changed
+		const FGameplayAbilityRepAnimMontage PreviousRepMontageInfo = OutRepAnimMontageInfo.RepMontageInfo;
+
 		OutRepAnimMontageInfo.RepMontageInfo.AnimMontage = AnimMontageInfo.LocalMontageInfo.AnimMontage;
 
 		// Compressed Flags
@@ -301,6 +346,18 @@ void UVIAbilitySystemComponent::AnimMontage_UpdateReplicatedDataForMesh(FVIGamep
 		{
 			OutRepAnimMontageInfo.RepMontageInfo.NextSectionID = 0;
 		}
+
+		const FGameplayAbilityRepAnimMontage& RepMontageInfo = OutRepAnimMontageInfo.RepMontageInfo;
+		// Position alone doesn't need sending if no viewer is close enough to correct it
+		if (RepMontageInfo.AnimMontage != PreviousRepMontageInfo.AnimMontage ||
+			RepMontageInfo.PlayRate != PreviousRepMontageInfo.PlayRate ||
+			(RepMontageInfo.Position != PreviousRepMontageInfo.Position && !IsCosmeticOnlyForViewers()) ||
+			RepMontageInfo.BlendTime != PreviousRepMontageInfo.BlendTime ||
+			RepMontageInfo.IsStopped != PreviousRepMontageInfo.IsStopped ||
+			RepMontageInfo.NextSectionID != PreviousRepMontageInfo.NextSectionID)
+		{
+			MarkRepAnimMontageInfoDirty();
+		}
 	}
 }
 
@@ -308,6 +365,11 @@ void UVIAbilitySystemComponent::OnRep_ReplicatedAnimMontageForMesh()
 {
 	SCOPE_CYCLE_COUNTER(STAT_VIABILITYSYSTEM_ONREPLICATEDANIMMONTAGEFORMESH);
 
+	// Distant proxies only need to play and stop montages
+	const bool bCosmeticOnly = IsCosmeticOnlyForViewers();
+
+	const AVICharacterBase* const Character = AbilityActorInfo.IsValid() ? Cast<AVICharacterBase>(AbilityActorInfo->AvatarActor.Get()) : nullptr;
+
 	for (FVIGameplayAbilityRepAnimMontageForMesh& NewRepMontageInfoForMesh : RepAnimMontageInfoForMeshes)
 	{
 		FVIGameplayAbilityLocalAnimMontageForMesh& AnimMontageInfo = GetLocalAnimMontageInfoForMesh(NewRepMontageInfoForMesh.Mesh);
@@ -333,6 +395,12 @@ void UVIAbilitySystemComponent::OnRep_ReplicatedAnimMontageForMesh()
 		}
 		bPendingMontageRep = false;
 
+		// Replays rebuild vaults from the character's replay vault event instead
+		if (bIsPlayingReplay && Character && Character->IsVaultEventMontage(NewRepMontageInfoForMesh.RepMontageInfo.AnimMontage))
+		{
+			continue;
+		}
+
 		if (!AbilityActorInfo->IsLocallyControlled())
 		{
 			static const auto CVar = IConsoleManager::Get().FindTConsoleVariableDataInt(TEXT("net.Montage.Debug"));
@@ -386,7 +454,7 @@ void UVIAbilitySystemComponent::OnRep_ReplicatedAnimMontageForMesh()
 						CurrentMontageStopForMesh(NewRepMontageInfoForMesh.Mesh, NewRepMontageInfoForMesh.RepMontageInfo.BlendTime);
 					}
 				}
-				else if (!NewRepMontageInfoForMesh.RepMontageInfo.SkipPositionCorrection)
+				else if (!NewRepMontageInfoForMesh.RepMontageInfo.SkipPositionCorrection && !bCosmeticOnly)
 				{
 					const int32 RepSectionID = AnimMontageInfo.LocalMontageInfo.AnimMontage->GetSectionIndexFromPosition(NewRepMontageInfoForMesh.RepMontageInfo.Position);
 					const int32 RepNextSectionID = int32(NewRepMontageInfoForMesh.RepMontageInfo.NextSectionID) - 1;
@@ -409,6 +477,8 @@ void UVIAbilitySystemComponent::OnRep_ReplicatedAnimMontageForMesh()
 							// Client is in a wrong section, teleport him into the begining of the right section
 							const float SectionStartTime = AnimMontageInfo.LocalMontageInfo.AnimMontage->GetAnimCompositeSection(RepSectionID).GetTime();
 							AnimInstance->Montage_SetPosition(AnimMontageInfo.LocalMontageInfo.AnimMontage, SectionStartTime);
+							INC_DWORD_STAT(STAT_VAULTNET_MONTAGESNAPS);
+							INC_VI_NET_COUNTER(MontageSnaps);
 						}
 					}
 
@@ -434,6 +504,8 @@ void UVIAbilitySystemComponent::OnRep_ReplicatedAnimMontageForMesh()
 							}
 						}
 						AnimInstance->Montage_SetPosition(AnimMontageInfo.LocalMontageInfo.AnimMontage, NewRepMontageInfoForMesh.RepMontageInfo.Position);
+						INC_DWORD_STAT(STAT_VAULTNET_MONTAGESNAPS);
+						INC_VI_NET_COUNTER(MontageSnaps);
 					}
 				}
 			}
@@ -468,9 +540,50 @@ FVIGameplayAbilityRepAnimMontageForMesh& UVIAbilitySystemComponent::GetGameplayA
 
 	const FVIGameplayAbilityRepAnimMontageForMesh RepMontageInfo = FVIGameplayAbilityRepAnimMontageForMesh(InMesh);
 	RepAnimMontageInfoForMeshes.Add(RepMontageInfo);
+	MarkRepAnimMontageInfoDirty();
 	return RepAnimMontageInfoForMeshes.Last();
 }
 
+void UVIAbilitySystemComponent::MarkRepAnimMontageInfoDirty()
+{
+	MARK_PROPERTY_DIRTY_FROM_NAME(UVIAbilitySystemComponent, RepAnimMontageInfoForMeshes, this);
+}
+
+bool UVIAbilitySystemComponent::IsCosmeticOnlyForViewers() const
+{
+	const float CosmeticDistance = CVarCosmeticMontageDistance.GetValueOnGameThread();
+	const AActor* const Avatar = AbilityActorInfo.IsValid() ? AbilityActorInfo->AvatarActor.Get() : nullptr;
+	if (CosmeticDistance <= 0.f || !Avatar || !GetWorld())
+	{
+		return false;
+	}
+
+	// Every player on the server, only local players on clients
+	bool bHasViewer = false;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* const PC = It->Get();
+
+		// Our own controller plays the montage itself
+		if (!PC || PC->GetPawn() == Avatar)
+		{
+			continue;
+		}
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		if (FVector::DistSquared(ViewLocation, Avatar->GetActorLocation()) <= FMath::Square(CosmeticDistance))
+		{
+			return false;
+		}
+
+		bHasViewer = true;
+	}
+
+	return bHasViewer;
+}
+
 void UVIAbilitySystemComponent::OnPredictiveMontageRejectedForMesh(
 	USkeletalMeshComponent* const InMesh, UAnimMontage* const PredictiveMontage)
 {
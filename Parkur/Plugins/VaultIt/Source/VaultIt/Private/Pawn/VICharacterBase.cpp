@@ -2,11 +2,26 @@
 
 #include "Pawn/VICharacterBase.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/GameStateBase.h"
+#include "Animation/AnimInstance.h"
+#include "Abilities/GameplayAbility.h"
 #include "Pawn/VIPawnVaultComponent.h"
+#include "Pawn/VIRootMotionSource_Vault.h"
+#include "Pawn/VICharacterMovementComponent.h"
+#include "GAS/VIAbilitySystemComponent.h"
 #include "VIMotionWarpingComponent.h"
 #include "VIBlueprintFunctionLibrary.h"
 
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Net Vault Events Sent"), STAT_VAULTNET_EVENTS, STATGROUP_VaultIt);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Net Vault Requests Rejected"), STAT_VAULTNET_REQUESTSREJECTED, STATGROUP_VaultIt);
+
+AVICharacterBase::AVICharacterBase(const FObjectInitializer& OI)
+	: Super(OI.SetDefaultSubobjectClass<UVICharacterMovementComponent>(ACharacter::CharacterMovementComponentName))
+{
+}
+
 void AVICharacterBase::BeginPlay()
 {
 	Super::BeginPlay();
@@ -20,9 +35,31 @@ void AVICharacterBase::CheckJumpInput(float DeltaTime)
 	const bool bIsVaulting = IsVaulting();
 
 	// Server update simulated proxies with correct vaulting state
-	if (GetLocalRole() == ROLE_Authority && GetNetMode() != NM_Standalone)
+	if (GetLocalRole() == ROLE_Authority && GetNetMode() != NM_Standalone && bRepIsVaulting != bIsVaulting)
 	{
 		bRepIsVaulting = bIsVaulting;
+		MARK_PROPERTY_DIRTY_FROM_NAME(AVICharacterBase, bRepIsVaulting, this);
+
+		if (bIsVaulting)
+		{
+			INC_VI_NET_COUNTER(VaultsStarted);
+		}
+	}
+
+	// Perform vaults sent by the client with this move
+	if (GetLocalRole() == ROLE_Authority && !IsLocallyControlled() && VaultComponent)
+	{
+		FVIVaultInfo VaultInfo;
+		UVICharacterMovementComponent* VIMovement = Cast<UVICharacterMovementComponent>(GetCharacterMovement());
+		if (VIMovement && VIMovement->ConsumeVaultRequest(VaultInfo))
+		{
+			// Rejecting corrects the client out of the vault
+			if (!IVIPawnInterface::Execute_CanVault(this) || !VaultComponent->ComputeAntiCheatResult(VaultInfo) || !ExecuteVault(VaultInfo))
+			{
+				INC_DWORD_STAT(STAT_VAULTNET_REQUESTSREJECTED);
+				INC_VI_NET_COUNTER(VaultRequestsRejected);
+			}
+		}
 	}
 
 	// Try to vault from local input
@@ -63,8 +100,30 @@ void AVICharacterBase::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& Out
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME_CONDITION(AVICharacterBase, bRepIsVaulting, COND_SimulatedOnly);
-	DOREPLIFETIME_CONDITION(AVICharacterBase, RepMotionMatch, COND_SimulatedOnly);
+	// The compact vault event replaces the individual vault properties, and the replay vault event replaces both in replays
+	const ELifetimeCondition SimulatedCondition = bUseReplayVaultEvent ? COND_SimulatedOrPhysicsNoReplay : COND_SimulatedOnly;
+	const ELifetimeCondition VaultCondition = bUseCompactVaultEvent ? COND_Never : SimulatedCondition;
+	const ELifetimeCondition VaultEventCondition = bUseCompactVaultEvent ? SimulatedCondition : COND_Never;
+	const ELifetimeCondition ReplayVaultEventCondition = bUseReplayVaultEvent ? COND_ReplayOnly : COND_Never;
+
+	// Push based so idle pawns cost nothing to consider for replication
+	FDoRepLifetimeParams VaultParams;
+	VaultParams.bIsPushBased = true;
+	VaultParams.Condition = VaultCondition;
+
+	FDoRepLifetimeParams VaultEventParams;
+	VaultEventParams.bIsPushBased = true;
+	VaultEventParams.Condition = VaultEventCondition;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(AVICharacterBase, bRepIsVaulting, VaultParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AVICharacterBase, RepMotionMatch, VaultParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AVICharacterBase, RepVaultEvent, VaultEventParams);
+
+	FDoRepLifetimeParams ReplayVaultEventParams;
+	ReplayVaultEventParams.bIsPushBased = true;
+	ReplayVaultEventParams.Condition = ReplayVaultEventCondition;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(AVICharacterBase, ReplayVaultEvent, ReplayVaultEventParams);
 }
 
 void AVICharacterBase::Jump()
@@ -103,21 +162,37 @@ void AVICharacterBase::StopJumping()
 void AVICharacterBase::StartVaultAbility_Implementation()
 {
 	// Called by GA_Vault
-	// Need to be in flying mode to have root motion on Z axis
+	// Need to be in vault or flying mode to have root motion on Z axis
 	if (GetCharacterMovement() && GetLocalRole() > ROLE_SimulatedProxy)
 	{
-		GetCharacterMovement()->SetMovementMode(MOVE_Flying);
+		if (UVICharacterMovementComponent* VIMovement = Cast<UVICharacterMovementComponent>(GetCharacterMovement()))
+		{
+			VIMovement->StartVaultMovement();
+		}
+		else
+		{
+			GetCharacterMovement()->SetMovementMode(MOVE_Flying);
+		}
 	}
 }
 
 void AVICharacterBase::StopVaultAbility()
 {
+	RemoveVaultRootMotionSource();
+
 	// Called by CheckJumpInput()
-	// Exiting flying mode
+	// Exiting vault or flying mode
 	// This may put is straight into falling if we aren't properly grounded, which is fine
 	if (GetCharacterMovement() && GetLocalRole() > ROLE_SimulatedProxy)
 	{
-		GetCharacterMovement()->SetMovementMode(GetCharacterMovement()->GetGroundMovementMode());
+		if (UVICharacterMovementComponent* VIMovement = Cast<UVICharacterMovementComponent>(GetCharacterMovement()))
+		{
+			VIMovement->StopVaultMovement();
+		}
+		else
+		{
+			GetCharacterMovement()->SetMovementMode(GetCharacterMovement()->GetGroundMovementMode());
+		}
 	}
 
 	OnStopVaultAbility();
@@ -130,11 +205,356 @@ void AVICharacterBase::OnRep_MotionMatch()
 	MotionWarping->AddOrUpdateSyncPoint(TEXT("VaultSyncPoint"), FVIMotionWarpingSyncPoint(RepMotionMatch.Location, RepMotionMatch.Direction.ToOrientationQuat()));
 }
 
+void AVICharacterBase::ReplicateVaultInfo(const FVIVaultInfo& VaultInfo)
+{
+	PendingVaultEventSeed = VaultInfo.RandomSeed;
+	IVIPawnInterface::Execute_ReplicateMotionMatch(this, FVIRepMotionMatch(VaultInfo.Location, VaultInfo.Direction));
+}
+
+bool AVICharacterBase::ReplicateVaultMontage(UGameplayAbility* AnimatingAbility, UAnimMontage* Montage, float PlayRate)
+{
+	if (!HasAuthority() || !Montage)
+	{
+		return false;
+	}
+
+	// Only the vault ability is sent via the vault event
+	if (!IsVaultAbility(AnimatingAbility))
+	{
+		return false;
+	}
+
+	if (bUseReplayVaultEvent)
+	{
+		RecordReplayVaultEvent(Montage, PlayRate);
+	}
+
+	if (bUseCompactVaultEvent)
+	{
+		SendVaultEvent(Montage, PlayRate);
+	}
+
+	// Consumed by this vault whichever events were sent, so it never leaks into the next one
+	PendingVaultEventSeed = 0;
+
+	return bUseCompactVaultEvent;
+}
+
+void AVICharacterBase::SendVaultEvent(UAnimMontage* Montage, float PlayRate)
+{
+	FillVaultEvent(RepVaultEvent, Montage, PlayRate);
+
+	MARK_PROPERTY_DIRTY_FROM_NAME(AVICharacterBase, RepVaultEvent, this);
+	ForceNetUpdate();
+
+	INC_DWORD_STAT(STAT_VAULTNET_EVENTS);
+	INC_VI_NET_COUNTER(VaultEventsSent);
+}
+
+void AVICharacterBase::RecordReplayVaultEvent(UAnimMontage* Montage, float PlayRate)
+{
+	FillVaultEvent(ReplayVaultEvent, Montage, PlayRate);
+	MARK_PROPERTY_DIRTY_FROM_NAME(AVICharacterBase, ReplayVaultEvent, this);
+}
+
+void AVICharacterBase::FillVaultEvent(FVIRepVaultEvent& VaultEvent, UAnimMontage* Montage, float PlayRate) const
+{
+	VaultEvent.Location = RepMotionMatch.Location;
+	VaultEvent.Direction = RepMotionMatch.Direction;
+	VaultEvent.Montage = Montage;
+	VaultEvent.PlayRate = PlayRate;
+	VaultEvent.RandomSeed = PendingVaultEventSeed;
+	VaultEvent.ServerTimestamp = GetServerWorldTimeSeconds();
+
+	// Never use 0 so the initial value is never mistaken for a vault
+	VaultEvent.EventId = FMath::Max<uint8>(1, VaultEvent.EventId + 1);
+}
+
+bool AVICharacterBase::IsVaultEventMontage(const UAnimMontage* Montage) const
+{
+	const FVIRepVaultEvent* const VaultEvent = GetActiveVaultEvent();
+	return VaultEvent && Montage && Montage == VaultEvent->Montage;
+}
+
+const FVIRepVaultEvent* AVICharacterBase::GetActiveVaultEvent() const
+{
+	if (bUseReplayVaultEvent && GetWorld() && GetWorld()->IsPlayingReplay())
+	{
+		return &ReplayVaultEvent;
+	}
+
+	return bUseCompactVaultEvent ? &RepVaultEvent : nullptr;
+}
+
+bool AVICharacterBase::IsVaultAbility(const UGameplayAbility* Ability) const
+{
+	return Ability && VaultComponent && VaultComponent->VaultAbility && Ability->IsA(VaultComponent->VaultAbility);
+}
+
+void AVICharacterBase::OnVaultMontageStarted(UAnimMontage* Montage, float PlayRate)
+{
+	if (bUseRootMotionSource && GetLocalRole() > ROLE_SimulatedProxy)
+	{
+		ApplyVaultRootMotionSource(Montage, PlayRate);
+	}
+}
+
+bool AVICharacterBase::ExecuteVault(const FVIVaultInfo& VaultInfo)
+{
+	UVIAbilitySystemComponent* const VIASC = VaultComponent ? Cast<UVIAbilitySystemComponent>(VaultComponent->ASC) : nullptr;
+	USkeletalMeshComponent* const VaultMesh = IVIPawnInterface::Execute_GetMeshForVaultMontage(this);
+	if (!VIASC || !VaultMesh || !VaultMesh->GetAnimInstance() || !VaultInfo.IsValid())
+	{
+		return false;
+	}
+
+	// Client and server select the same montage from the same vault info
+	UAnimMontage* const Montage = UVIBlueprintFunctionLibrary::SelectVaultMontage(IVIPawnInterface::Execute_GetVaultAnimSet(this), VaultInfo.Height, VaultInfo.RandomSeed);
+	if (!Montage)
+	{
+		return false;
+	}
+
+	// Sync point must exist before the montage starts warping
+	if (MotionWarping)
+	{
+		MotionWarping->AddOrUpdateSyncPoint(TEXT("VaultSyncPoint"), FVIMotionWarpingSyncPoint(VaultInfo.Location, VaultInfo.Direction.ToOrientationQuat()));
+	}
+
+	ReplicateVaultInfo(VaultInfo);
+
+	// Compact vault event is sent below instead of replicating the montage
+	const float Duration = VIASC->PlayMontageForMesh(nullptr, VaultMesh, FGameplayAbilityActivationInfo(), Montage, 1.f, NAME_None, !bUseCompactVaultEvent);
+	if (Duration <= 0.f)
+	{
+		PendingVaultEventSeed = 0;
+		return false;
+	}
+
+	if (bUseReplayVaultEvent && HasAuthority())
+	{
+		RecordReplayVaultEvent(Montage, 1.f);
+	}
+
+	if (bUseCompactVaultEvent && HasAuthority())
+	{
+		SendVaultEvent(Montage, 1.f);
+	}
+
+	PendingVaultEventSeed = 0;
+
+	IVIPawnInterface::Execute_StartVaultAbility(this);
+	OnVaultMontageStarted(Montage, 1.f);
+
+	// GA_Vault would grant the vault state, IsVaulting() checks it
+	VIASC->AddLooseGameplayTag(VaultComponent->VaultStateTag);
+	bExecutingVault = true;
+	ExecutedVaultMontage = Montage;
+
+	FOnMontageBlendingOutStarted BlendingOutDelegate = FOnMontageBlendingOutStarted::CreateUObject(this, &AVICharacterBase::OnExecutedVaultBlendingOut);
+	VaultMesh->GetAnimInstance()->Montage_SetBlendingOutDelegate(BlendingOutDelegate, Montage);
+
+	return true;
+}
+
+void AVICharacterBase::OnVaultRejected()
+{
+	if (!bExecutingVault)
+	{
+		return;
+	}
+
+	// Server corrected us out of the vault, CheckJumpInput() will call StopVaultAbility()
+	USkeletalMeshComponent* const VaultMesh = IVIPawnInterface::Execute_GetMeshForVaultMontage(this);
+	if (UAnimInstance* const AnimInstance = VaultMesh ? VaultMesh->GetAnimInstance() : nullptr)
+	{
+		AnimInstance->Montage_Stop(ExecutedVaultMontage ? ExecutedVaultMontage->GetDefaultBlendOutTime() : 0.f, ExecutedVaultMontage);
+	}
+
+	EndExecutedVault();
+}
+
+void AVICharacterBase::OnExecutedVaultBlendingOut(UAnimMontage* Montage, bool bInterrupted)
+{
+	EndExecutedVault();
+}
+
+void AVICharacterBase::EndExecutedVault()
+{
+	if (!bExecutingVault)
+	{
+		return;
+	}
+
+	bExecutingVault = false;
+	ExecutedVaultMontage = nullptr;
+
+	if (UAbilitySystemComponent* const VaultASC = VaultComponent ? VaultComponent->ASC : nullptr)
+	{
+		VaultASC->RemoveLooseGameplayTag(VaultComponent->VaultStateTag);
+	}
+}
+
+void AVICharacterBase::ApplyVaultRootMotionSource(UAnimMontage* Montage, float PlayRate)
+{
+	USkeletalMeshComponent* const VaultMesh = IVIPawnInterface::Execute_GetMeshForVaultMontage(this);
+	UAnimInstance* const AnimInstance = VaultMesh ? VaultMesh->GetAnimInstance() : nullptr;
+	if (!AnimInstance || !Montage || !GetCharacterMovement() || PlayRate <= 0.f)
+	{
+		return;
+	}
+
+	// Remove the previous vault if still active
+	RemoveVaultRootMotionSource();
+
+	// Montage only animates, the root motion source moves the character
+	CachedRootMotionMode = AnimInstance->RootMotionMode;
+	AnimInstance->SetRootMotionMode(ERootMotionMode::IgnoreRootMotion);
+
+	TSharedPtr<FVIRootMotionSource_Vault> VaultSource = MakeShared<FVIRootMotionSource_Vault>();
+	VaultSource->InstanceName = TEXT("VaultRootMotionSource");
+	VaultSource->AccumulateMode = ERootMotionAccumulateMode::Override;
+	VaultSource->Priority = 500;
+	VaultSource->Montage = Montage;
+	VaultSource->PlayRate = PlayRate;
+	VaultSource->StartPosition = AnimInstance->Montage_GetPosition(Montage);
+	VaultSource->StartLocation = GetActorLocation();
+	VaultSource->StartRotation = VaultMesh->GetComponentRotation();
+
+	const float EndPosition = Montage->GetPlayLength() - (bEndRootMotionSourceOnBlendOut ? Montage->GetDefaultBlendOutTime() : 0.f);
+	VaultSource->Duration = FMath::Max(EndPosition - VaultSource->StartPosition, KINDA_SMALL_NUMBER) / PlayRate;
+
+	// Don't carry the vault velocity beyond what we could walk at
+	VaultSource->FinishVelocityParams.Mode = ERootMotionFinishVelocityMode::ClampVelocity;
+	VaultSource->FinishVelocityParams.ClampVelocity = GetCharacterMovement()->GetMaxSpeed();
+
+	// Warp to the sync point within the montage's warping window
+	const FVIMotionWarpingSyncPoint* SyncPoint = MotionWarping ? MotionWarping->FindSyncPoint(TEXT("VaultSyncPoint")) : nullptr;
+	if (SyncPoint)
+	{
+		TArray<FVIMotionWarpingWindowData> Windows;
+		UVIMotionWarpingUtilities::GetVIMotionWarpingWindowsForSyncPointFromAnimation(Montage, TEXT("VaultSyncPoint"), Windows);
+
+		VaultSource->WarpStartTime = Windows.Num() > 0 ? Windows[0].StartTime : VaultSource->StartPosition;
+		VaultSource->WarpEndTime = Windows.Num() > 0 ? Windows[0].EndTime : EndPosition;
+
+		// Sync point is at the bottom of the capsule
+		VaultSource->TargetLocation = SyncPoint->GetLocation() + GetActorUpVector() * GetSimpleCollisionHalfHeight();
+	}
+
+	VaultRootMotionSourceID = GetCharacterMovement()->ApplyRootMotionSource(VaultSource);
+}
+
+void AVICharacterBase::RemoveVaultRootMotionSource()
+{
+	if (VaultRootMotionSourceID == (uint16)ERootMotionSourceID::Invalid)
+	{
+		return;
+	}
+
+	if (GetCharacterMovement())
+	{
+		GetCharacterMovement()->RemoveRootMotionSourceByID(VaultRootMotionSourceID);
+	}
+
+	VaultRootMotionSourceID = (uint16)ERootMotionSourceID::Invalid;
+
+	USkeletalMeshComponent* const VaultMesh = IVIPawnInterface::Execute_GetMeshForVaultMontage(this);
+	if (UAnimInstance* const AnimInstance = VaultMesh ? VaultMesh->GetAnimInstance() : nullptr)
+	{
+		AnimInstance->SetRootMotionMode(CachedRootMotionMode);
+	}
+}
+
+void AVICharacterBase::OnRep_VaultEvent()
+{
+	HandleVaultEvent(RepVaultEvent);
+}
+
+void AVICharacterBase::OnRep_ReplayVaultEvent()
+{
+	if (GetWorld() && GetWorld()->IsPlayingReplay())
+	{
+		HandleVaultEvent(ReplayVaultEvent);
+	}
+}
+
+void AVICharacterBase::HandleVaultEvent(const FVIRepVaultEvent& VaultEvent)
+{
+	if (!VaultEvent.IsValid())
+	{
+		return;
+	}
+
+	// Cache for FBIK and update sync point, this is also how the server corrects the sync point mid-vault
+	RepMotionMatch = FVIRepMotionMatch(VaultEvent.Location, VaultEvent.Direction);
+	if (MotionWarping)
+	{
+		MotionWarping->AddOrUpdateSyncPoint(TEXT("VaultSyncPoint"), FVIMotionWarpingSyncPoint(VaultEvent.Location, VaultEvent.Direction.ToOrientationQuat()));
+	}
+
+	// Same event, only the sync point changed
+	if (VaultEvent.EventId == LastVaultEventId)
+	{
+		// Unless a replay scrubbed back into this vault after it finished playing
+		if (!GetWorld() || !GetWorld()->IsPlayingReplay() || IsVaulting())
+		{
+			return;
+		}
+	}
+
+	LastVaultEventId = VaultEvent.EventId;
+	PlayVaultEventMontage(VaultEvent);
+}
+
+void AVICharacterBase::PlayVaultEventMontage(const FVIRepVaultEvent& VaultEvent)
+{
+	USkeletalMeshComponent* const VaultMesh = IVIPawnInterface::Execute_GetMeshForVaultMontage(this);
+	UAnimInstance* const AnimInstance = VaultMesh ? VaultMesh->GetAnimInstance() : nullptr;
+	if (!AnimInstance)
+	{
+		return;
+	}
+
+	// Catch up with the server, this is deterministic because the montage drives the vault
+	// Replays scrubbing or fast-forwarding land at the correct position the same way
+	const float ElapsedTime = (float)FMath::Max(0.0, GetServerWorldTimeSeconds() - VaultEvent.ServerTimestamp);
+	const float StartPosition = ElapsedTime * VaultEvent.PlayRate;
+
+	// Too late to play it (eg. just became relevant)
+	if (StartPosition >= VaultEvent.Montage->GetPlayLength())
+	{
+		return;
+	}
+
+	AnimInstance->Montage_Play(VaultEvent.Montage, VaultEvent.PlayRate, EMontagePlayReturnType::MontageLength, StartPosition);
+}
+
+double AVICharacterBase::GetServerWorldTimeSeconds() const
+{
+	const UWorld* const World = GetWorld();
+	if (!World)
+	{
+		return 0.0;
+	}
+
+	const AGameStateBase* const GameState = World->GetGameState();
+	return GameState ? GameState->GetServerWorldTimeSeconds() : World->GetTimeSeconds();
+}
+
 bool AVICharacterBase::IsVaulting() const
 {
 	// Simulated proxies use the value provided by server
 	if (GetLocalRole() == ROLE_SimulatedProxy)
 	{
+		if (const FVIRepVaultEvent* const VaultEvent = GetActiveVaultEvent())
+		{
+			// Vault event is played locally so the montage is the vaulting state
+			const USkeletalMeshComponent* const VaultMesh = IVIPawnInterface::Execute_GetMeshForVaultMontage(this);
+			const UAnimInstance* const AnimInstance = VaultMesh ? VaultMesh->GetAnimInstance() : nullptr;
+			return AnimInstance && VaultEvent->IsValid() && AnimInstance->Montage_IsPlaying(VaultEvent->Montage);
+		}
+
 		return bRepIsVaulting;
 	}
 
@@ -254,6 +674,7 @@ void AVICharacterBase::OnLocalPlayerVault_Implementation(const FVector& Location
 {
 	// LocalPlayer just stores the data in the same place for convenience, ease of use, memory reduction, etc
 	RepMotionMatch = FVIRepMotionMatch(Location, Direction);
+	MARK_PROPERTY_DIRTY_FROM_NAME(AVICharacterBase, RepMotionMatch, this);
 }
 
 void AVICharacterBase::GetVaultLocationAndDirection_Implementation(FVector& OutLocation, FVector& OutDirection) const
@@ -270,6 +691,22 @@ void AVICharacterBase::ReplicateMotionMatch_Implementation(const FVIRepMotionMat
 	// GA_Vault has directed server to update it's RepMotionMatch property so that it will
 	// be replicated to simulated proxies with 1 decimal point of precision (net quantization)
 	RepMotionMatch = MotionMatch;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AVICharacterBase, RepMotionMatch, this);
+
+	// Sync point changed after the vault event was sent, update it for simulated proxies
+	if (bUseCompactVaultEvent && HasAuthority() && IsVaulting() && RepVaultEvent.IsValid())
+	{
+		RepVaultEvent.Location = MotionMatch.Location;
+		RepVaultEvent.Direction = MotionMatch.Direction;
+		MARK_PROPERTY_DIRTY_FROM_NAME(AVICharacterBase, RepVaultEvent, this);
+	}
+
+	if (bUseReplayVaultEvent && HasAuthority() && IsVaulting() && ReplayVaultEvent.IsValid())
+	{
+		ReplayVaultEvent.Location = MotionMatch.Location;
+		ReplayVaultEvent.Direction = MotionMatch.Direction;
+		MARK_PROPERTY_DIRTY_FROM_NAME(AVICharacterBase, ReplayVaultEvent, this);
+	}
 }
 
 bool AVICharacterBase::IsWalkable_Implementation(const FHitResult& HitResult) const
@@ -0,0 +1,314 @@
+// Copyright (c) 2019-2022 Drowning Dragons Limited. All Rights Reserved.
+
+#include "Pawn/VICharacterMovementComponent.h"
+#include "GameFramework/Character.h"
+#include "Pawn/VICharacterBase.h"
+#include "VITypes.h"
+
+DECLARE_CYCLE_STAT(TEXT("VICharacterMovementComponent PhysVault"), STAT_VAULTPHYSVAULT, STATGROUP_VaultIt);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Net Corrections While Vaulting"), STAT_VAULTNET_CORRECTIONS, STATGROUP_VaultIt);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Net Vaults Rolled Back"), STAT_VAULTNET_ROLLBACKS, STATGROUP_VaultIt);
+
+// *********************************************** //
+// ************ Begin Vault Saved Move *********** //
+// *********************************************** //
+
+void FVISavedMove_Character::Clear()
+{
+	Super::Clear();
+
+	bHasVaultRequest = false;
+	VaultRequest = FVIVaultInfo();
+}
+
+void FVISavedMove_Character::SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, class FNetworkPredictionData_Client_Character& ClientData)
+{
+	Super::SetMoveFor(C, InDeltaTime, NewAccel, ClientData);
+
+	if (const UVICharacterMovementComponent* VIMovement = Cast<UVICharacterMovementComponent>(C->GetCharacterMovement()))
+	{
+		bHasVaultRequest = VIMovement->GetClientVaultRequest(VaultRequest);
+	}
+}
+
+bool FVISavedMove_Character::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const
+{
+	// The vault must start on the move it was requested on
+	if (bHasVaultRequest || static_cast<const FVISavedMove_Character*>(NewMove.Get())->bHasVaultRequest)
+	{
+		return false;
+	}
+
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+bool FVISavedMove_Character::IsImportantMove(const FSavedMovePtr& LastAckedMove) const
+{
+	// Resent with the next move if lost
+	return bHasVaultRequest || Super::IsImportantMove(LastAckedMove);
+}
+
+FSavedMovePtr FVINetworkPredictionData_Client_Character::AllocateNewMove()
+{
+	return FSavedMovePtr(new FVISavedMove_Character());
+}
+
+void FVICharacterNetworkMoveData::ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType)
+{
+	Super::ClientFillNetworkMoveData(ClientMove, MoveType);
+
+	const FVISavedMove_Character& VIClientMove = static_cast<const FVISavedMove_Character&>(ClientMove);
+	bHasVaultRequest = VIClientMove.bHasVaultRequest;
+	VaultRequest = VIClientMove.VaultRequest;
+}
+
+bool FVICharacterNetworkMoveData::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType)
+{
+	Super::Serialize(CharacterMovement, Ar, PackageMap, MoveType);
+
+	uint8 bNetHasVaultRequest = bHasVaultRequest ? 1 : 0;
+	Ar.SerializeBits(&bNetHasVaultRequest, 1);
+	bHasVaultRequest = bNetHasVaultRequest != 0;
+
+	if (bHasVaultRequest)
+	{
+		bool bSuccess = true;
+		VaultRequest.NetSerialize(Ar, PackageMap, bSuccess);
+	}
+	else if (Ar.IsLoading())
+	{
+		VaultRequest = FVIVaultInfo();
+	}
+
+	return !Ar.IsError();
+}
+
+// *********************************************** //
+// ************* End Vault Saved Move ************ //
+// *********************************************** //
+
+void UVICharacterMovementComponent::StartVaultMovement()
+{
+	if (bUseVaultMovementMode)
+	{
+		SetMovementMode(MOVE_Custom, VaultCustomMovementMode);
+	}
+	else
+	{
+		SetMovementMode(MOVE_Flying);
+	}
+}
+
+void UVICharacterMovementComponent::StopVaultMovement()
+{
+	// Entering walking performs the only floor check for the vault
+	ClearPendingVaultRequest();
+
+	SetMovementMode(GetGroundMovementMode());
+
+	// Hand over to falling right away instead of waiting for walking physics to find out
+	if (IsMovingOnGround() && !CurrentFloor.IsWalkableFloor())
+	{
+		SetMovementMode(MOVE_Falling);
+	}
+}
+
+bool UVICharacterMovementComponent::IsVaultMovement() const
+{
+	return MovementMode == MOVE_Custom && CustomMovementMode == VaultCustomMovementMode && bUseVaultMovementMode;
+}
+
+bool UVICharacterMovementComponent::IsVaultMovementMode(EMovementMode InMovementMode, uint8 InCustomMovementMode) const
+{
+	if (bUseVaultMovementMode)
+	{
+		return InMovementMode == MOVE_Custom && InCustomMovementMode == VaultCustomMovementMode;
+	}
+
+	return InMovementMode == MOVE_Flying;
+}
+
+void UVICharacterMovementComponent::RequestVault(const FVIVaultInfo& VaultInfo)
+{
+	bHasClientVaultRequest = true;
+	ClientVaultRequest = VaultInfo;
+}
+
+bool UVICharacterMovementComponent::ConsumeVaultRequest(FVIVaultInfo& OutVaultInfo)
+{
+	if (!bHasServerVaultRequest)
+	{
+		return false;
+	}
+
+	OutVaultInfo = ServerVaultRequest;
+	bHasServerVaultRequest = false;
+	return true;
+}
+
+bool UVICharacterMovementComponent::GetClientVaultRequest(FVIVaultInfo& OutVaultInfo) const
+{
+	if (bHasClientVaultRequest)
+	{
+		OutVaultInfo = ClientVaultRequest;
+	}
+
+	return bHasClientVaultRequest;
+}
+
+FNetworkPredictionData_Client* UVICharacterMovementComponent::GetPredictionData_Client() const
+{
+	if (ClientPredictionData == nullptr)
+	{
+		UVICharacterMovementComponent* MutableThis = const_cast<UVICharacterMovementComponent*>(this);
+		MutableThis->ClientPredictionData = new FVINetworkPredictionData_Client_Character(*this);
+	}
+
+	return ClientPredictionData;
+}
+
+void UVICharacterMovementComponent::ReplicateMoveToServer(float DeltaTime, const FVector& NewAcceleration)
+{
+	const bool bSendingVaultRequest = bHasClientVaultRequest;
+
+	// Request is saved into the new move here
+	Super::ReplicateMoveToServer(DeltaTime, NewAcceleration);
+
+	if (bSendingVaultRequest)
+	{
+		// Corrections from this move onwards can reject the vault
+		bHasPendingVaultRequest = true;
+
+		bHasClientVaultRequest = false;
+		ClientVaultRequest = FVIVaultInfo();
+	}
+}
+
+void UVICharacterMovementComponent::ServerMove_PerformMovement(const FCharacterNetworkMoveData& MoveData)
+{
+	// Our container only ever provides FVICharacterNetworkMoveData
+	const FVICharacterNetworkMoveData& VIMoveData = static_cast<const FVICharacterNetworkMoveData&>(MoveData);
+	bHasServerVaultRequest = VIMoveData.bHasVaultRequest;
+	ServerVaultRequest = VIMoveData.VaultRequest;
+
+	// Character consumes the request from CheckJumpInput() when performing this move
+	Super::ServerMove_PerformMovement(MoveData);
+
+	// Move may have been rejected, never carry the request into the next move
+	bHasServerVaultRequest = false;
+	ServerVaultRequest = FVIVaultInfo();
+}
+
+void UVICharacterMovementComponent::OnClientCorrectionReceived(class FNetworkPredictionData_Client_Character& ClientData, float TimeStamp, FVector NewLocation, FVector NewVelocity, UPrimitiveComponent* NewBase, FName NewBaseBoneName, bool bHasBase, bool bBaseRelativePosition, uint8 ServerMovementMode)
+{
+	Super::OnClientCorrectionReceived(ClientData, TimeStamp, NewLocation, NewVelocity, NewBase, NewBaseBoneName, bHasBase, bBaseRelativePosition, ServerMovementMode);
+
+	if (IsVaultMovement())
+	{
+		INC_DWORD_STAT(STAT_VAULTNET_CORRECTIONS);
+		INC_VI_NET_COUNTER(CorrectionsWhileVaulting);
+	}
+
+	// Only corrections on or after the vault move can tell us the server did not vault
+	// The corrected move was acked before this is called, if the vault move is still saved the correction predates it
+	// Uses move order instead of timestamps which are reset periodically
+	if (!HasPendingVaultRequest() || IsVaultRequestUnacknowledged(ClientData))
+	{
+		return;
+	}
+
+	TEnumAsByte<EMovementMode> NetMovementMode(MOVE_None);
+	TEnumAsByte<EMovementMode> NetGroundMode(MOVE_None);
+	uint8 NetCustomMode(0);
+	UnpackNetworkMovementMode(ServerMovementMode, NetMovementMode, NetCustomMode, NetGroundMode);
+
+	if (!IsVaultMovementMode(NetMovementMode, NetCustomMode))
+	{
+		ClearPendingVaultRequest();
+		INC_DWORD_STAT(STAT_VAULTNET_ROLLBACKS);
+		INC_VI_NET_COUNTER(VaultsRolledBack);
+
+		if (AVICharacterBase* VICharacter = Cast<AVICharacterBase>(CharacterOwner))
+		{
+			VICharacter->OnVaultRejected();
+		}
+	}
+}
+
+bool UVICharacterMovementComponent::IsVaultRequestUnacknowledged(const FNetworkPredictionData_Client_Character& ClientData) const
+{
+	for (const FSavedMovePtr& SavedMove : ClientData.SavedMoves)
+	{
+		if (SavedMove.IsValid() && static_cast<const FVISavedMove_Character*>(SavedMove.Get())->bHasVaultRequest)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void UVICharacterMovementComponent::PhysCustom(float deltaTime, int32 Iterations)
+{
+	if (IsVaultMovement())
+	{
+		PhysVault(deltaTime, Iterations);
+		return;
+	}
+
+	Super::PhysCustom(deltaTime, Iterations);
+}
+
+void UVICharacterMovementComponent::PhysVault(float deltaTime, int32 Iterations)
+{
+	SCOPE_CYCLE_COUNTER(STAT_VAULTPHYSVAULT);
+
+	if (deltaTime < MIN_TICK_TIME)
+	{
+		return;
+	}
+
+	RestorePreAdditiveRootMotionVelocity();
+
+	// Only root motion moves us while vaulting
+	if (!HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity())
+	{
+		Velocity = FVector::ZeroVector;
+	}
+
+	ApplyRootMotionToVelocity(deltaTime);
+
+	Iterations++;
+	bJustTeleported = false;
+
+	const FVector OldLocation = UpdatedComponent->GetComponentLocation();
+	const FQuat PawnRotation = UpdatedComponent->GetComponentQuat();
+	const FVector Delta = Velocity * deltaTime;
+
+	if (!Delta.IsNearlyZero())
+	{
+		// Single sweep on a shrunk capsule, the path was validated by ComputeVault
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(VaultSweep), false, CharacterOwner);
+		FCollisionResponseParams ResponseParams;
+		InitCollisionParams(QueryParams, ResponseParams);
+
+		const FCollisionShape CapsuleShape = GetPawnCapsuleCollisionShape(SHRINK_AllCustom, VaultCapsuleShrinkAmount);
+		const ECollisionChannel CollisionChannel = UpdatedComponent->GetCollisionObjectType();
+
+		FHitResult Hit(1.f);
+		GetWorld()->SweepSingleByChannel(Hit, OldLocation, OldLocation + Delta, PawnRotation, CollisionChannel, CapsuleShape, QueryParams, ResponseParams);
+
+		// Starting in penetration means we're brushing the ledge, which the vault already accounts for
+		const float MoveTime = (Hit.bBlockingHit && !Hit.bStartPenetrating) ? Hit.Time : 1.f;
+
+		// Already swept, move without sweeping again
+		MoveUpdatedComponent(Delta * MoveTime, PawnRotation, false);
+	}
+
+	// Root motion provides velocity, otherwise derive it from the move
+	if (!bJustTeleported && !HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity())
+	{
+		Velocity = (UpdatedComponent->GetComponentLocation() - OldLocation) / deltaTime;
+	}
+}
@@ -6,12 +6,16 @@
 #include "Components/CapsuleComponent.h"
 #include "AbilitySystemInterface.h"
 #include "GAS/VIAbilitySystemComponent.h"
+#include "Pawn/VICharacterBase.h"
+#include "Pawn/VICharacterMovementComponent.h"
 #include "Pawn/VIPawnInterface.h"
 #include "GameFramework/PawnMovementComponent.h"
 #include "Kismet/GameplayStaticsTypes.h"
 #include "AbilitySystemBlueprintLibrary.h"
 #include "Kismet/KismetSystemLibrary.h"
 
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Net Anti-Cheat Rejects"), STAT_VAULTNET_ANTICHEATREJECTS, STATGROUP_VaultIt);
+
 DECLARE_CYCLE_STAT(TEXT("AutoVault"), STAT_VAULTAUTOVAULT, STATGROUP_VaultIt);
 
 DEFINE_LOG_CATEGORY_STATIC(LogVaultItAntiCheat, Log, All);
@@ -258,17 +262,26 @@ void UVIPawnVaultComponent::CheckVaultInput(float DeltaTime, TEnumAsByte<enum EM
 					// Consume input if required
 					if (AutoReleaseVaultInput != EVIVaultInputRelease::VIR_Never) { bPressedVault = false; }
 
-					// Send vault result as info through EventData
-					FVIGameplayAbilityTargetData_VaultInfo Info;
-					Info.VaultInfo = ComputeVaultInfoFromResult(VaultResult);
+					const FVIVaultInfo VaultInfo = ComputeVaultInfoFromResult(VaultResult);
+
+					// AI has nothing to validate, movement prediction sends the vault with saved moves
+					const bool bDirectVault = bDirectVaultForAI && PawnOwner->HasAuthority() && !PawnOwner->IsPlayerControlled();
+					const bool bVaulted = bDirectVault ? TryDirectVault(VaultInfo) : (bPredictVaultWithMovement && TryPredictVaultWithMovement(VaultInfo));
+
+					if (!bVaulted)
+					{
+						// Send vault result as info through EventData
+						FVIGameplayAbilityTargetData_VaultInfo Info;
+						Info.VaultInfo = VaultInfo;
 
-					// Cache gameplay ability event data to be sent
-					FGameplayEventData EventData;
-					EventData.Instigator = PawnOwner;
-					EventData.TargetData.Add(new FVIGameplayAbilityTargetData_VaultInfo(Info));
+						// Cache gameplay ability event data to be sent
+						FGameplayEventData EventData;
+						EventData.Instigator = PawnOwner;
+						EventData.TargetData.Add(new FVIGameplayAbilityTargetData_VaultInfo(Info));
 
-					// Trigger ability and send event data to ability & server
-					UAbilitySystemBlueprintLibrary::SendGameplayEventToActor(PawnOwner, VaultAbilityTag, EventData);
+						// Trigger ability and send event data to ability & server
+						UAbilitySystemBlueprintLibrary::SendGameplayEventToActor(PawnOwner, VaultAbilityTag, EventData);
+					}
 
 					// Send to Pawn to use for FBIK (or anything extended by user)
 					IVIPawnInterface::Execute_OnLocalPlayerVault(PawnOwner, VaultResult.Location, VaultResult.Direction);
@@ -286,6 +299,41 @@ void UVIPawnVaultComponent::CheckVaultInput(float DeltaTime, TEnumAsByte<enum EM
 	PendingVaultResult = FVIVaultResult();
 }
 
+bool UVIPawnVaultComponent::TryDirectVault(const FVIVaultInfo& VaultInfo)
+{
+	AVICharacterBase* const Character = Cast<AVICharacterBase>(PawnOwner);
+	return Character && Character->ExecuteVault(VaultInfo);
+}
+
+bool UVIPawnVaultComponent::TryPredictVaultWithMovement(const FVIVaultInfo& VaultInfo)
+{
+	AVICharacterBase* const Character = Cast<AVICharacterBase>(PawnOwner);
+	UVICharacterMovementComponent* const VIMovement = Character ? Cast<UVICharacterMovementComponent>(Character->GetCharacterMovement()) : nullptr;
+	if (!VIMovement)
+	{
+		return false;
+	}
+
+	// Saved moves being replayed after a correction already carry their vault
+	if (VIMovement->bClientUpdating)
+	{
+		return true;
+	}
+
+	if (!Character->ExecuteVault(VaultInfo))
+	{
+		return false;
+	}
+
+	// Server starts the vault when it performs this move
+	if (Character->GetLocalRole() == ROLE_AutonomousProxy)
+	{
+		VIMovement->RequestVault(VaultInfo);
+	}
+
+	return true;
+}
+
 bool UVIPawnVaultComponent::IsVaulting() const
 {
 	if (ASC)
@@ -437,6 +485,8 @@ bool UVIPawnVaultComponent::ComputeAntiCheatResult(const FVIVaultInfo& ClientVau
 			if (!ServerVaultResult.bSuccess)
 			{
 				// User may want to use more lenient settings for authority in VIPawnInterface::GetVaultTraceSettings()
+				INC_DWORD_STAT(STAT_VAULTNET_ANTICHEATREJECTS);
+				INC_VI_NET_COUNTER(AntiCheatRejects);
 				return false;
 			}
 
@@ -445,13 +495,21 @@ bool UVIPawnVaultComponent::ComputeAntiCheatResult(const FVIVaultInfo& ClientVau
 
 			if (!AntiCheatSettings.ComputeAntiCheat(ClientVaultInfo, ServerVaultInfo, PawnOwner))
 			{
+				INC_DWORD_STAT(STAT_VAULTNET_ANTICHEATREJECTS);
+				INC_VI_NET_COUNTER(AntiCheatRejects);
 				return false;
 			}
 		}
 		return true;
 	case EVIAntiCheatType::VIACT_Custom:
 		// Using custom AntiCheat override
-		return ComputeCustomAntiCheat(ClientVaultInfo);
+		if (!ComputeCustomAntiCheat(ClientVaultInfo))
+		{
+			INC_DWORD_STAT(STAT_VAULTNET_ANTICHEATREJECTS);
+			INC_VI_NET_COUNTER(AntiCheatRejects);
+			return false;
+		}
+		return true;
 	case EVIAntiCheatType::VIACT_None:
 	default:
 		break;
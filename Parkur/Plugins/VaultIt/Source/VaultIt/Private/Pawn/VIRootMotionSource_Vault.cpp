@@ -0,0 +1,220 @@
+// Copyright (c) 2019-2022 Drowning Dragons Limited. All Rights Reserved.
+
+#include "Pawn/VIRootMotionSource_Vault.h"
+#include "GameFramework/Character.h"
+#include "Animation/AnimMontage.h"
+#include "Engine/NetSerialization.h"
+#include "VITypes.h"
+
+DECLARE_CYCLE_STAT(TEXT("VIRootMotionSource_Vault CacheTrajectory"), STAT_VAULTRMS_CACHETRAJECTORY, STATGROUP_VaultIt);
+
+FVIRootMotionSource_Vault::FVIRootMotionSource_Vault()
+	: Montage(nullptr)
+	, StartPosition(0.f)
+	, PlayRate(1.f)
+	, StartLocation(FVector::ZeroVector)
+	, StartRotation(FRotator::ZeroRotator)
+	, TargetLocation(FVector::ZeroVector)
+	, WarpStartTime(0.f)
+	, WarpEndTime(0.f)
+{
+}
+
+FRootMotionSource* FVIRootMotionSource_Vault::Clone() const
+{
+	FVIRootMotionSource_Vault* CopyPtr = new FVIRootMotionSource_Vault(*this);
+	return CopyPtr;
+}
+
+bool FVIRootMotionSource_Vault::Matches(const FRootMotionSource* Other) const
+{
+	if (!FRootMotionSource::Matches(Other))
+	{
+		return false;
+	}
+
+	// We can cast safely here since in FRootMotionSource::Matches() we ensured ScriptStruct equality
+	const FVIRootMotionSource_Vault* OtherCast = static_cast<const FVIRootMotionSource_Vault*>(Other);
+
+	// Start is captured separately on client and server and is state, not identity, see UpdateStateFrom()
+	return Montage == OtherCast->Montage &&
+		FMath::IsNearlyEqual(PlayRate, OtherCast->PlayRate, KINDA_SMALL_NUMBER);
+}
+
+bool FVIRootMotionSource_Vault::MatchesAndHasSameState(const FRootMotionSource* Other) const
+{
+	if (!FRootMotionSource::MatchesAndHasSameState(Other))
+	{
+		return false;
+	}
+
+	// We can cast safely here since in FRootMotionSource::Matches() we ensured ScriptStruct equality
+	const FVIRootMotionSource_Vault* OtherCast = static_cast<const FVIRootMotionSource_Vault*>(Other);
+
+	return FMath::IsNearlyEqual(StartPosition, OtherCast->StartPosition, KINDA_SMALL_NUMBER) &&
+		StartLocation.Equals(OtherCast->StartLocation, 0.1f) &&
+		TargetLocation.Equals(OtherCast->TargetLocation, 0.1f);
+}
+
+bool FVIRootMotionSource_Vault::UpdateStateFrom(const FRootMotionSource* SourceToTakeStateFrom, bool bMarkForSimulatedCatchup)
+{
+	if (!FRootMotionSource::UpdateStateFrom(SourceToTakeStateFrom, bMarkForSimulatedCatchup))
+	{
+		return false;
+	}
+
+	const FVIRootMotionSource_Vault* OtherCast = static_cast<const FVIRootMotionSource_Vault*>(SourceToTakeStateFrom);
+
+	// Trajectory is relative to the start, rebuild it if the server started elsewhere in the montage
+	if (!FMath::IsNearlyEqual(StartPosition, OtherCast->StartPosition, KINDA_SMALL_NUMBER))
+	{
+		Trajectory.Reset();
+	}
+
+	// Server's start is authoritative, the client captured its own when it predicted the vault
+	StartPosition = OtherCast->StartPosition;
+	StartLocation = OtherCast->StartLocation;
+	StartRotation = OtherCast->StartRotation;
+	WarpStartTime = OtherCast->WarpStartTime;
+	WarpEndTime = OtherCast->WarpEndTime;
+
+	// Server may have a different sync point, eg. if it changed during the vault
+	TargetLocation = OtherCast->TargetLocation;
+
+	return true;
+}
+
+void FVIRootMotionSource_Vault::PrepareRootMotion(float SimulationTime, float MovementTickTime, const ACharacter& Character, const UCharacterMovementComponent& MoveComponent)
+{
+	RootMotionParams.Clear();
+
+	if (Duration > SMALL_NUMBER && MovementTickTime > SMALL_NUMBER && Montage)
+	{
+		const FVector CurrentTargetLocation = GetLocationAtTime(GetTime() + SimulationTime);
+		const FVector Force = (CurrentTargetLocation - Character.GetActorLocation()) / MovementTickTime;
+
+		const FTransform NewTransform(Force);
+		RootMotionParams.Set(NewTransform);
+	}
+
+	SetTime(GetTime() + SimulationTime);
+}
+
+bool FVIRootMotionSource_Vault::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	if (!FRootMotionSource::NetSerialize(Ar, Map, bOutSuccess))
+	{
+		return false;
+	}
+
+	UObject* NetMontage = Montage;
+	Map->SerializeObject(Ar, UAnimMontage::StaticClass(), NetMontage);
+
+	Ar << StartPosition;
+	Ar << PlayRate;
+	Ar << WarpStartTime;
+	Ar << WarpEndTime;
+
+	FVector_NetQuantize100 NetStartLocation = FVector_NetQuantize100(StartLocation);
+	FVector_NetQuantize100 NetTargetLocation = FVector_NetQuantize100(TargetLocation);
+	NetStartLocation.NetSerialize(Ar, Map, bOutSuccess);
+	NetTargetLocation.NetSerialize(Ar, Map, bOutSuccess);
+
+	StartRotation.SerializeCompressedShort(Ar);
+
+	if (Ar.IsLoading())
+	{
+		Montage = Cast<UAnimMontage>(NetMontage);
+		StartLocation = NetStartLocation;
+		TargetLocation = NetTargetLocation;
+
+		// Rebuilt from the montage when next used
+		Trajectory.Reset();
+	}
+
+	bOutSuccess = true;
+	return true;
+}
+
+UScriptStruct* FVIRootMotionSource_Vault::GetScriptStruct() const
+{
+	return FVIRootMotionSource_Vault::StaticStruct();
+}
+
+FString FVIRootMotionSource_Vault::ToSimpleString() const
+{
+	return FString::Printf(TEXT("[ID:%u]FVIRootMotionSource_Vault %s %s"), LocalID, *InstanceName.GetPlainNameString(), *GetNameSafe(Montage));
+}
+
+void FVIRootMotionSource_Vault::AddReferencedObjects(class FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObject(Montage);
+
+	FRootMotionSource::AddReferencedObjects(Collector);
+}
+
+FVector FVIRootMotionSource_Vault::GetLocationAtTime(float Time)
+{
+	CacheTrajectory();
+
+	const float EndPosition = Montage ? Montage->GetPlayLength() : StartPosition;
+	const float Position = FMath::Clamp(StartPosition + Time * PlayRate, StartPosition, EndPosition);
+
+	const FVector Location = StartLocation + StartRotation.RotateVector(GetTrajectoryAtPosition(Position));
+
+	// Warp window already passed, play the montage as-is
+	if (WarpEndTime <= StartPosition)
+	{
+		return Location;
+	}
+
+	// Difference between where the montage would take us and where we need to be, applied over the window
+	const FVector WarpEndLocation = StartLocation + StartRotation.RotateVector(GetTrajectoryAtPosition(WarpEndTime));
+	const FVector Correction = TargetLocation - WarpEndLocation;
+
+	const float WindowStart = FMath::Max(WarpStartTime, StartPosition);
+	const float Alpha = FMath::Clamp((Position - WindowStart) / FMath::Max(WarpEndTime - WindowStart, KINDA_SMALL_NUMBER), 0.f, 1.f);
+
+	return Location + Correction * Alpha;
+}
+
+void FVIRootMotionSource_Vault::CacheTrajectory()
+{
+	if (Trajectory.Num() > 0 || !Montage)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_VAULTRMS_CACHETRAJECTORY);
+
+	const float EndPosition = Montage->GetPlayLength();
+	const int32 NumSamples = FMath::Max(1, FMath::CeilToInt((EndPosition - StartPosition) * TrajectorySampleRate) + 1);
+
+	Trajectory.Reserve(NumSamples);
+	Trajectory.Add(FVector::ZeroVector);
+
+	// Accumulate in steps, each extraction is only as expensive as its own range
+	FTransform Accumulated = FTransform::Identity;
+	float PreviousPosition = StartPosition;
+	for (int32 i = 1; i < NumSamples; i++)
+	{
+		const float Position = FMath::Min(StartPosition + i / TrajectorySampleRate, EndPosition);
+		Accumulated = Montage->ExtractRootMotionFromTrackRange(PreviousPosition, Position) * Accumulated;
+		Trajectory.Add(Accumulated.GetTranslation());
+		PreviousPosition = Position;
+	}
+}
+
+FVector FVIRootMotionSource_Vault::GetTrajectoryAtPosition(float Position) const
+{
+	if (Trajectory.Num() == 0)
+	{
+		return FVector::ZeroVector;
+	}
+
+	const float Sample = FMath::Max(0.f, (Position - StartPosition) * TrajectorySampleRate);
+	const int32 Index = FMath::Min(FMath::FloorToInt(Sample), Trajectory.Num() - 1);
+	const int32 NextIndex = FMath::Min(Index + 1, Trajectory.Num() - 1);
+
+	return FMath::Lerp(Trajectory[Index], Trajectory[NextIndex], FMath::Clamp(Sample - Index, 0.f, 1.f));
+}
@@ -0,0 +1,62 @@
+// Copyright (c) 2019-2022 Drowning Dragons Limited. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Components/SkeletalMeshComponent.h"
+#include "UObject/Package.h"
+#include "Animation/VIAnimNotifyState_FBIK.h"
+#include "Animation/VIFBIKTraceBatch.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVIFBIKOverlappingNotifyTest, "VaultIt.FBIK.OverlappingNotifies", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+ * Two montage instances of the same vault overlap while the first blends out, both begin the FBIK notify on the same mesh
+ * The first instance ending must leave the slot of the second alone, the slot goes once both ended
+ */
+bool FVIFBIKOverlappingNotifyTest::RunTest(const FString& Parameters)
+{
+	const USkeletalMeshComponent* Mesh = NewObject<USkeletalMeshComponent>(GetTransientPackage());
+	const UVIAnimNotifyState_FBIK* Notify = NewObject<UVIAnimNotifyState_FBIK>(GetTransientPackage());
+
+	FVIFBIKTraceBatch& Batch = FVIFBIKTraceBatch::Get();
+
+	// Blending out
+	FVIFBIKTraceSlot& OldSlot = Batch.BeginSlot(Mesh, Notify);
+	OldSlot.LateralOffset = -20.f;
+	OldSlot.bPlaced = true;
+
+	// Blending in, starts the slot over
+	FVIFBIKTraceSlot& LiveSlot = Batch.BeginSlot(Mesh, Notify);
+	TestEqual(TEXT("Second begin starts the slot over"), LiveSlot.bPlaced, false);
+	LiveSlot.LateralOffset = 20.f;
+	LiveSlot.bPlaced = true;
+	LiveSlot.PlacedLocation = FVector(10.f, 20.f, 30.f);
+
+	TestFalse(TEXT("Old instance ending keeps the slot"), Batch.RemoveSlot(Mesh, Notify));
+
+	const FVIFBIKTraceSlot* Slot = Batch.FindSlot(Mesh, Notify);
+	if (TestNotNull(TEXT("Live instance slot"), Slot))
+	{
+		TestEqual(TEXT("Live instance lateral offset"), Slot->LateralOffset, 20.f);
+		TestTrue(TEXT("Live instance bone stays placed"), Slot->bPlaced);
+		TestEqual(TEXT("Live instance placement"), Slot->PlacedLocation, FVector(10.f, 20.f, 30.f));
+	}
+
+	TestTrue(TEXT("Live instance ending removes the slot"), Batch.RemoveSlot(Mesh, Notify));
+	TestNull(TEXT("Slot after both ended"), Batch.FindSlot(Mesh, Notify));
+
+	// NotifyEnd without a NotifyBegin, eg. the role changed mid notify
+	TestTrue(TEXT("Ending a slot that never began"), Batch.RemoveSlot(Mesh, Notify));
+
+	// One instance at a time is removed by its own end
+	Batch.BeginSlot(Mesh, Notify);
+	TestTrue(TEXT("Single instance ending removes the slot"), Batch.RemoveSlot(Mesh, Notify));
+	TestNull(TEXT("Slot after a single instance ended"), Batch.FindSlot(Mesh, Notify));
+
+	return true;
+}
+
+#endif  // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,450 @@
+// Copyright (c) 2019-2022 Drowning Dragons Limited. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#include "VITypes.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR && VI_WITH_NET_COUNTERS
+
+#include "Components/CapsuleComponent.h"
+#include "Editor.h"
+#include "Engine/NetDriver.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "FileHelpers.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Settings/LevelEditorPlaySettings.h"
+#include "Tests/AutomationCommon.h"
+#include "Pawn/VICharacterBase.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogVaultItNetTest, Log, All);
+
+/**
+ * Listen server and clients in one PIE process under emulated packet loss and latency, with server controlled AI running scripted
+ * courses of obstacles and vaulting over them while the clients receive them as simulated proxies
+ * Players can run courses too (VI.test.NetPlayerCourses) to exercise client prediction, corrections and anti-cheat
+ * Runs headless: UnrealEditor-Cmd Parkur.uproject -nullrhi -unattended -ExecCmds="Automation RunTests VaultIt.Net; Quit"
+ * Writes a report to Saved/Automation/VaultItNet_<Variant>.csv
+ */
+
+static TAutoConsoleVariable<FString> CVarVaultNetTestMap(
+	TEXT("VI.test.NetMap"),
+	TEXT("/VaultIt/Maps/ThirdPersonExampleMap"),
+	TEXT("Map the vault network automation test runs in, its game mode must spawn AVICharacterBase pawns")
+);
+
+static TAutoConsoleVariable<int32> CVarVaultNetTestPlayers(
+	TEXT("VI.test.NetPlayers"),
+	4,
+	TEXT("Players in the vault network automation test, including the listen server")
+);
+
+static TAutoConsoleVariable<int32> CVarVaultNetTestAIPawns(
+	TEXT("VI.test.NetAIPawns"),
+	8,
+	TEXT("Server controlled AI pawns running vault courses in the vault network automation test")
+);
+
+static TAutoConsoleVariable<int32> CVarVaultNetTestPlayerCourses(
+	TEXT("VI.test.NetPlayerCourses"),
+	0,
+	TEXT("If 1, players also run vault courses in the vault network automation test")
+);
+
+static TAutoConsoleVariable<float> CVarVaultNetTestDuration(
+	TEXT("VI.test.NetDuration"),
+	30.f,
+	TEXT("Seconds each player runs the vault course for")
+);
+
+namespace VIVaultNetTest
+{
+	/** Space between obstacles along a course */
+	static constexpr float ObstacleSpacing = 600.f;
+
+	/** Space between courses running side by side */
+	static constexpr float LaneSpacing = 500.f;
+
+	/** Obstacle height, low enough for every vault anim set */
+	static constexpr float ObstacleHeight = 100.f;
+
+	/** Seconds between vault attempts */
+	static constexpr float VaultInterval = 0.25f;
+
+	/** Seconds to wait for PIE to start and every player to spawn */
+	static constexpr float StartTimeout = 60.f;
+
+	struct FVariant
+	{
+		float PktLoss;
+		int32 PktLag;
+	};
+
+	static void SetConsoleVariable(const TCHAR* Name, const FString& Value)
+	{
+		if (IConsoleVariable* CVar = IConsoleManager::Get().FindConsoleVariable(Name))
+		{
+			CVar->Set(*Value, ECVF_SetByCode);
+		}
+	}
+
+	static void SetPacketEmulation(float PktLoss, int32 PktLag)
+	{
+		SetConsoleVariable(TEXT("NetEmulation.PktLoss"), FString::SanitizeFloat(PktLoss));
+		SetConsoleVariable(TEXT("NetEmulation.PktLag"), FString::FromInt(PktLag));
+		SetConsoleVariable(TEXT("NetEmulation.PktLagVariance"), FString::FromInt(PktLag / 5));
+	}
+
+	static TArray<UWorld*> GetPIEWorlds()
+	{
+		TArray<UWorld*> Worlds;
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			if (Context.WorldType == EWorldType::PIE && Context.World())
+			{
+				Worlds.Add(Context.World());
+			}
+		}
+		return Worlds;
+	}
+
+	static UWorld* GetServerWorld()
+	{
+		for (UWorld* World : GetPIEWorlds())
+		{
+			if (World->GetNetMode() == NM_ListenServer)
+			{
+				return World;
+			}
+		}
+		return nullptr;
+	}
+
+	static AVICharacterBase* GetLocalCharacter(UWorld* World)
+	{
+		const APlayerController* PC = World ? World->GetFirstPlayerController() : nullptr;
+		return PC && PC->IsLocalController() ? Cast<AVICharacterBase>(PC->GetPawn()) : nullptr;
+	}
+
+	static void SpawnCube(UWorld* World, const FTransform& Transform)
+	{
+		static UStaticMesh* Cube = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+
+		FActorSpawnParameters Params;
+		Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		if (AStaticMeshActor* Actor = World->SpawnActor<AStaticMeshActor>(AStaticMeshActor::StaticClass(), Transform, Params))
+		{
+			Actor->GetStaticMeshComponent()->SetMobility(EComponentMobility::Movable);
+			Actor->GetStaticMeshComponent()->SetStaticMesh(Cube);
+			Actor->SetActorTransform(Transform);
+		}
+	}
+}
+
+/** Waits for PIE to start and every player's character to spawn on the server */
+DEFINE_LATENT_AUTOMATION_COMMAND_TWO_PARAMETER(FVIWaitForPlayersCommand, FAutomationTestBase*, Test, int32, NumPlayers);
+bool FVIWaitForPlayersCommand::Update()
+{
+	UWorld* const ServerWorld = VIVaultNetTest::GetServerWorld();
+	if (ServerWorld)
+	{
+		int32 NumCharacters = 0;
+		for (FConstPlayerControllerIterator It = ServerWorld->GetPlayerControllerIterator(); It; ++It)
+		{
+			NumCharacters += Cast<AVICharacterBase>(It->Get()->GetPawn()) ? 1 : 0;
+		}
+
+		if (NumCharacters >= NumPlayers && VIVaultNetTest::GetPIEWorlds().Num() >= NumPlayers)
+		{
+			return true;
+		}
+	}
+
+	if (FPlatformTime::Seconds() - StartTime > VIVaultNetTest::StartTimeout)
+	{
+		Test->AddError(FString::Printf(TEXT("Timed out waiting for %d AVICharacterBase players, check VI.test.NetMap uses a VaultIt game mode"), NumPlayers));
+		return true;
+	}
+
+	return false;
+}
+
+/** Spawns AI beside the players, builds a course in front of every runner, runs them and reports the network counters */
+class FVIRunVaultCourseCommand : public IAutomationLatentCommand
+{
+public:
+	FVIRunVaultCourseCommand(FAutomationTestBase* InTest, const FString& InVariantName, float InDuration, int32 InNumAIPawns, bool bInPlayerCourses)
+		: Test(InTest)
+		, VariantName(InVariantName)
+		, Duration(InDuration)
+		, NumAIPawns(InNumAIPawns)
+		, bPlayerCourses(bInPlayerCourses)
+	{}
+
+	virtual bool Update() override
+	{
+		UWorld* const ServerWorld = VIVaultNetTest::GetServerWorld();
+		if (!ServerWorld)
+		{
+			Test->AddError(TEXT("PIE session ended before the vault course finished"));
+			return true;
+		}
+
+		if (!bStarted)
+		{
+			SpawnAIPawns(ServerWorld);
+			BuildCourses(ServerWorld);
+			FVINetCounters::Get().Reset();
+			StartBytes = ServerWorld->GetNetDriver() ? ServerWorld->GetNetDriver()->OutTotalBytes : 0;
+			CourseStartTime = FPlatformTime::Seconds();
+			bStarted = true;
+			return false;
+		}
+
+		const double Elapsed = FPlatformTime::Seconds() - CourseStartTime;
+		if (Elapsed >= Duration)
+		{
+			Report(ServerWorld);
+			return true;
+		}
+
+		// Game thread time covers the server and every client, they all tick in this process
+		GameThreadMs += FPlatformTime::ToMilliseconds(GGameThreadTime);
+		NumFrames++;
+
+		// Every runner presses vault periodically while running forward
+		const bool bPressVault = FMath::Fmod(Elapsed, VIVaultNetTest::VaultInterval) < (VIVaultNetTest::VaultInterval * 0.5f);
+
+		// AI is scripted on the server, clients only see the result
+		for (const TWeakObjectPtr<AVICharacterBase>& AIPawn : AIPawns)
+		{
+			RunCourse(AIPawn.Get(), bPressVault);
+		}
+
+		// Players are scripted on their own client, the client predicts and the server validates
+		if (bPlayerCourses)
+		{
+			for (UWorld* World : VIVaultNetTest::GetPIEWorlds())
+			{
+				RunCourse(VIVaultNetTest::GetLocalCharacter(World), bPressVault);
+			}
+		}
+
+		return false;
+	}
+
+protected:
+	FAutomationTestBase* Test;
+	FString VariantName;
+	float Duration;
+	int32 NumAIPawns;
+	bool bPlayerCourses;
+
+	TArray<TWeakObjectPtr<AVICharacterBase>> AIPawns;
+
+	bool bStarted = false;
+	double CourseStartTime = 0.0;
+	uint64 StartBytes = 0;
+	double GameThreadMs = 0.0;
+	int32 NumFrames = 0;
+
+	static void RunCourse(AVICharacterBase* Character, bool bPressVault)
+	{
+		if (!Character)
+		{
+			return;
+		}
+
+		Character->AddMovementInput(Character->GetActorForwardVector(), 1.f);
+		if (bPressVault)
+		{
+			Character->Jump();
+		}
+		else
+		{
+			Character->StopJumping();
+		}
+	}
+
+	/** AI uses the players' pawn class, lined up beside the first player facing the same way */
+	void SpawnAIPawns(UWorld* ServerWorld)
+	{
+		const APlayerController* FirstPC = ServerWorld->GetFirstPlayerController();
+		const AVICharacterBase* Player = FirstPC ? Cast<AVICharacterBase>(FirstPC->GetPawn()) : nullptr;
+		if (!Player)
+		{
+			return;
+		}
+
+		FActorSpawnParameters Params;
+		Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+		const FVector Right = Player->GetActorRightVector().GetSafeNormal2D();
+		for (int32 Idx = 1; Idx <= NumAIPawns; Idx++)
+		{
+			const FVector Location = Player->GetActorLocation() + (Right * VIVaultNetTest::LaneSpacing * Idx);
+			AVICharacterBase* AIPawn = ServerWorld->SpawnActor<AVICharacterBase>(Player->GetClass(), Location, Player->GetActorRotation(), Params);
+			if (AIPawn)
+			{
+				AIPawn->SpawnDefaultController();
+				AIPawns.Add(AIPawn);
+			}
+		}
+
+		if (AIPawns.Num() < NumAIPawns)
+		{
+			Test->AddError(FString::Printf(TEXT("Spawned %d of %d AI pawns"), AIPawns.Num(), NumAIPawns));
+		}
+	}
+
+	/** The same obstacles are spawned in every world, so clients predict against what the server validates */
+	void BuildCourses(UWorld* ServerWorld)
+	{
+		TArray<const AVICharacterBase*> Runners;
+		for (const TWeakObjectPtr<AVICharacterBase>& AIPawn : AIPawns)
+		{
+			Runners.Add(AIPawn.Get());
+		}
+
+		if (bPlayerCourses)
+		{
+			for (FConstPlayerControllerIterator It = ServerWorld->GetPlayerControllerIterator(); It; ++It)
+			{
+				Runners.Add(Cast<AVICharacterBase>(It->Get()->GetPawn()));
+			}
+		}
+
+		TArray<FTransform> Transforms;
+		for (const AVICharacterBase* Character : Runners)
+		{
+			if (!Character)
+			{
+				continue;
+			}
+
+			const float MaxSpeed = Character->GetCharacterMovement() ? Character->GetCharacterMovement()->GetMaxSpeed() : 600.f;
+			const float Length = (Duration * MaxSpeed) + VIVaultNetTest::ObstacleSpacing;
+			const int32 NumObstacles = FMath::CeilToInt(Length / VIVaultNetTest::ObstacleSpacing);
+
+			const FVector Forward = Character->GetActorForwardVector().GetSafeNormal2D();
+			const FQuat Rotation = Forward.ToOrientationQuat();
+			const FVector Feet = Character->GetActorLocation() - FVector(0.f, 0.f, Character->GetCapsuleComponent()->GetScaledCapsuleHalfHeight());
+
+			// Floor in case the map doesn't reach, cubes are 100 units and centered
+			const FVector FloorCenter = Feet + (Forward * Length * 0.5f) - FVector(0.f, 0.f, 10.f);
+			Transforms.Add(FTransform(Rotation, FloorCenter, FVector(Length / 100.f, 4.f, 0.2f)));
+
+			for (int32 Idx = 1; Idx <= NumObstacles; Idx++)
+			{
+				const FVector Location = Feet + (Forward * VIVaultNetTest::ObstacleSpacing * Idx) + FVector(0.f, 0.f, VIVaultNetTest::ObstacleHeight * 0.5f);
+				Transforms.Add(FTransform(Rotation, Location, FVector(0.3f, 2.f, VIVaultNetTest::ObstacleHeight / 100.f)));
+			}
+		}
+
+		for (UWorld* World : VIVaultNetTest::GetPIEWorlds())
+		{
+			for (const FTransform& Transform : Transforms)
+			{
+				VIVaultNetTest::SpawnCube(World, Transform);
+			}
+		}
+	}
+
+	void Report(UWorld* ServerWorld)
+	{
+		const FVINetCounters& Counters = FVINetCounters::Get();
+		const uint64 Bytes = ServerWorld->GetNetDriver() ? ((uint64)ServerWorld->GetNetDriver()->OutTotalBytes - StartBytes) : 0;
+		const int32 Vaults = Counters.VaultsStarted;
+		const double BytesPerVault = Vaults > 0 ? (double)Bytes / Vaults : 0.0;
+		const double MsPerFrame = NumFrames > 0 ? GameThreadMs / NumFrames : 0.0;
+
+		const FString Header = TEXT("Variant,Vaults,Corrections,Rollbacks,AntiCheatRejects,RequestsRejected,MontageSnaps,VaultEvents,ServerBytesOut,BytesPerVault,GameThreadMsPerFrame");
+		const FString Row = FString::Printf(TEXT("%s,%d,%d,%d,%d,%d,%d,%d,%llu,%.1f,%.2f"), *VariantName, Vaults, Counters.CorrectionsWhileVaulting, Counters.VaultsRolledBack,
+			Counters.AntiCheatRejects, Counters.VaultRequestsRejected, Counters.MontageSnaps, Counters.VaultEventsSent, Bytes, BytesPerVault, MsPerFrame);
+
+		Test->AddInfo(Header);
+		Test->AddInfo(Row);
+		UE_LOG(LogVaultItNetTest, Display, TEXT("%s"), *Header);
+		UE_LOG(LogVaultItNetTest, Display, TEXT("%s"), *Row);
+
+		const FString ReportPath = FPaths::Combine(FPaths::AutomationDir(), FString::Printf(TEXT("VaultItNet_%s.csv"), *VariantName));
+		FFileHelper::SaveStringToFile(Header + LINE_TERMINATOR + Row + LINE_TERMINATOR, *ReportPath);
+
+		if (Vaults == 0)
+		{
+			Test->AddError(TEXT("No vaults were performed, the course didn't exercise vaulting"));
+		}
+	}
+};
+
+/** Restores the emulation settings and ends PIE */
+DEFINE_LATENT_AUTOMATION_COMMAND(FVIEndVaultNetTestCommand);
+bool FVIEndVaultNetTestCommand::Update()
+{
+	VIVaultNetTest::SetPacketEmulation(0.f, 0);
+	if (GEditor->PlayWorld)
+	{
+		GEditor->RequestEndPlayMap();
+		return false;
+	}
+	return true;
+}
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FVIVaultNetTest, "VaultIt.Net.VaultCourse", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+void FVIVaultNetTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	// Loss percentage and one way latency in ms
+	OutBeautifiedNames.Add(TEXT("Clean"));
+	OutTestCommands.Add(TEXT("0 0"));
+
+	OutBeautifiedNames.Add(TEXT("Lossy"));
+	OutTestCommands.Add(TEXT("5 60"));
+
+	OutBeautifiedNames.Add(TEXT("Harsh"));
+	OutTestCommands.Add(TEXT("10 150"));
+}
+
+bool FVIVaultNetTest::RunTest(const FString& Parameters)
+{
+	TArray<FString> Args;
+	Parameters.ParseIntoArrayWS(Args);
+	const float PktLoss = Args.IsValidIndex(0) ? FCString::Atof(*Args[0]) : 0.f;
+	const int32 PktLag = Args.IsValidIndex(1) ? FCString::Atoi(*Args[1]) : 0;
+	const FString VariantName = FString::Printf(TEXT("Loss%g_Lag%d"), PktLoss, PktLag);
+
+	const int32 NumPlayers = FMath::Max(CVarVaultNetTestPlayers.GetValueOnGameThread(), 2);
+
+	if (!FEditorFileUtils::LoadMap(CVarVaultNetTestMap.GetValueOnGameThread(), false, false))
+	{
+		AddError(FString::Printf(TEXT("Failed to load %s"), *CVarVaultNetTestMap.GetValueOnGameThread()));
+		return false;
+	}
+
+	VIVaultNetTest::SetPacketEmulation(PktLoss, PktLag);
+
+	ULevelEditorPlaySettings* PlaySettings = NewObject<ULevelEditorPlaySettings>();
+	PlaySettings->SetPlayNetMode(EPlayNetMode::PIE_ListenServer);
+	PlaySettings->SetPlayNumberOfClients(NumPlayers);
+	PlaySettings->SetRunUnderOneProcess(true);
+
+	FRequestPlaySessionParams Params;
+	Params.WorldType = EPlaySessionWorldType::PlayInEditor;
+	Params.EditorPlaySettings = PlaySettings;
+	GEditor->RequestPlaySession(Params);
+
+	ADD_LATENT_AUTOMATION_COMMAND(FVIWaitForPlayersCommand(this, NumPlayers));
+	ADD_LATENT_AUTOMATION_COMMAND(FVIRunVaultCourseCommand(this, VariantName, CVarVaultNetTestDuration.GetValueOnGameThread(),
+		FMath::Max(CVarVaultNetTestAIPawns.GetValueOnGameThread(), 0), CVarVaultNetTestPlayerCourses.GetValueOnGameThread() != 0));
+	ADD_LATENT_AUTOMATION_COMMAND(FVIEndVaultNetTestCommand());
+
+	return true;
+}
+
+#endif  // WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR && VI_WITH_NET_COUNTERS
@@ -108,6 +108,36 @@ FVIVaultInfo UVIBlueprintFunctionLibrary::GetVaultInfoFromTargetData(const FGame
 	return FVIVaultInfo();
 }
 
+UAnimMontage* UVIBlueprintFunctionLibrary::SelectVaultMontage(const FVIAnimSet& AnimSet, float Height, uint8 RandomSeed)
+{
+	// Walk the heights in order until one exceeds the vault height, then use it or the height before it, whichever is closer
+	// This is the same walk GA_Vault's FindBestAnim performs
+	const float* BestHeight = nullptr;
+	for (const TPair<float, FVIAnimations>& Pair : AnimSet.Animations)
+	{
+		if (Pair.Key > Height)
+		{
+			if (!BestHeight || FMath::Abs(Pair.Key - Height) < FMath::Abs(*BestHeight - Height))
+			{
+				BestHeight = &Pair.Key;
+			}
+			break;
+		}
+
+		BestHeight = &Pair.Key;
+	}
+
+	const FVIAnimations* BestAnimations = BestHeight ? AnimSet.Animations.Find(*BestHeight) : nullptr;
+	if (!BestAnimations || !BestAnimations->IsValid())
+	{
+		return nullptr;
+	}
+
+	// Same seed results in the same montage on both client and server, matches Array_RandomFromStream
+	const FRandomStream Stream(RandomSeed);
+	return BestAnimations->Animations[Stream.RandRange(0, BestAnimations->Animations.Num() - 1)];
+}
+
 bool UVIBlueprintFunctionLibrary::PredictLandingLocation(FPredictProjectilePathResult& OutPredictResult, ACharacter* ForCharacter, const TArray<TEnumAsByte<EObjectTypeQuery>>& ObjectTypes, bool bTraceComplex)
 {
 	if (!ForCharacter)
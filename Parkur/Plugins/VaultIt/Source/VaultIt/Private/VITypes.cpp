@@ -1,27 +1,42 @@
 // Copyright (c) 2019-2022 Drowning Dragons Limited. All Rights Reserved.
 
 #include "VITypes.h"
+#include "Animation/AnimMontage.h"
 
-bool FVIGameplayAbilityTargetData_VaultInfo::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+#if VI_WITH_NET_COUNTERS
+FVINetCounters& FVINetCounters::Get()
+{
+	static FVINetCounters Counters;
+	return Counters;
+}
+#endif
+
+bool FVIVaultInfo::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
 {
-	FVector_NetQuantize10 VaultLocation = FVector_NetQuantize10(VaultInfo.Location);
-	FVector_NetQuantize10 VaultDirection = FVector_NetQuantize10(VaultInfo.Direction);
+	FVector_NetQuantize10 VaultLocation = FVector_NetQuantize10(Location);
+	FVector_NetQuantize10 VaultDirection = FVector_NetQuantize10(Direction);
 	VaultLocation.NetSerialize(Ar, Map, bOutSuccess);
 	VaultDirection.NetSerialize(Ar, Map, bOutSuccess);
-	
-	Ar << VaultInfo.Height;
-	Ar << VaultInfo.RandomSeed;
-	
+
+	// Full precision, montage selection depends on it
+	Ar << Height;
+	Ar << RandomSeed;
+
 	if (Ar.IsLoading())
 	{
-		VaultInfo.Location = VaultLocation;
-		VaultInfo.Direction = VaultDirection;
+		Location = VaultLocation;
+		Direction = VaultDirection;
 	}
-	
+
 	bOutSuccess = true;
 	return true;
 }
 
+bool FVIGameplayAbilityTargetData_VaultInfo::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+{
+	return VaultInfo.NetSerialize(Ar, Map, bOutSuccess);
+}
+
 bool FVIRepMotionMatch::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
 {
 	FVector_NetQuantize10 NetLocation = FVector_NetQuantize10(Location);
@@ -38,3 +53,29 @@ bool FVIRepMotionMatch::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool&
 	bOutSuccess = true;
 	return true;
 }
+
+bool FVIRepVaultEvent::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+{
+	FVector_NetQuantize10 NetLocation = FVector_NetQuantize10(Location);
+	FVector_NetQuantize10 NetDirection = FVector_NetQuantize10(Direction);
+	NetLocation.NetSerialize(Ar, Map, bOutSuccess);
+	NetDirection.NetSerialize(Ar, Map, bOutSuccess);
+
+	UObject* NetMontage = Montage;
+	Map->SerializeObject(Ar, UAnimMontage::StaticClass(), NetMontage);
+
+	Ar << PlayRate;
+	Ar << RandomSeed;
+	Ar << ServerTimestamp;
+	Ar << EventId;
+
+	if (Ar.IsLoading())
+	{
+		Location = NetLocation;
+		Direction = NetDirection;
+		Montage = Cast<UAnimMontage>(NetMontage);
+	}
+
+	bOutSuccess = true;
+	return true;
+}
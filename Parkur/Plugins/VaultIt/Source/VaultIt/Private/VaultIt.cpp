@@ -1,18 +1,21 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "VaultIt.h"
+#include "Animation/VIFBIKTraceBatch.h"
 
 #define LOCTEXT_NAMESPACE "FVaultItModule"
 
 void FVaultItModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+	FVIFBIKTraceBatch::Get().RegisterDelegates();
 }
 
 void FVaultItModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	FVIFBIKTraceBatch::Get().UnregisterDelegates();
 }
 
 #undef LOCTEXT_NAMESPACE
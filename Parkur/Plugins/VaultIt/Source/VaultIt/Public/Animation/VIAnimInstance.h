@@ -5,13 +5,34 @@
 #include "CoreMinimal.h"
 #include "Animation/AnimInstance.h"
 #include "VIAnimationInterface.h"
+#include "VIRootMotionModifier_AdjustmentBlendWarp.h"
 #include "VITypes.h"
 #include "VIAnimInstance.generated.h"
 
 class AVICharacterBase;
 
+/** Character state copied on the game thread for NativeThreadSafeUpdateAnimation(), bIsVaulting is copied straight to the anim instance */
+struct FVIAnimCharacterData
+{
+	bool bIsFalling = false;
+	bool bIsAscending = false;
+	float Speed = 0.f;
+};
+
+/** SetBoneFBIK() call buffered until the next animation update */
+struct FVIFBIKWrite
+{
+	/** Index in FBIK, INDEX_NONE to find it by BoneName */
+	int32 Slot = INDEX_NONE;
+	FName BoneName;
+	FVector Location = FVector::ZeroVector;
+	bool bEnabled = false;
+};
+
 /**
- * 
+ * Reads the character on the game thread in NativeUpdateAnimation() and does everything else in NativeThreadSafeUpdateAnimation(),
+ * so the update can run on a worker thread when multi threaded animation update is enabled
+ * That also needs the anim blueprint's event graph and property access to be thread safe, which is up to the blueprint
  */
 UCLASS()
 class VAULTIT_API UVIAnimInstance : public UAnimInstance, public IVIAnimationInterface
@@ -51,7 +72,7 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = FBIK, meta = (DisplayName = "L Hand Loc"))
 	FVector LHandLoc;
 
-	/** Is currently vaulting */
+	/** Is currently vaulting, copied from the character in NativeUpdateAnimation() */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Vault)
 	bool bIsVaulting;
 
@@ -59,6 +80,10 @@ protected:
 	UPROPERTY(BlueprintReadWrite, Category = References)
 	AVICharacterBase* Character;
 
+	/** Resolved once on initialization, pass to GetIKBoneTransformAndAlphaFromHandle() to get warped IK bones without searching the character */
+	UPROPERTY(BlueprintReadOnly, Category = References)
+	FVIAdjustmentBlendWarpIKHandle IKWarpHandle;
+
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = AnimGraph)
 	bool bIsJumping;
 
@@ -68,15 +93,34 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = AnimGraph)
 	float Speed;
 
+	/** Index in FBIK of the right and left hand, resolved once on initialization */
+	int32 RHandSlot;
+	int32 LHandSlot;
+
+	/** Copied in NativeUpdateAnimation() */
+	FVIAnimCharacterData CharacterData;
+
+	/** SetBoneFBIK() calls since the last update, only touched on the game thread */
+	TArray<FVIFBIKWrite, TInlineAllocator<4>> PendingFBIKWrites;
+
+	/** Moved from PendingFBIKWrites by NativeUpdateAnimation() and applied by NativeThreadSafeUpdateAnimation() */
+	TArray<FVIFBIKWrite, TInlineAllocator<4>> FBIKWrites;
+
+	/** Buffers the write, replacing an earlier one for the same bone */
+	void QueueFBIKWrite(int32 Slot, const FName& BoneName, const FVector& BoneLocation, bool bEnabled);
+
 public:
 	UVIAnimInstance()
 		: RHandName(TEXT("hand_r"))
 		, LHandName(TEXT("hand_l"))
 		, FBIK( { FVIBoneFBIKData(RHandName), FVIBoneFBIKData(LHandName) } )
+		, RHandSlot(INDEX_NONE)
+		, LHandSlot(INDEX_NONE)
 	{}
 
 	virtual void NativeInitializeAnimation() override;
 	virtual void NativeUpdateAnimation(float DeltaTime) override;
+	virtual void NativeThreadSafeUpdateAnimation(float DeltaTime) override;
 
 protected:
 	virtual void OnStartVault();
@@ -93,7 +137,18 @@ protected:
 public:
 	/**
 	 * Called by anim notify when a bone has its location updated for FBIK
+	 * Buffered on the game thread and applied by the next animation update, the anim graph sees the bone one update after the call.
+	 * Notifies are dispatched after the update that triggered them, so a notify's write shows from the following frame
 	 */
 	UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category = Vault)
 	void SetBoneFBIK(const FName& BoneName, const FVector& BoneLocation, bool bEnabled);
+
+	/**
+	 * @return Index in FBIK for BoneName to pass to SetBoneFBIKSlot(), so callers setting the same bone every frame resolve it once
+	 * INDEX_NONE if there is no such bone, or if SetBoneFBIK is overridden by blueprint and must be called instead
+	 */
+	int32 FindFBIKSlot(const FName& BoneName) const;
+
+	/** Same as SetBoneFBIK() using an index from FindFBIKSlot(), with the same one update delay */
+	void SetBoneFBIKSlot(int32 Slot, const FVector& BoneLocation, bool bEnabled);
 };
@@ -9,6 +9,8 @@
 class USkeletalMeshComponent;
 class UAnimSequenceBase;
 class APawn;
+class UAnimInstance;
+struct FVIFBIKTraceSlot;
 
 UENUM(BlueprintType)
 enum class EVIFBIKUpdateType : uint8
@@ -33,7 +35,10 @@ enum class EVIFBIKTraceType : uint8
 	FTT_ComplexLocalOnly			UMETA(DisplayName = "Geometry Local Player Only", ToolTip = "Use the object's geometry to trace against for the local player only, otherwise use the object's collision"),
 };
 
-/** AnimNotifyState used to setup FBIK for a bone during a window in the animation */
+/**
+ * AnimNotifyState used to setup FBIK for a bone during a window in the animation
+ * The notify is shared by every mesh playing the animation, state for each mesh lives in its FVIFBIKTraceSlot
+ */
 UCLASS(meta = (DisplayName = "VI FBIK"))
 class VAULTIT_API UVIAnimNotifyState_FBIK : public UAnimNotifyState
 {
@@ -93,6 +98,13 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = AnimNotify, meta = (EditCondition = "UpdateType == EVIFBIKUpdateType::FUT_Tick"))
 	uint8 TickSkipAmount;
 
+	/**
+	 * How fast the bone moves to a new hit location, 0 to snap to it
+	 * Trace results arrive a frame late, interpolating hides the step when the surface changes
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = AnimNotify, meta = (ClampMin = "0", UIMin = "0"))
+	float HitInterpSpeed;
+
 	/**
 	 * Which network roles to apply the FBIK to
 	 */
@@ -105,13 +117,6 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = AnimNotify)
 	bool bDebugTraceDuringPIE;
 
-protected:
-	/** When notify begins, caches bone offset lateral (the side of) to the owner */
-	float LateralOffset;
-
-	uint8 SkippedTicks;
-
-public:
 	UVIAnimNotifyState_FBIK()
 		: BoneName(TEXT("hand_r"))
 		, TraceLength(40.f)
@@ -121,10 +126,9 @@ public:
 		, TraceType(EVIFBIKTraceType::FTT_ComplexLocalOnly)
 		, UpdateType(EVIFBIKUpdateType::FUT_Tick)
 		, TickSkipAmount(3)
+		, HitInterpSpeed(0.f)
 		, ApplyToRoles(EVIFBIKUpdateRole::FUR_All)
 		, bDebugTraceDuringPIE(false)
-		, LateralOffset(0.f)
-		, SkippedTicks(0)
 	{
 #if WITH_EDITOR
 		NotifyColor = FColor::Cyan;
@@ -140,8 +144,15 @@ public:
 	virtual void NotifyEnd(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation) override final;
 
 protected:
+	/** Queues the surface trace, the result is applied by ApplyFBIK() once it arrives */
 	void UpdateFBIK(USkeletalMeshComponent* MeshComp);
 
+	/** Places the bone using the latest trace result */
+	void ApplyFBIK(USkeletalMeshComponent* MeshComp, float DeltaTime);
+
+	/** Sets the bone on the anim instance, by the slot resolved on NotifyBegin if there is one */
+	void SetBoneFBIK(UAnimInstance* AnimInstance, const FVIFBIKTraceSlot& Slot, const FVector& Location, bool bEnabled) const;
+
 	static APawn* GetPawnOwner(const USkeletalMeshComponent* const MeshComp);
 
 	bool HasValidRole(APawn* const PawnOwner) const;
@@ -0,0 +1,203 @@
+// Copyright (c) 2019-2022 Drowning Dragons Limited. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Engine/HitResult.h"
+#include "UObject/ObjectKey.h"
+#include "WorldCollision.h"
+
+class UWorld;
+class USkeletalMeshComponent;
+class UVIAnimNotifyState_FBIK;
+
+/** Surface trace for placing an FBIK bone */
+struct VAULTIT_API FVIFBIKTraceRequest
+{
+	FVector Start = FVector::ZeroVector;
+	FVector End = FVector::ZeroVector;
+	float Radius = 0.f;
+	FCollisionObjectQueryParams ObjectQueryParams;
+	FCollisionQueryParams QueryParams;
+
+	/** Draws the trace once the result arrives, for DrawTime or a single frame if 0 */
+	bool bDrawDebug = false;
+	float DrawTime = 0.f;
+
+	/** Traces over the per frame budget go out in order of priority, the rest wait */
+	float Priority = 0.f;
+
+	/** Always issued, used for the local player */
+	bool bExemptFromBudget = false;
+};
+
+/** How much FBIK a mesh gets this frame, from its screen size and distance to the closest local viewer */
+struct VAULTIT_API FVIFBIKSignificance
+{
+	/** 0 if FBIK is off for the mesh, up to 1 for the mesh filling the screen */
+	float Significance = 1.f;
+
+	/** Ticks to skip between traces, the notify's TickSkipAmount plus more the less significant the mesh */
+	int32 TickSkipAmount = 0;
+
+	/** Whether trace against geometry is allowed, otherwise collision is used */
+	bool bAllowComplexTrace = true;
+
+	/** Local players always get the full budget */
+	bool bLocalPlayer = false;
+
+	FORCEINLINE bool IsCulled() const { return Significance <= 0.f; }
+};
+
+/** Trace and placement state of the bone placed by one FBIK notify on one mesh */
+struct VAULTIT_API FVIFBIKTraceSlot
+{
+	/** When notify begins, caches bone offset lateral (the side of) to the owner */
+	float LateralOffset = 0.f;
+
+	/** Index of the bone in the UVIAnimInstance's FBIK, INDEX_NONE to go through IVIAnimationInterface */
+	int32 AnimFBIKSlot = INDEX_NONE;
+
+	/** Ticks skipped since the last trace, so each mesh is throttled on its own. Starts maxed so the first update always traces */
+	uint8 SkippedTicks = MAX_uint8;
+
+	/** Frames the pending request has waited on the budget, ages its priority so it can't starve */
+	uint16 FramesDeferred = 0;
+
+	/** Queued this frame, issued with the rest of the world's traces after actors tick */
+	TOptional<FVIFBIKTraceRequest> PendingRequest;
+
+	/** Id of the trace in flight, 0 if there is none */
+	uint32 InFlightId = 0;
+
+	/** Trace in flight, only kept when it's drawn once the result arrives */
+	TOptional<FVIFBIKTraceRequest> InFlightDebugRequest;
+
+	TWeakObjectPtr<UWorld> World;
+
+	/**
+	 * NotifyBegins not ended yet. Overlapping montage instances of the same animation (eg. a vault blending out as the next one blends in)
+	 * share the slot, the old instance's NotifyEnd must not remove it from under the live one
+	 */
+	int32 NumBegun = 0;
+
+	/** Set when a result arrives, cleared by whoever consumes it */
+	bool bHasNewResult = false;
+	FHitResult Result;
+
+	/** FBIK is off while the mesh is insignificant, results arriving meanwhile are ignored */
+	bool bCulled = false;
+
+	/** Where the bone is planted and where it is heading to, placement blends towards each new hit */
+	bool bPlaced = false;
+	FVector PlacedLocation = FVector::ZeroVector;
+	FVector TargetLocation = FVector::ZeroVector;
+};
+
+/**
+ * Owns the state of every FBIK notify on every mesh and batches their surface traces
+ * Slots live from NotifyBegin to NotifyEnd, the map keeps its storage so vaults in quick succession don't allocate
+ * Traces queued during the frame are issued together as async sweeps after actors tick and their results are read the next frame,
+ * so bone placement never waits on a physics query. VI.FBIK.AsyncTraces 0 traces synchronously when queued instead
+ *
+ * Game thread only
+ */
+class VAULTIT_API FVIFBIKTraceBatch
+{
+public:
+	static FVIFBIKTraceBatch& Get();
+
+	/** Starts the slot over for a NotifyBegin, a trace still in flight from a previous window is ignored */
+	FVIFBIKTraceSlot& BeginSlot(const USkeletalMeshComponent* Mesh, const UVIAnimNotifyState_FBIK* Notify);
+	FVIFBIKTraceSlot* FindSlot(const USkeletalMeshComponent* Mesh, const UVIAnimNotifyState_FBIK* Notify);
+
+	/**
+	 * Ends one NotifyBegin of the slot, it is removed once every NotifyBegin has ended
+	 * @return False if another montage instance still uses the slot
+	 */
+	bool RemoveSlot(const USkeletalMeshComponent* Mesh, const UVIAnimNotifyState_FBIK* Notify);
+
+	/**
+	 * Significance of the mesh against every local player's camera
+	 * Meshes that weren't rendered recently, beyond VI.FBIK.MaxDistance or smaller than VI.FBIK.MinScreenSize are culled
+	 */
+	FVIFBIKSignificance ComputeSignificance(const USkeletalMeshComponent* Mesh, bool bLocalPlayer, uint8 TickSkipAmount);
+
+	/** Queues a trace for the slot, replacing one queued earlier in the frame */
+	void QueueTrace(const USkeletalMeshComponent* Mesh, const UVIAnimNotifyState_FBIK* Notify, FVIFBIKTraceRequest&& Request);
+
+	/** Called by the module */
+	void RegisterDelegates();
+	void UnregisterDelegates();
+
+protected:
+	struct FSlotKey
+	{
+		FObjectKey Mesh;
+		FObjectKey Notify;
+
+		FORCEINLINE bool operator==(const FSlotKey& Other) const { return Mesh == Other.Mesh && Notify == Other.Notify; }
+
+		friend FORCEINLINE uint32 GetTypeHash(const FSlotKey& Key)
+		{
+			return HashCombine(GetTypeHash(Key.Mesh), GetTypeHash(Key.Notify));
+		}
+	};
+
+	TMap<FSlotKey, FVIFBIKTraceSlot> Slots;
+
+	/** Slot of each trace in flight by id */
+	TMap<uint32, FSlotKey> InFlight;
+
+	/** Slots with a pending request, issued after actors tick */
+	TArray<FSlotKey> Queued;
+
+	/** Never 0 */
+	uint32 NextTraceId = 1;
+
+	struct FViewPoint
+	{
+		FVector Location;
+		float TanHalfFOV;
+	};
+
+	/** Local player cameras, gathered once per frame */
+	TArray<FViewPoint, TInlineAllocator<4>> ViewPoints;
+	TWeakObjectPtr<const UWorld> ViewPointsWorld;
+	uint64 ViewPointsFrame = MAX_uint64;
+
+	void UpdateViewPoints(const UWorld* World);
+
+	/** Traces issued this frame across every world, the budget is per frame rather than per world */
+	int32 IssuedTraces = 0;
+	uint64 IssuedTracesFrame = MAX_uint64;
+
+	/** @return Traces issued this frame, reset on the first call of a frame */
+	int32& GetIssuedTraces();
+
+	/** Frame slots of destroyed meshes were last pruned on, once per frame however many worlds tick */
+	uint64 PruneFrame = MAX_uint64;
+
+	struct FCandidate
+	{
+		FSlotKey Key;
+		float Priority;
+		bool bExemptFromBudget;
+	};
+
+	/** Reused by OnWorldPostActorTick */
+	TArray<FCandidate> Candidates;
+
+	void IssueTrace(UWorld* World, const FSlotKey& Key, FVIFBIKTraceSlot& Slot);
+
+	FTraceDelegate TraceDelegate;
+
+	FDelegateHandle WorldPostActorTickHandle;
+
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	void OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Datum);
+
+	static void DrawDebugTrace(const UWorld* World, const FVIFBIKTraceRequest& Request, const FHitResult& Hit);
+};
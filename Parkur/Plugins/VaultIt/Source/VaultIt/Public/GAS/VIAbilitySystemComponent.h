@@ -23,19 +23,26 @@ public:
 	UPROPERTY()
 	FGameplayAbilityLocalAnimMontage LocalMontageInfo;
 
+	/** False if the montage is not replicated to simulated proxies (eg. sent via AVICharacterBase::RepVaultEvent instead) */
+	UPROPERTY()
+	bool bReplicateMontage;
+
 	FVIGameplayAbilityLocalAnimMontageForMesh() 
 		: Mesh(nullptr)
+		, bReplicateMontage(true)
 	{
 	}
 
 	FVIGameplayAbilityLocalAnimMontageForMesh(USkeletalMeshComponent* InMesh)
 		: Mesh(InMesh)
+		, bReplicateMontage(true)
 	{
 	}
 
 	FVIGameplayAbilityLocalAnimMontageForMesh(USkeletalMeshComponent* InMesh, FGameplayAbilityLocalAnimMontage& InLocalMontageInfo)
 		: Mesh(InMesh)
 		, LocalMontageInfo(InLocalMontageInfo)
+		, bReplicateMontage(true)
 	{
 	}
 };
@@ -85,6 +92,7 @@ protected:
 
 	/**
 	 * Replicates montage info to simulated clients
+	 * Push based, only compared for replication when a montage is playing or changes state
 	 */
 	UPROPERTY(ReplicatedUsing = OnRep_ReplicatedAnimMontageForMesh)
 	TArray<FVIGameplayAbilityRepAnimMontageForMesh> RepAnimMontageInfoForMeshes;
@@ -132,6 +140,15 @@ protected:
 	/** Finds existing FGameplayAbilityRepAnimMontageForMesh for the mesh or creates one if it doesn't exist */
 	FVIGameplayAbilityRepAnimMontageForMesh& GetGameplayAbilityRepAnimMontageForMesh(USkeletalMeshComponent* InMesh);
 
+	/** Mark RepAnimMontageInfoForMeshes for replication */
+	void MarkRepAnimMontageInfoDirty();
+
+	/**
+	 * @return True if our avatar is beyond VI.net.CosmeticMontageDistance from every viewer, ie. every other player on the server or the local player on clients
+	 * The server then only sends montage position along with other changes, and simulated proxies skip position correction
+	 */
+	bool IsCosmeticOnlyForViewers() const;
+
 	/** Called when a prediction key that played a montage is rejected */
 	void OnPredictiveMontageRejectedForMesh(USkeletalMeshComponent* InMesh, UAnimMontage* PredictiveMontage);
 
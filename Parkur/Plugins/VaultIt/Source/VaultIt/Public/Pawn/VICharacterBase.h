@@ -10,6 +10,7 @@
 
 class UVIMotionWarpingComponent;
 class UVIPawnVaultComponent;
+class UGameplayAbility;
 
 /**
  * An incomplete character base class
@@ -59,7 +60,68 @@ protected:
 	UPROPERTY(ReplicatedUsing="OnRep_MotionMatch", BlueprintReadWrite, Category = Vault)
 	FVIRepMotionMatch RepMotionMatch;
 
+	/**
+	 * If true, simulated proxies receive a single vault event (sync point, montage, seed and server timestamp)
+	 * and play the vault locally instead of receiving bRepIsVaulting, RepMotionMatch and the vault montage
+	 * Simulated proxies will not perform montage position correction for vaults
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Vault|Replication")
+	bool bUseCompactVaultEvent;
+
+	/** Simulated proxies use this to play the vault locally when bUseCompactVaultEvent is enabled */
+	UPROPERTY(ReplicatedUsing="OnRep_VaultEvent", BlueprintReadOnly, Category = Vault)
+	FVIRepVaultEvent RepVaultEvent;
+
+	/**
+	 * If true, replays record a single keyframe per vault (ReplayVaultEvent) instead of bRepIsVaulting and RepMotionMatch
+	 * Replay playback rebuilds the vault from the keyframe, which also handles scrubbing and fast-forwarding
+	 * Combine with bUseCompactVaultEvent so the vault montage isn't recorded by the ability system either
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Vault|Replication")
+	bool bUseReplayVaultEvent;
+
+	/** Only recorded into replays, used when bUseReplayVaultEvent is enabled */
+	UPROPERTY(ReplicatedUsing="OnRep_ReplayVaultEvent", BlueprintReadOnly, Category = Vault)
+	FVIRepVaultEvent ReplayVaultEvent;
+
+	/** Random seed sent with the next vault event, provided by ReplicateVaultInfo() */
+	UPROPERTY()
+	uint8 PendingVaultEventSeed;
+
+	/** Last vault event played by this simulated proxy */
+	UPROPERTY()
+	uint8 LastVaultEventId;
+
+	/**
+	 * If true, the vault montage only animates and the character is moved by FVIRootMotionSource_Vault
+	 * which follows the warped montage trajectory
+	 * CharacterMovementComponent predicts and replicates root motion sources inside saved moves
+	 * so montage position is no longer movement-critical
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Vault|Movement")
+	bool bUseRootMotionSource;
+
+	/** Blend out time is excluded from the root motion source duration so we land before blending out */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Vault|Movement", meta = (EditCondition = "bUseRootMotionSource"))
+	bool bEndRootMotionSourceOnBlendOut;
+
+	/** ID of the active vault root motion source, 0 if none */
+	uint16 VaultRootMotionSourceID;
+
+	/** Root motion mode to restore on the vault mesh's anim instance after using a root motion source */
+	TEnumAsByte<ERootMotionMode::Type> CachedRootMotionMode;
+
+	/** True while a vault started by ExecuteVault() is playing */
+	UPROPERTY()
+	bool bExecutingVault;
+
+	/** Montage played by ExecuteVault() */
+	UPROPERTY()
+	UAnimMontage* ExecutedVaultMontage;
+
 public:
+	AVICharacterBase(const FObjectInitializer& OI);
+
 	virtual void BeginPlay() override;
 
 	virtual void CheckJumpInput(float DeltaTime) override;
@@ -77,15 +139,86 @@ public:
 	UFUNCTION(BlueprintImplementableEvent, Category = Vault)
 	void OnStopVaultAbility();
 
+	/**
+	 * Optional alternative to ReplicateMotionMatch for GA_Vault
+	 * Also sends the random seed to simulated proxies when using bUseCompactVaultEvent
+	 */
+	UFUNCTION(BlueprintCallable, Category = Vault)
+	void ReplicateVaultInfo(const FVIVaultInfo& VaultInfo);
+
+	/**
+	 * Called by UVIAbilitySystemComponent on authority when an ability plays a montage
+	 * @return True if the montage is sent via RepVaultEvent and should not be replicated by the ability system
+	 */
+	virtual bool ReplicateVaultMontage(UGameplayAbility* AnimatingAbility, UAnimMontage* Montage, float PlayRate);
+
+	/** @return True if Montage is played locally from RepVaultEvent, or ReplayVaultEvent during replay playback */
+	bool IsVaultEventMontage(const UAnimMontage* Montage) const;
+
+	/** @return Vault event that simulated proxies play vaults from, nullptr if vaults are replicated by the ability system */
+	const FVIRepVaultEvent* GetActiveVaultEvent() const;
+
+	/** @return True if Ability is (or is derived from) the vault ability */
+	bool IsVaultAbility(const UGameplayAbility* Ability) const;
+
+	/** Called by UVIAbilitySystemComponent on authority and predicting clients when the vault ability plays a montage */
+	virtual void OnVaultMontageStarted(UAnimMontage* Montage, float PlayRate);
+
+	/**
+	 * Performs the vault without activating VaultAbility, used when vaults are predicted through saved moves
+	 * Selects the montage from VaultInfo's height and random seed so client and server play the same vault
+	 * @return True if the vault started
+	 */
+	virtual bool ExecuteVault(const FVIVaultInfo& VaultInfo);
+
+	/** Called by UVICharacterMovementComponent when a server correction shows the server did not perform our vault */
+	virtual void OnVaultRejected();
+
+protected:
+	/** Sends the montage to simulated proxies via RepVaultEvent */
+	void SendVaultEvent(UAnimMontage* Montage, float PlayRate);
+
+	/** Records the montage into replays via ReplayVaultEvent */
+	void RecordReplayVaultEvent(UAnimMontage* Montage, float PlayRate);
+
+	/** Fills VaultEvent with the current vault, does not consume PendingVaultEventSeed */
+	void FillVaultEvent(FVIRepVaultEvent& VaultEvent, UAnimMontage* Montage, float PlayRate) const;
+
+	/** Vault started by ExecuteVault() is finishing, removes the vault state */
+	void OnExecutedVaultBlendingOut(UAnimMontage* Montage, bool bInterrupted);
+
+	void EndExecutedVault();
+
+	/** Starts moving along the vault montage using FVIRootMotionSource_Vault */
+	void ApplyVaultRootMotionSource(UAnimMontage* Montage, float PlayRate);
+
+	/** Removes the vault root motion source and restores anim root motion */
+	void RemoveVaultRootMotionSource();
+
 protected:
 	UFUNCTION()
 	void OnRep_MotionMatch();
 
+	UFUNCTION()
+	void OnRep_VaultEvent();
+
+	UFUNCTION()
+	void OnRep_ReplayVaultEvent();
+
+	/** Updates the sync point and plays the vault if it is new */
+	void HandleVaultEvent(const FVIRepVaultEvent& VaultEvent);
+
+	/** Plays the montage from VaultEvent, skipping ahead by the time since the server started it */
+	void PlayVaultEventMontage(const FVIRepVaultEvent& VaultEvent);
+
+	/** @return Server world time if available */
+	double GetServerWorldTimeSeconds() const;
+
 public:
 	/**
 	 * @return True if vaulting
 	 * Correct value must be returned based on net role here
-	 * Simulated proxies return bRepIsVaulting
+	 * Simulated proxies return bRepIsVaulting, or whether the vault event (or replay vault event) montage is playing
 	 * Server & Authority must return CMC bIsVaulting
 	 */
 	UFUNCTION(BlueprintPure, Category = Vault)
@@ -0,0 +1,180 @@
+// Copyright (c) 2019-2022 Drowning Dragons Limited. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "VITypes.h"
+#include "VICharacterMovementComponent.generated.h"
+
+class UVICharacterMovementComponent;
+
+/**
+ * Saved move carrying a vault request so the vault starts on the same move on client and server
+ */
+class VAULTIT_API FVISavedMove_Character : public FSavedMove_Character
+{
+	using Super = FSavedMove_Character;
+
+public:
+	/** True if the vault was requested during this move */
+	bool bHasVaultRequest;
+
+	/** Vault requested during this move */
+	FVIVaultInfo VaultRequest;
+
+	FVISavedMove_Character()
+		: bHasVaultRequest(false)
+	{}
+
+	virtual void Clear() override;
+	virtual void SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, class FNetworkPredictionData_Client_Character& ClientData) override;
+	virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+	virtual bool IsImportantMove(const FSavedMovePtr& LastAckedMove) const override;
+};
+
+class VAULTIT_API FVINetworkPredictionData_Client_Character : public FNetworkPredictionData_Client_Character
+{
+	using Super = FNetworkPredictionData_Client_Character;
+
+public:
+	FVINetworkPredictionData_Client_Character(const UCharacterMovementComponent& ClientMovement)
+		: Super(ClientMovement)
+	{}
+
+	virtual FSavedMovePtr AllocateNewMove() override;
+};
+
+/**
+ * Move data sent to the server, the vault request costs a single bit when not vaulting
+ */
+struct VAULTIT_API FVICharacterNetworkMoveData : public FCharacterNetworkMoveData
+{
+	using Super = FCharacterNetworkMoveData;
+
+	bool bHasVaultRequest;
+
+	FVIVaultInfo VaultRequest;
+
+	FVICharacterNetworkMoveData()
+		: bHasVaultRequest(false)
+	{}
+
+	virtual void ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType) override;
+	virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType) override;
+};
+
+struct VAULTIT_API FVICharacterNetworkMoveDataContainer : public FCharacterNetworkMoveDataContainer
+{
+	FVICharacterNetworkMoveDataContainer()
+	{
+		NewMoveData = &VaultMoveData[0];
+		PendingMoveData = &VaultMoveData[1];
+		OldMoveData = &VaultMoveData[2];
+	}
+
+	FVICharacterNetworkMoveData VaultMoveData[3];
+};
+
+/**
+ * Character movement with a lightweight custom movement mode used while vaulting
+ *
+ * The vault path was already validated by ComputeVault's capsule-fit trace so the
+ * vault movement mode moves along root motion with a single sweep per frame on a
+ * slightly shrunk capsule, and no floor checks until the vault ends
+ */
+UCLASS()
+class VAULTIT_API UVICharacterMovementComponent : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+
+public:
+	/** If true, vaulting uses the vault custom movement mode instead of MOVE_Flying */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Vaulting")
+	bool bUseVaultMovementMode;
+
+	/** Custom movement mode used while vaulting, change this if it conflicts with your own custom movement modes */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Vaulting", meta = (EditCondition = "bUseVaultMovementMode"))
+	uint8 VaultCustomMovementMode;
+
+	/** Capsule is shrunk by this amount when sweeping during the vault so it does not catch on the ledge */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Vaulting", meta = (EditCondition = "bUseVaultMovementMode", ClampMin = "0", UIMin = "0"))
+	float VaultCapsuleShrinkAmount;
+
+public:
+	UVICharacterMovementComponent()
+		: bUseVaultMovementMode(true)
+		, VaultCustomMovementMode(0)
+		, VaultCapsuleShrinkAmount(2.f)
+		, bHasClientVaultRequest(false)
+		, bHasServerVaultRequest(false)
+		, bHasPendingVaultRequest(false)
+	{
+		SetNetworkMoveDataContainer(VaultMoveDataContainer);
+	}
+
+	/** Enter the vault movement mode (or MOVE_Flying if not using bUseVaultMovementMode) so root motion can move on Z */
+	virtual void StartVaultMovement();
+
+	/** Exit the vault into walking if there is a walkable floor, otherwise falling */
+	virtual void StopVaultMovement();
+
+	/** @return True if in the vault movement mode */
+	UFUNCTION(BlueprintPure, Category = "Pawn|Components|CharacterMovement")
+	bool IsVaultMovement() const;
+
+	/** @return True if the movement mode is the one used by StartVaultMovement() */
+	bool IsVaultMovementMode(EMovementMode InMovementMode, uint8 InCustomMovementMode) const;
+
+	/**
+	 * Autonomous proxy only
+	 * Sends the vault with the current move so the server starts it on the same move
+	 */
+	void RequestVault(const FVIVaultInfo& VaultInfo);
+
+	/**
+	 * Server only
+	 * @return True if the move being performed carries a vault request
+	 */
+	bool ConsumeVaultRequest(FVIVaultInfo& OutVaultInfo);
+
+	/** @return True if this client requested a vault that the server has not corrected yet */
+	bool HasPendingVaultRequest() const { return bHasPendingVaultRequest; }
+
+	/** Vault finished or was aborted, corrections no longer roll it back */
+	void ClearPendingVaultRequest() { bHasPendingVaultRequest = false; }
+
+	/** Used by FVISavedMove_Character to read the request for the move being saved */
+	bool GetClientVaultRequest(FVIVaultInfo& OutVaultInfo) const;
+
+	virtual FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+
+protected:
+	virtual void ReplicateMoveToServer(float DeltaTime, const FVector& NewAcceleration) override;
+
+	virtual void ServerMove_PerformMovement(const FCharacterNetworkMoveData& MoveData) override;
+
+	virtual void OnClientCorrectionReceived(class FNetworkPredictionData_Client_Character& ClientData, float TimeStamp, FVector NewLocation, FVector NewVelocity, UPrimitiveComponent* NewBase, FName NewBaseBoneName, bool bHasBase, bool bBaseRelativePosition, uint8 ServerMovementMode) override;
+
+	virtual void PhysCustom(float deltaTime, int32 Iterations) override;
+
+	/** Kinematic root motion movement used by the vault movement mode */
+	virtual void PhysVault(float deltaTime, int32 Iterations);
+
+	/** @return True if the move that carried our vault request has not been acknowledged by the server yet */
+	bool IsVaultRequestUnacknowledged(const FNetworkPredictionData_Client_Character& ClientData) const;
+
+protected:
+	/** Client vault request waiting to be saved into the next move */
+	bool bHasClientVaultRequest;
+	FVIVaultInfo ClientVaultRequest;
+
+	/** Server vault request read from the move being performed */
+	bool bHasServerVaultRequest;
+	FVIVaultInfo ServerVaultRequest;
+
+	/** True from sending our vault request until the vault ends or the server rejects it */
+	bool bHasPendingVaultRequest;
+
+	FVICharacterNetworkMoveDataContainer VaultMoveDataContainer;
+};
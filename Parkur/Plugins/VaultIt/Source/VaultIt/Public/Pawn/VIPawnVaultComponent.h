@@ -248,6 +248,23 @@ public:
 	UPROPERTY(EditDefaultsOnly, Category = "Vault|AntiCheat")
 	FVIAntiCheatSettings AntiCheatSettings;
 
+	/**
+	 * If true, vaults are sent to the server with the character's saved moves instead of activating VaultAbility
+	 * The vault starts on the same move for client and server, and server corrections roll back rejected vaults
+	 * Requires AVICharacterBase using UVICharacterMovementComponent, otherwise VaultAbility is activated as normal
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Vault|Network")
+	bool bPredictVaultWithMovement;
+
+	/**
+	 * If true, server controlled AI vaults directly instead of sending a gameplay event to activate VaultAbility
+	 * Skips the event payload, target data, anti-cheat and prediction keys which only exist to validate remote clients
+	 * Montage selection and gameplay effects are AVICharacterBase::ExecuteVault()'s, not VaultAbility's, only enable this if VaultAbility does nothing more than play the vault
+	 * Requires AVICharacterBase, otherwise VaultAbility is activated as normal
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Vault|Network")
+	bool bDirectVaultForAI;
+
 public:
 	UPROPERTY()
 	bool bVaultAbilityInitialized;
@@ -287,6 +304,8 @@ public:
 		, AutoVaultStates(0)
 		, AutoVaultCheckSkip(8)
 		, AntiCheatType(EVIAntiCheatType::VIACT_None)
+		, bPredictVaultWithMovement(false)
+		, bDirectVaultForAI(false)
 		, bVaultAbilityInitialized(false)
 		, bPressedVault(false)
 		, bLastJumpInputVaulted(false)
@@ -365,6 +384,18 @@ public:
 	bool ComputeShouldAutoVault();
 
 protected:
+	/**
+	 * Starts the vault locally and sends it with the next saved move
+	 * @return False if unable to predict through movement, VaultAbility should be activated instead
+	 */
+	bool TryPredictVaultWithMovement(const FVIVaultInfo& VaultInfo);
+
+	/**
+	 * Authority only, for pawns not controlled by a player
+	 * @return False if unable to vault directly, VaultAbility should be activated instead
+	 */
+	bool TryDirectVault(const FVIVaultInfo& VaultInfo);
+
 	/**
 	 * This is called on BeginPlay() to cache the default values from the owner
 	 * If owner is a Character then it will simply use the capsule sizes
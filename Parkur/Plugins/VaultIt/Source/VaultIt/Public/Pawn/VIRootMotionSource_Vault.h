@@ -0,0 +1,111 @@
+// Copyright (c) 2019-2022 Drowning Dragons Limited. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/RootMotionSource.h"
+#include "VIRootMotionSource_Vault.generated.h"
+
+class UAnimMontage;
+
+/**
+ * Moves the character along the vault montage's root motion, warped to reach the sync point
+ *
+ * CharacterMovementComponent predicts, replicates and corrects this inside saved moves
+ * so montage position is no longer part of the movement-critical path
+ *
+ * Only the montage, start, target and warp window are serialized; the trajectory is
+ * rebuilt locally from the montage. The start is captured independently on the client
+ * and server, the server's start is adopted in UpdateStateFrom() so both build the same trajectory
+ */
+USTRUCT()
+struct VAULTIT_API FVIRootMotionSource_Vault : public FRootMotionSource
+{
+	GENERATED_BODY()
+
+	FVIRootMotionSource_Vault();
+
+	virtual ~FVIRootMotionSource_Vault() {}
+
+	/** Montage providing the trajectory */
+	UPROPERTY()
+	UAnimMontage* Montage;
+
+	/** Montage position when the vault started */
+	UPROPERTY()
+	float StartPosition;
+
+	UPROPERTY()
+	float PlayRate;
+
+	/** Actor location when the vault started */
+	UPROPERTY()
+	FVector StartLocation;
+
+	/** Mesh rotation when the vault started, root motion is relative to this */
+	UPROPERTY()
+	FRotator StartRotation;
+
+	/** Actor location to reach by the end of the warp window (sync point at capsule bottom) */
+	UPROPERTY()
+	FVector TargetLocation;
+
+	/**
+	 * Warping window in montage time, filled by AVICharacterBase::ApplyVaultRootMotionSource() which uses
+	 * the remainder of the montage if it has no window for the sync point
+	 * Left at 0 without a sync point, in which case the montage plays unwarped
+	 */
+	UPROPERTY()
+	float WarpStartTime;
+
+	UPROPERTY()
+	float WarpEndTime;
+
+	/** Sample rate used to cache the montage root motion */
+	static constexpr float TrajectorySampleRate = 30.f;
+
+	// ***** Begin FRootMotionSource ***** //
+
+	virtual FRootMotionSource* Clone() const override;
+
+	virtual bool Matches(const FRootMotionSource* Other) const override;
+
+	virtual bool MatchesAndHasSameState(const FRootMotionSource* Other) const override;
+
+	virtual bool UpdateStateFrom(const FRootMotionSource* SourceToTakeStateFrom, bool bMarkForSimulatedCatchup = false) override;
+
+	virtual void PrepareRootMotion(float SimulationTime, float MovementTickTime, const ACharacter& Character, const UCharacterMovementComponent& MoveComponent) override;
+
+	virtual bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess) override;
+
+	virtual UScriptStruct* GetScriptStruct() const override;
+
+	virtual FString ToSimpleString() const override;
+
+	virtual void AddReferencedObjects(class FReferenceCollector& Collector) override;
+
+	// ***** End FRootMotionSource ***** //
+
+	/** @return Warped actor location at Time seconds since the vault started */
+	FVector GetLocationAtTime(float Time);
+
+protected:
+	/** Root motion translation relative to StartPosition, in mesh space at TrajectorySampleRate */
+	TArray<FVector> Trajectory;
+
+	/** Builds Trajectory from the montage if not already built */
+	void CacheTrajectory();
+
+	/** @return Unwarped root motion translation at montage position, in mesh space */
+	FVector GetTrajectoryAtPosition(float Position) const;
+};
+
+template<>
+struct TStructOpsTypeTraits<FVIRootMotionSource_Vault> : public TStructOpsTypeTraitsBase2<FVIRootMotionSource_Vault>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithCopy = true
+	};
+};
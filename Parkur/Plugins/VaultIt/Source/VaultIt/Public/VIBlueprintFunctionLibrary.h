@@ -25,6 +25,15 @@ public:
 	UFUNCTION(BlueprintPure, Category = Vault)
 	static bool VaultAnimSetIsValid(const FVIAnimSet& AnimSet) { return AnimSet.IsValid(); }
 
+	/**
+	 * Deterministically select a vault montage from the anim set
+	 * Heights are walked in order until one exceeds Height, the closer of it and the previous height is used
+	 * and the montage is randomly chosen from its animations using RandomSeed
+	 * Anything that selects a vault montage (abilities, AVICharacterBase::ExecuteVault) should call this so they agree
+	 */
+	UFUNCTION(BlueprintPure, Category = Vault)
+	static UAnimMontage* SelectVaultMontage(const FVIAnimSet& AnimSet, float Height, uint8 RandomSeed);
+
 	UFUNCTION(BlueprintPure, Category = Replication)
 	static bool IsRunningOnServer(AActor* Actor)
 	{
@@ -124,10 +133,7 @@ public:
 	UFUNCTION(BlueprintCallable, Category = FBIK)
 	static void InterpolateFBIK(float DeltaTime, UPARAM(ref) TArray<FVIBoneFBIKData>& Bones)
 	{
-		for (FVIBoneFBIKData& Bone : Bones)
-		{
-			Bone.Update(DeltaTime);
-		}
+		FVIBoneFBIKData::UpdateAll(Bones, DeltaTime);
 	}
 
 	/** Get specific FBIK Bone Data */
@@ -8,6 +8,35 @@
 
 DECLARE_STATS_GROUP(TEXT("VaultIt_Plugin"), STATGROUP_VaultIt, STATCAT_Advanced);
 
+#define VI_WITH_NET_COUNTERS !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+
+#if VI_WITH_NET_COUNTERS
+/**
+ * Totals of the vault network stats, kept alongside the STATGROUP_VaultIt counters so they can be read without stats enabled (eg. by automation tests)
+ * Summed over every world in the process, game thread only
+ * Compiled out of shipping and test builds, increment with INC_VI_NET_COUNTER
+ */
+struct VAULTIT_API FVINetCounters
+{
+	/** Vaults started on the server */
+	int32 VaultsStarted = 0;
+	int32 CorrectionsWhileVaulting = 0;
+	int32 VaultsRolledBack = 0;
+	int32 AntiCheatRejects = 0;
+	int32 VaultRequestsRejected = 0;
+	int32 MontageSnaps = 0;
+	int32 VaultEventsSent = 0;
+
+	static FVINetCounters& Get();
+
+	void Reset() { *this = FVINetCounters(); }
+};
+
+#define INC_VI_NET_COUNTER(Counter) (++FVINetCounters::Get().Counter)
+#else
+#define INC_VI_NET_COUNTER(Counter)
+#endif
+
 /**
  * Used to determine behaviour of jump key in relation to vaulting
  */
@@ -255,6 +284,15 @@ public:
 		bReset = true;
 		TargetLocation = FVector::ZeroVector;
 	}
+
+	/** Calls Update() on each bone */
+	static void UpdateAll(TArrayView<FVIBoneFBIKData> Bones, float DeltaTime)
+	{
+		for (FVIBoneFBIKData& Bone : Bones)
+		{
+			Bone.Update(DeltaTime);
+		}
+	}
 };
 
 /**
@@ -294,6 +332,67 @@ struct TStructOpsTypeTraits<FVIRepMotionMatch> : public TStructOpsTypeTraitsBase
 	};
 };
 
+/**
+ * Single event sent to simulated proxies when a vault starts
+ * Contains everything required to reproduce the vault locally, in place of
+ * bRepIsVaulting, RepMotionMatch and the replicated vault montage
+ * Net quantized to 1 decimal point for bandwidth optimization
+ */
+USTRUCT(BlueprintType)
+struct VAULTIT_API FVIRepVaultEvent
+{
+	GENERATED_BODY()
+
+	FVIRepVaultEvent()
+		: Location(FVector::ZeroVector)
+		, Direction(FVector::ZeroVector)
+		, Montage(nullptr)
+		, PlayRate(1.f)
+		, RandomSeed(0)
+		, ServerTimestamp(0.0)
+		, EventId(0)
+	{}
+
+	/** Sync point location */
+	UPROPERTY(BlueprintReadOnly, Category = Vault)
+	FVector Location;
+
+	/** Sync point direction */
+	UPROPERTY(BlueprintReadOnly, Category = Vault)
+	FVector Direction;
+
+	/** Montage played by GA_Vault */
+	UPROPERTY(BlueprintReadOnly, Category = Vault)
+	UAnimMontage* Montage;
+
+	UPROPERTY(BlueprintReadOnly, Category = Vault)
+	float PlayRate;
+
+	UPROPERTY(BlueprintReadOnly, Category = Vault)
+	uint8 RandomSeed;
+
+	/** Server world time when the montage started, used to catch up on late arrival. Double so it stays precise on long running servers */
+	UPROPERTY(BlueprintReadOnly, Category = Vault)
+	double ServerTimestamp;
+
+	/** Changes every vault so that consecutive identical vaults are still received */
+	UPROPERTY()
+	uint8 EventId;
+
+	bool IsValid() const { return Montage != nullptr; }
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FVIRepVaultEvent> : public TStructOpsTypeTraitsBase2<FVIRepVaultEvent>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
 /**
  * Vault info computed locally then sent to the server for use by GA_Vault
  * Net quantized to 1 decimal point for bandwidth optimization
@@ -335,6 +434,9 @@ struct VAULTIT_API FVIVaultInfo
 	}
 
 	bool IsValid() const { return Height != 0.f; }
+
+	/** Compressed; location and direction to 1 decimal point */
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
 };
 
 /**
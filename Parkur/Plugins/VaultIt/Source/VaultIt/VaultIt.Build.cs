@@ -46,6 +46,12 @@ public class VaultIt : ModuleRules
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
+
+		// Automation tests drive PIE
+		if (Target.bBuildEditor)
+		{
+			PrivateDependencyModuleNames.Add("UnrealEd");
+		}
 		
 		
 		DynamicallyLoadedModuleNames.AddRange(